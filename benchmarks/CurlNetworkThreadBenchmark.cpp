@@ -0,0 +1,599 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Drives CurlNetworkThread against a local HTTP stand-in server, checks the
+// events it delivers and measures how long small responses take to reach the
+// main thread.
+//
+// The server runs in-process on 127.0.0.1 and understands:
+//     GET /bytes/<n>     n bytes of a fixed pattern
+//     GET /chunked/<n>   the same, with chunked transfer encoding
+//     GET /delay/<ms>    2 bytes of the pattern after the given delay
+//     GET /slow/<n>      n bytes of the pattern in 10 pieces, 50ms apart
+//     GET /redirect      a 302 to /bytes/100
+//     POST /echo         the request body
+// Anything else is a 404.
+//
+// Usage: curl_network_thread_benchmark [requests]
+
+#include "config.h"
+#include "CurlNetworkThread.h"
+
+#include "FormData.h"
+#include "FormDataStreamCurl.h"
+#include <algorithm>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+#if OS(WINDOWS)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET SocketHandle;
+#define closeSocket closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int SocketHandle;
+static const SocketHandle INVALID_SOCKET = -1;
+#define closeSocket close
+#endif
+
+using namespace WebCore;
+
+static void sleepMilliseconds(int milliseconds)
+{
+#if OS(WINDOWS)
+    Sleep(milliseconds);
+#else
+    usleep(milliseconds * 1000);
+#endif
+}
+
+static char patternByte(size_t index)
+{
+    return 'a' + index % 26;
+}
+
+static bool sendAll(SocketHandle socket, const char* data, size_t length)
+{
+    while (length) {
+        int sent = send(socket, data, static_cast<int>(length), 0);
+        if (sent <= 0)
+            return false;
+        data += sent;
+        length -= sent;
+    }
+    return true;
+}
+
+static bool sendString(SocketHandle socket, const CString& string)
+{
+    return sendAll(socket, string.data(), string.length());
+}
+
+static CString formatString(const char* format, ...)
+{
+    char buffer[512];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(buffer, sizeof(buffer), format, arguments);
+    va_end(arguments);
+    return CString(buffer);
+}
+
+class StandInServer {
+public:
+    StandInServer()
+        : m_listener(INVALID_SOCKET)
+        , m_port(0)
+        , m_threadID(0)
+        , m_quit(false)
+    {
+    }
+
+    bool start()
+    {
+        m_listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_listener == INVALID_SOCKET)
+            return false;
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t addressLength = sizeof(address);
+        if (bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address))
+            || listen(m_listener, 128)
+            || getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &addressLength))
+            return false;
+
+        m_port = ntohs(address.sin_port);
+        m_threadID = createThread(acceptLoop, this, "Stand-in HTTP server");
+        return m_threadID;
+    }
+
+    void stop()
+    {
+        m_quit = true;
+        // Unblock accept() with a connection that is closed right away.
+        SocketHandle wakeup = connectToSelf();
+        if (wakeup != INVALID_SOCKET)
+            closeSocket(wakeup);
+        void* result;
+        waitForThreadCompletion(m_threadID, &result);
+        closeSocket(m_listener);
+    }
+
+    int port() const { return m_port; }
+
+private:
+    SocketHandle connectToSelf()
+    {
+        SocketHandle client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(m_port);
+        connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        return client;
+    }
+
+    static void* acceptLoop(void* context)
+    {
+        StandInServer* server = static_cast<StandInServer*>(context);
+        while (!server->m_quit) {
+            SocketHandle connection = accept(server->m_listener, 0, 0);
+            if (connection == INVALID_SOCKET)
+                continue;
+            if (server->m_quit) {
+                closeSocket(connection);
+                break;
+            }
+            int noDelay = 1;
+            setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+            detachThread(createThread(serveConnection, reinterpret_cast<void*>(static_cast<intptr_t>(connection)), "Stand-in HTTP connection"));
+        }
+        return 0;
+    }
+
+    // Serves keep-alive requests until the client closes the connection.
+    static void* serveConnection(void* context)
+    {
+        SocketHandle connection = static_cast<SocketHandle>(reinterpret_cast<intptr_t>(context));
+        Vector<char> buffer;
+        while (true) {
+            size_t headerEnd = notFound;
+            while ((headerEnd = findHeaderEnd(buffer)) == notFound) {
+                char chunk[4096];
+                int received = recv(connection, chunk, sizeof(chunk), 0);
+                if (received <= 0) {
+                    closeSocket(connection);
+                    return 0;
+                }
+                buffer.append(chunk, received);
+            }
+
+            CString headers(buffer.data(), headerEnd);
+            size_t contentLength = 0;
+            const char* lengthHeader = strstr(headers.data(), "Content-Length: ");
+            if (lengthHeader)
+                contentLength = strtoul(lengthHeader + strlen("Content-Length: "), 0, 10);
+            while (buffer.size() < headerEnd + contentLength) {
+                char chunk[4096];
+                int received = recv(connection, chunk, sizeof(chunk), 0);
+                if (received <= 0) {
+                    closeSocket(connection);
+                    return 0;
+                }
+                buffer.append(chunk, received);
+            }
+
+            char method[16];
+            char path[256];
+            if (sscanf(headers.data(), "%15s %255s", method, path) != 2 || !respond(connection, method, path, buffer.data() + headerEnd, contentLength)) {
+                closeSocket(connection);
+                return 0;
+            }
+            buffer.remove(0, headerEnd + contentLength);
+        }
+    }
+
+    static size_t findHeaderEnd(const Vector<char>& buffer)
+    {
+        for (size_t i = 3; i < buffer.size(); ++i) {
+            if (buffer[i - 3] == '\r' && buffer[i - 2] == '\n' && buffer[i - 1] == '\r' && buffer[i] == '\n')
+                return i + 1;
+        }
+        return notFound;
+    }
+
+    static bool respond(SocketHandle connection, const char* method, const char* path, const char* body, size_t bodyLength)
+    {
+        if (!strcmp(method, "POST") && !strcmp(path, "/echo")) {
+            return sendString(connection, formatString("HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n", static_cast<unsigned>(bodyLength)))
+                && sendAll(connection, body, bodyLength);
+        }
+        if (strcmp(method, "GET"))
+            return sendString(connection, "HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\n\r\n");
+
+        unsigned value;
+        if (sscanf(path, "/bytes/%u", &value) == 1) {
+            Vector<char> content(value);
+            for (size_t i = 0; i < value; ++i)
+                content[i] = patternByte(i);
+            return sendString(connection, formatString("HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n", value))
+                && sendAll(connection, content.data(), content.size());
+        }
+        if (sscanf(path, "/chunked/%u", &value) == 1) {
+            if (!sendString(connection, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"))
+                return false;
+            for (size_t offset = 0; offset < value; offset += 1000) {
+                size_t length = std::min<size_t>(1000, value - offset);
+                Vector<char> content(length);
+                for (size_t i = 0; i < length; ++i)
+                    content[i] = patternByte(offset + i);
+                if (!sendString(connection, formatString("%x\r\n", static_cast<unsigned>(length)))
+                    || !sendAll(connection, content.data(), length)
+                    || !sendString(connection, "\r\n"))
+                    return false;
+            }
+            return sendString(connection, "0\r\n\r\n");
+        }
+        if (sscanf(path, "/slow/%u", &value) == 1) {
+            if (!sendString(connection, formatString("HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n", value)))
+                return false;
+            for (size_t piece = 0; piece < 10; ++piece) {
+                Vector<char> content;
+                for (size_t i = value * piece / 10; i < value * (piece + 1) / 10; ++i)
+                    content.append(patternByte(i));
+                if (!sendAll(connection, content.data(), content.size()))
+                    return false;
+                sleepMilliseconds(50);
+            }
+            return true;
+        }
+        if (sscanf(path, "/delay/%u", &value) == 1) {
+            sleepMilliseconds(value);
+            return sendString(connection, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nab");
+        }
+        if (!strcmp(path, "/redirect"))
+            return sendString(connection, "HTTP/1.1 302 Found\r\nLocation: /bytes/100\r\nContent-Length: 0\r\n\r\n");
+        return sendString(connection, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+    }
+
+    SocketHandle m_listener;
+    int m_port;
+    ThreadIdentifier m_threadID;
+    volatile bool m_quit;
+};
+
+// What the main thread learned about one transfer.
+struct Transfer {
+    Transfer()
+        : handle(0)
+        , expectedStatus(200)
+        , status(0)
+        , finished(false)
+        , released(false)
+        , eventsAfterRelease(0)
+        , result(CURLE_OK)
+        , startTime(0)
+        , finishTime(0)
+    {
+    }
+
+    CURL* handle;
+    Vector<char> expectedBody;
+    long expectedStatus;
+    long status;
+    Vector<char> body;
+    bool finished;
+    bool released;
+    int eventsAfterRelease;
+    CURLcode result;
+    double startTime;
+    double finishTime;
+};
+
+static ResourceHandle* jobFor(Transfer* transfer)
+{
+    // CurlNetworkThread never dereferences the job; it only hands it back.
+    return reinterpret_cast<ResourceHandle*>(transfer);
+}
+
+static void eventsAvailable(void*)
+{
+}
+
+class Client {
+public:
+    Client(int port)
+        : m_port(port)
+        , m_shareHandle(curl_share_init())
+        , m_thread(m_shareHandle, eventsAvailable, 0)
+    {
+        m_thread.start();
+    }
+
+    ~Client()
+    {
+        m_thread.stop();
+        curl_share_cleanup(m_shareHandle);
+    }
+
+    Transfer* get(const char* path, size_t expectedLength, long expectedStatus = 200)
+    {
+        Transfer* transfer = create(path, expectedStatus);
+        for (size_t i = 0; i < expectedLength; ++i)
+            transfer->expectedBody.append(patternByte(i));
+        add(transfer, PassOwnPtr<FormDataStream>());
+        return transfer;
+    }
+
+    Transfer* post(const Vector<char>& body)
+    {
+        Transfer* transfer = create("/echo", 200);
+        transfer->expectedBody = body;
+        curl_easy_setopt(transfer->handle, CURLOPT_POST, 1L);
+        curl_easy_setopt(transfer->handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
+        add(transfer, adoptPtr(new FormDataStream(FormData::create(body.data(), body.size()))));
+        return transfer;
+    }
+
+    void remove(Transfer* transfer)
+    {
+        m_thread.removeHandle(transfer->handle);
+    }
+
+    void pause(Transfer* transfer, bool pause)
+    {
+        m_thread.pauseHandle(transfer->handle, pause);
+    }
+
+    // Processes events until every transfer has been released.
+    bool waitForAll(double timeout)
+    {
+        double deadline = monotonicallyIncreasingTime() + timeout;
+        while (monotonicallyIncreasingTime() < deadline) {
+            processEvents();
+            bool allReleased = true;
+            for (size_t i = 0; i < m_transfers.size() && allReleased; ++i)
+                allReleased = m_transfers[i]->released;
+            if (allReleased)
+                return true;
+        }
+        return false;
+    }
+
+    // Processes events until the transfer has received part of its body.
+    bool waitForData(Transfer* transfer, double timeout)
+    {
+        double deadline = monotonicallyIncreasingTime() + timeout;
+        while (monotonicallyIncreasingTime() < deadline) {
+            processEvents();
+            if (!transfer->body.isEmpty())
+                return true;
+        }
+        return false;
+    }
+
+    const Vector<OwnPtr<Transfer> >& transfers() const { return m_transfers; }
+
+    void clear() { m_transfers.clear(); }
+
+private:
+    void processEvents()
+    {
+#if OS(WINDOWS)
+        MSG message;
+        while (PeekMessage(&message, 0, 0, 0, PM_REMOVE))
+            DispatchMessage(&message);
+#endif
+        Vector<CurlNetworkEvent> events;
+        m_thread.takeEvents(events);
+        for (size_t i = 0; i < events.size(); ++i)
+            handleEvent(events[i]);
+        if (events.isEmpty())
+            sleepMilliseconds(0);
+    }
+
+    Transfer* create(const char* path, long expectedStatus)
+    {
+        m_transfers.append(adoptPtr(new Transfer));
+        Transfer* transfer = m_transfers.last().get();
+        transfer->expectedStatus = expectedStatus;
+        transfer->handle = curl_easy_init();
+        CString url = formatString("http://127.0.0.1:%d%s", m_port, path);
+        curl_easy_setopt(transfer->handle, CURLOPT_URL, url.data());
+        curl_easy_setopt(transfer->handle, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(transfer->handle, CURLOPT_SHARE, m_shareHandle);
+        return transfer;
+    }
+
+    void add(Transfer* transfer, PassOwnPtr<FormDataStream> uploadStream)
+    {
+        transfer->startTime = monotonicallyIncreasingTime();
+        m_thread.addHandle(transfer->handle, jobFor(transfer), uploadStream);
+    }
+
+    void handleEvent(const CurlNetworkEvent& event)
+    {
+        Transfer* transfer = reinterpret_cast<Transfer*>(event.job);
+        if (transfer->released) {
+            ++transfer->eventsAfterRelease;
+            return;
+        }
+        switch (event.type) {
+        case CurlNetworkEvent::HeaderLine:
+            if (event.info.httpCode)
+                transfer->status = event.info.httpCode;
+            break;
+        case CurlNetworkEvent::Data:
+            transfer->body.append(event.data.data(), event.data.size());
+            break;
+        case CurlNetworkEvent::Finished:
+            transfer->finished = true;
+            transfer->result = event.result;
+            transfer->finishTime = monotonicallyIncreasingTime();
+            break;
+        case CurlNetworkEvent::Released:
+            transfer->released = true;
+            // The easy handle belongs to the main thread again.
+            curl_easy_cleanup(transfer->handle);
+            transfer->handle = 0;
+            break;
+        }
+    }
+
+    int m_port;
+    CURLSH* m_shareHandle;
+    CurlNetworkThread m_thread;
+    Vector<OwnPtr<Transfer> > m_transfers;
+};
+
+static int failures = 0;
+
+static void check(bool condition, const char* description, size_t index)
+{
+    if (condition)
+        return;
+    printf("FAIL: %s (transfer %u)\n", description, static_cast<unsigned>(index));
+    ++failures;
+}
+
+static void checkCompleted(Client& client, const char* name)
+{
+    const Vector<OwnPtr<Transfer> >& transfers = client.transfers();
+    for (size_t i = 0; i < transfers.size(); ++i) {
+        Transfer* transfer = transfers[i].get();
+        check(transfer->released, "transfer was never released", i);
+        check(transfer->finished, "transfer did not finish", i);
+        check(transfer->result == CURLE_OK, "transfer failed", i);
+        check(transfer->status == transfer->expectedStatus, "unexpected HTTP status", i);
+        check(transfer->body == transfer->expectedBody, "unexpected body", i);
+        check(!transfer->eventsAfterRelease, "events arrived after Released", i);
+    }
+    printf("%-28s %5u transfers %s\n", name, static_cast<unsigned>(transfers.size()), failures ? "" : "ok");
+}
+
+int main(int argc, char** argv)
+{
+    int requests = argc > 1 ? atoi(argv[1]) : 200;
+    if (requests < 1)
+        requests = 1;
+
+#if OS(WINDOWS)
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+    curl_global_init(CURL_GLOBAL_ALL);
+    WTF::initializeThreading();
+    WTF::initializeMainThread();
+
+    StandInServer server;
+    if (!server.start()) {
+        printf("Could not start the stand-in server\n");
+        return 1;
+    }
+
+    {
+        Client client(server.port());
+
+        // Many concurrent responses of every size, including some that need
+        // several wake-ups of the network thread.
+        for (int i = 0; i < requests; ++i)
+            client.get(formatString("/bytes/%d", i * 997 % 300000).data(), i * 997 % 300000);
+        for (int i = 0; i < 10; ++i)
+            client.get(formatString("/chunked/%d", i * 12345).data(), i * 12345);
+        client.get("/redirect", 100);
+        client.get("/missing", 0, 404);
+        check(client.waitForAll(60), "timed out", 0);
+        checkCompleted(client, "GET");
+        client.clear();
+
+        // Uploads are read on the network thread from a private copy of the body.
+        for (int i = 0; i < 20; ++i) {
+            Vector<char> body;
+            for (int j = 0; j < i * 7919; ++j)
+                body.append(patternByte(j * 7));
+            client.post(body);
+        }
+        check(client.waitForAll(60), "timed out", 0);
+        checkCompleted(client, "POST");
+        client.clear();
+
+        // A removed transfer is released without finishing.
+        Transfer* removed = client.get("/delay/2000", 2);
+        sleepMilliseconds(100);
+        client.remove(removed);
+        check(client.waitForAll(10), "timed out", 0);
+        check(removed->released && !removed->finished, "removed transfer finished", 0);
+        printf("%-28s %5u transfers %s\n", "remove", 1u, failures ? "" : "ok");
+        client.clear();
+
+        // A paused transfer delivers nothing until it is resumed.
+        Transfer* paused = client.get("/slow/10000", 10000);
+        check(client.waitForData(paused, 10), "timed out", 0);
+        client.pause(paused, true);
+        // Let a chunk that was already in flight arrive.
+        client.waitForAll(0.05);
+        size_t receivedBeforePause = paused->body.size();
+        client.waitForAll(0.5);
+        check(!paused->finished && paused->body.size() == receivedBeforePause, "paused transfer received data", 0);
+        client.pause(paused, false);
+        check(client.waitForAll(10), "timed out", 0);
+        checkCompleted(client, "pause");
+        client.clear();
+
+        // Latency of small responses, which the poll timer used to round up to
+        // its 10ms period.
+        Vector<double> latencies;
+        for (int i = 0; i < 100; ++i) {
+            Transfer* transfer = client.get("/bytes/10", 10);
+            client.waitForAll(10);
+            latencies.append((transfer->finishTime - transfer->startTime) * 1000);
+        }
+        checkCompleted(client, "sequential GET");
+        std::sort(latencies.begin(), latencies.end());
+        printf("\nsmall response latency: median %.3f ms, 90th percentile %.3f ms\n", latencies[latencies.size() / 2], latencies[latencies.size() * 9 / 10]);
+    }
+
+    server.stop();
+    curl_global_cleanup();
+    return failures ? 1 : 0;
+}
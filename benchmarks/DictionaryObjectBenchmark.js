@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Property access on objects that have had properties deleted, which turns
+// them into dictionaries, meant to be run with the jsc shell:
+//
+//     jsc -c DictionaryObjectBenchmark.js [-- iterations]
+//
+// The -c option prints how many property accesses missed the inline caches,
+// which is where these workloads used to spend their time.
+
+var iterations = (typeof arguments != "undefined" && arguments.length) ? parseInt(arguments[0]) : 10;
+
+// Many objects that drop a temporary property while being set up, as legacy
+// widget and model constructors tend to do.
+function Model(id) {
+    this.id = id;
+    this.pending = true;
+    this.name = "model" + id;
+    this.value = id * 3;
+    this.dirty = false;
+    delete this.pending;
+}
+
+function makeModels(count) {
+    var models = [];
+    for (var i = 0; i < count; ++i)
+        models.push(new Model(i));
+    return models;
+}
+
+function touchModels(models) {
+    var sum = 0;
+    for (var i = 0; i < models.length; ++i) {
+        var model = models[i];
+        model.value = model.value + 1;
+        model.dirty = !model.dirty;
+        sum += model.id + model.value + model.name.length;
+    }
+    return sum;
+}
+
+// A single options object that had defaults removed, then read in a loop.
+var options = { width: 640, height: 480, debug: true, scale: 2, margin: 8 };
+delete options.debug;
+
+function readOptions(count) {
+    var sum = 0;
+    for (var i = 0; i < count; ++i)
+        sum += options.width * options.scale + options.height + options.margin;
+    return sum;
+}
+
+// An object used as a hash map, with keys constantly added and removed. This
+// is expected to stay a dictionary; it is here to make sure it does not get
+// slower.
+function churnMap(count) {
+    var map = {};
+    var hits = 0;
+    for (var i = 0; i < count; ++i) {
+        map["key" + (i % 101)] = i;
+        if (i % 3 == 0)
+            delete map["key" + ((i * 7) % 101)];
+        if (map.key5 !== undefined)
+            hits++;
+    }
+    return hits;
+}
+
+function time(callback) {
+    var start = Date.now();
+    for (var i = 0; i < iterations; ++i)
+        callback();
+    return ((Date.now() - start) / iterations).toFixed(2);
+}
+
+var models = makeModels(10000);
+var expected = 0;
+for (var i = 0; i < models.length; ++i)
+    expected += i + (i * 3 + 1) + ("model" + i).length;
+if (touchModels(models) !== expected)
+    throw "FAIL: models returned the wrong sum";
+if (readOptions(10) !== 10 * (640 * 2 + 480 + 8))
+    throw "FAIL: options returned the wrong sum";
+
+print("models: " + time(function() { for (var i = 0; i < 20; ++i) touchModels(models); }) + " ms");
+print("options: " + time(function() { readOptions(1000000); }) + " ms");
+print("hash map: " + time(function() { churnMap(200000); }) + " ms");
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Applies every software filter effect to images of several sizes and reports
+// the time per application. Effects whose images are large enough are split
+// into ParallelJobs; build with ENABLE_PARALLEL_JOBS=0 for a serial baseline.
+//
+// Usage: filter_effects_benchmark [iterations]
+
+#include "config.h"
+
+#include "DistantLightSource.h"
+#include "FEBlend.h"
+#include "FEColorMatrix.h"
+#include "FEComponentTransfer.h"
+#include "FEComposite.h"
+#include "FEConvolveMatrix.h"
+#include "FEDiffuseLighting.h"
+#include "FEDisplacementMap.h"
+#include "FEGaussianBlur.h"
+#include "FEMorphology.h"
+#include "FETurbulence.h"
+#include "Filter.h"
+#include "ImageBuffer.h"
+#include "SourceGraphic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <wtf/ByteArray.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MainThread.h>
+#include <wtf/NumberOfCores.h>
+#include <wtf/Threading.h>
+
+using namespace WebCore;
+
+class BenchmarkFilter : public Filter {
+public:
+    static PassRefPtr<BenchmarkFilter> create(const IntSize& size)
+    {
+        return adoptRef(new BenchmarkFilter(size));
+    }
+
+    virtual FloatRect sourceImageRect() const { return m_rect; }
+    virtual FloatRect filterRegion() const { return m_rect; }
+    virtual bool effectBoundingBoxMode() const { return false; }
+
+private:
+    BenchmarkFilter(const IntSize& size)
+        : m_rect(FloatPoint(), size)
+    {
+        setFilterResolution(FloatSize(1, 1));
+    }
+
+    FloatRect m_rect;
+};
+
+static PassOwnPtr<ImageBuffer> createSourceImage(const IntSize& size)
+{
+    OwnPtr<ImageBuffer> image = ImageBuffer::create(size);
+    if (!image)
+        return nullptr;
+
+    RefPtr<ByteArray> pixels = ByteArray::create(size.width() * size.height() * 4);
+    unsigned char* pixel = pixels->data();
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x) {
+            *pixel++ = x * 255 / size.width();
+            *pixel++ = y * 255 / size.height();
+            *pixel++ = (x ^ y) & 0xff;
+            *pixel++ = 128 + ((x + y) & 0x7f);
+        }
+    }
+    IntRect rect(IntPoint(), size);
+    image->putUnmultipliedImageData(pixels.get(), size, rect, IntPoint());
+    return image.release();
+}
+
+static Vector<float> hueRotateValues()
+{
+    Vector<float> values;
+    values.append(45);
+    return values;
+}
+
+static Vector<float> sepiaMatrixValues()
+{
+    static const float sepia[] = {
+        0.393f, 0.769f, 0.189f, 0, 0,
+        0.349f, 0.686f, 0.168f, 0, 0,
+        0.272f, 0.534f, 0.131f, 0, 0,
+        0, 0, 0, 1, 0
+    };
+    Vector<float> values;
+    values.append(sepia, WTF_ARRAY_LENGTH(sepia));
+    return values;
+}
+
+static Vector<float> sharpenKernel()
+{
+    static const float kernel[] = {
+        0, -1, 0,
+        -1, 5, -1,
+        0, -1, 0
+    };
+    Vector<float> values;
+    values.append(kernel, WTF_ARRAY_LENGTH(kernel));
+    return values;
+}
+
+static ComponentTransferFunction gammaFunction()
+{
+    ComponentTransferFunction function;
+    function.type = FECOMPONENTTRANSFER_TYPE_GAMMA;
+    function.amplitude = 1.2f;
+    function.exponent = 0.8f;
+    function.offset = 0.05f;
+    return function;
+}
+
+static PassRefPtr<FilterEffect> colorMatrix(Filter* filter)
+{
+    return FEColorMatrix::create(filter, FECOLORMATRIX_TYPE_MATRIX, sepiaMatrixValues());
+}
+
+static PassRefPtr<FilterEffect> hueRotate(Filter* filter)
+{
+    return FEColorMatrix::create(filter, FECOLORMATRIX_TYPE_HUEROTATE, hueRotateValues());
+}
+
+static PassRefPtr<FilterEffect> componentTransfer(Filter* filter)
+{
+    ComponentTransferFunction function = gammaFunction();
+    return FEComponentTransfer::create(filter, function, function, function, ComponentTransferFunction());
+}
+
+static PassRefPtr<FilterEffect> compositeArithmetic(Filter* filter)
+{
+    return FEComposite::create(filter, FECOMPOSITE_OPERATOR_ARITHMETIC, 0.5f, 0.5f, 0.25f, 0.1f);
+}
+
+static PassRefPtr<FilterEffect> blendMultiply(Filter* filter)
+{
+    return FEBlend::create(filter, FEBLEND_MODE_MULTIPLY);
+}
+
+static PassRefPtr<FilterEffect> displacementMap(Filter* filter)
+{
+    return FEDisplacementMap::create(filter, CHANNEL_R, CHANNEL_G, 20);
+}
+
+static PassRefPtr<FilterEffect> convolveMatrix(Filter* filter)
+{
+    return FEConvolveMatrix::create(filter, IntSize(3, 3), 1, 0, IntPoint(1, 1), EDGEMODE_DUPLICATE, FloatPoint(), false, sharpenKernel());
+}
+
+static PassRefPtr<FilterEffect> gaussianBlur(Filter* filter)
+{
+    return FEGaussianBlur::create(filter, 8, 8);
+}
+
+static PassRefPtr<FilterEffect> morphology(Filter* filter)
+{
+    return FEMorphology::create(filter, FEMORPHOLOGY_OPERATOR_DILATE, 3, 3);
+}
+
+static PassRefPtr<FilterEffect> turbulence(Filter* filter)
+{
+    return FETurbulence::create(filter, FETURBULENCE_TYPE_TURBULENCE, 0.05f, 0.05f, 2, 0, false);
+}
+
+static PassRefPtr<FilterEffect> diffuseLighting(Filter* filter)
+{
+    return FEDiffuseLighting::create(filter, Color::white, 2, 1, 1, 1, DistantLightSource::create(45, 45));
+}
+
+struct Benchmark {
+    const char* name;
+    PassRefPtr<FilterEffect> (*create)(Filter*);
+    unsigned numberOfInputs;
+};
+
+static const Benchmark benchmarks[] = {
+    { "feColorMatrix matrix", colorMatrix, 1 },
+    { "feColorMatrix hueRotate", hueRotate, 1 },
+    { "feComponentTransfer gamma", componentTransfer, 1 },
+    { "feComposite arithmetic", compositeArithmetic, 2 },
+    { "feBlend multiply", blendMultiply, 2 },
+    { "feDisplacementMap", displacementMap, 2 },
+    { "feConvolveMatrix 3x3", convolveMatrix, 1 },
+    { "feGaussianBlur 8px", gaussianBlur, 1 },
+    { "feMorphology dilate 3px", morphology, 1 },
+    { "feTurbulence", turbulence, 0 },
+    { "feDiffuseLighting", diffuseLighting, 1 }
+};
+
+static const int imageSizes[] = { 128, 512, 1024, 2048 };
+
+static double timeEffect(const Benchmark& benchmark, int imageSize, int iterations)
+{
+    IntSize size(imageSize, imageSize);
+    RefPtr<BenchmarkFilter> filter = BenchmarkFilter::create(size);
+    filter->setSourceImage(createSourceImage(size));
+    if (!filter->sourceImage())
+        return -1;
+
+    FloatRect effectRect(FloatPoint(), size);
+    RefPtr<FilterEffect> source = SourceGraphic::create(filter.get());
+    source->setMaxEffectRect(effectRect);
+
+    RefPtr<FilterEffect> effect = benchmark.create(filter.get());
+    effect->setMaxEffectRect(effectRect);
+    for (unsigned i = 0; i < benchmark.numberOfInputs; ++i)
+        effect->inputEffects().append(source);
+
+    // The first application also renders the source graphic.
+    effect->apply();
+
+    double start = monotonicallyIncreasingTime();
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        effect->clearResult();
+        effect->apply();
+    }
+    return (monotonicallyIncreasingTime() - start) * 1000 / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations < 1)
+        iterations = 1;
+
+    WTF::initializeThreading();
+    WTF::initializeMainThread();
+
+#if ENABLE(PARALLEL_JOBS)
+    printf("parallel jobs on %d cores, %d iterations\n\n", WTF::numberOfProcessorCores(), iterations);
+#else
+    printf("parallel jobs disabled, %d iterations\n\n", iterations);
+#endif
+
+    printf("%-28s", "");
+    for (size_t j = 0; j < WTF_ARRAY_LENGTH(imageSizes); ++j)
+        printf("  %4dx%-4d", imageSizes[j], imageSizes[j]);
+    printf("\n");
+
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarks); ++i) {
+        printf("%-28s", benchmarks[i].name);
+        for (size_t j = 0; j < WTF_ARRAY_LENGTH(imageSizes); ++j) {
+            double time = timeEffect(benchmarks[i], imageSizes[j], iterations);
+            if (time < 0)
+                printf("  %9s", "n/a");
+            else
+                printf("  %6.2f ms", time);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
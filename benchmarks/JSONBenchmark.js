@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// JSON.parse and JSON.stringify workloads modelled on the payloads our views
+// receive from the backend and the state snapshots they send back, meant to
+// be run with the jsc shell:
+//
+//     jsc JSONBenchmark.js [-- iterations]
+//
+// Every payload is checked to survive a parse/stringify round trip unchanged
+// before it is timed, so a change to either direction that alters the output
+// makes the script throw.
+
+var iterations = (typeof arguments != "undefined" && arguments.length) ? parseInt(arguments[0]) : 10;
+
+var seed = 49734321;
+function random(range) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    return seed % range;
+}
+
+// Many objects of the same shape, as returned by list and table endpoints.
+function makeRecords(count) {
+    var records = [];
+    for (var i = 0; i < count; ++i) {
+        records.push({
+            id: i,
+            name: "item" + i,
+            category: ["books", "music", "video", "games"][random(4)],
+            price: random(100000) / 100,
+            inStock: !!random(2),
+            tags: ["new", "sale", "featured"].slice(random(3)),
+            owner: { first: "First" + random(100), last: "Last" + random(100), age: random(90) }
+        });
+    }
+    return records;
+}
+
+// A deep tree with keys that differ from node to node, as in configuration
+// and layout documents.
+function makeTree(depth, fanout) {
+    var node = { kind: "node" + depth, weight: random(1000) / 7 };
+    if (depth) {
+        var children = {};
+        for (var i = 0; i < fanout; ++i)
+            children["child" + depth + "_" + i] = makeTree(depth - 1, fanout);
+        node.children = children;
+    }
+    return node;
+}
+
+// Free text that needs escaping, as in message and comment feeds.
+function makeMessages(count) {
+    var words = ["hello", "world", "\"quoted\"", "tab\there", "line\nbreak", "back\\slash", "café", "日本", "\u0001"];
+    var messages = [];
+    for (var i = 0; i < count; ++i) {
+        var text = [];
+        for (var j = random(40) + 5; j; --j)
+            text.push(words[random(words.length)]);
+        messages.push({ from: "user" + random(500), body: text.join(" ") });
+    }
+    return messages;
+}
+
+// Long numeric series, as in chart data.
+function makeSeries(count) {
+    var series = { timestamps: [], values: [], counts: [] };
+    for (var i = 0; i < count; ++i) {
+        series.timestamps.push(1300000000000 + i * 60000);
+        series.values.push(random(1000000) / 1000 - 500);
+        series.counts.push(random(1000));
+    }
+    return series;
+}
+
+var payloads = [
+    { name: "records", value: makeRecords(20000) },
+    { name: "tree", value: makeTree(6, 6) },
+    { name: "messages", value: makeMessages(20000) },
+    { name: "series", value: makeSeries(100000) }
+];
+
+function time(callback) {
+    var start = Date.now();
+    for (var i = 0; i < iterations; ++i)
+        callback();
+    return ((Date.now() - start) / iterations).toFixed(2);
+}
+
+for (var i = 0; i < payloads.length; ++i) {
+    var payload = payloads[i];
+    var text = JSON.stringify(payload.value);
+    if (JSON.stringify(JSON.parse(text)) !== text)
+        throw "FAIL: " + payload.name + " changed in a parse/stringify round trip";
+    var indented = JSON.stringify(payload.value, null, 2);
+    if (JSON.stringify(JSON.parse(indented), null, 2) !== indented)
+        throw "FAIL: " + payload.name + " changed in an indented round trip";
+
+    var parseTime = time(function() { JSON.parse(text); });
+    var stringifyTime = time(function() { JSON.stringify(payload.value); });
+    print(payload.name + " (" + (text.length / 1024).toFixed(0) + " KB): parse " + parseTime + " ms, stringify " + stringifyTime + " ms");
+}
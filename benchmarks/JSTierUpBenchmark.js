@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Compute-heavy workloads modelled on the charting and diffing scripts our
+// clients run, meant to be run with the jsc shell:
+//
+//     jsc JSTierUpBenchmark.js [-- iterations]
+//
+// Every workload is first run a few times to record its result while the
+// code is still in the baseline JIT, then timed once the DFG has had a chance
+// to tier it up. A result that changes after tier-up, or any of the OSR exit
+// checks at the end failing, makes the script throw.
+
+var iterations = (typeof arguments != "undefined" && arguments.length) ? parseInt(arguments[0]) : 20;
+
+// Charting: generate a series, downsample it for display with the
+// largest-triangle-three-buckets algorithm and compute axis ticks and the
+// pixel coordinates of the resulting polyline.
+function makeSeries(count, seed) {
+    var xs = new Array(count);
+    var ys = new Array(count);
+    var value = 0;
+    for (var i = 0; i < count; ++i) {
+        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+        value += (seed % 2001 - 1000) / 100;
+        xs[i] = i * 0.5;
+        ys[i] = value + Math.sin(i / 40) * 25;
+    }
+    return { xs: xs, ys: ys };
+}
+
+function downsample(series, threshold) {
+    var xs = series.xs;
+    var ys = series.ys;
+    var length = xs.length;
+    var sampledX = [xs[0]];
+    var sampledY = [ys[0]];
+    var bucketSize = (length - 2) / (threshold - 2);
+    var a = 0;
+    for (var i = 0; i < threshold - 2; ++i) {
+        var nextStart = Math.floor((i + 1) * bucketSize) + 1;
+        var nextEnd = Math.min(Math.floor((i + 2) * bucketSize) + 1, length);
+        var averageX = 0;
+        var averageY = 0;
+        for (var j = nextStart; j < nextEnd; ++j) {
+            averageX += xs[j];
+            averageY += ys[j];
+        }
+        averageX /= nextEnd - nextStart;
+        averageY /= nextEnd - nextStart;
+
+        var start = Math.floor(i * bucketSize) + 1;
+        var end = Math.floor((i + 1) * bucketSize) + 1;
+        var maxArea = -1;
+        var chosen = start;
+        for (var j = start; j < end; ++j) {
+            var area = Math.abs((xs[a] - averageX) * (ys[j] - ys[a]) - (xs[a] - xs[j]) * (averageY - ys[a]));
+            if (area > maxArea) {
+                maxArea = area;
+                chosen = j;
+            }
+        }
+        sampledX.push(xs[chosen]);
+        sampledY.push(ys[chosen]);
+        a = chosen;
+    }
+    sampledX.push(xs[length - 1]);
+    sampledY.push(ys[length - 1]);
+    return { xs: sampledX, ys: sampledY };
+}
+
+function niceTicks(min, max, count) {
+    var span = max - min;
+    var step = Math.pow(10, Math.floor(Math.log(span / count) / Math.LN10));
+    var error = count / span * step;
+    if (error <= 0.15)
+        step *= 10;
+    else if (error <= 0.35)
+        step *= 5;
+    else if (error <= 0.75)
+        step *= 2;
+    var ticks = [];
+    for (var tick = Math.ceil(min / step) * step; tick <= max; tick += step)
+        ticks.push(Math.round(tick / step) * step);
+    return ticks;
+}
+
+function chart() {
+    var checksum = 0;
+    for (var s = 0; s < 4; ++s) {
+        var sampled = downsample(makeSeries(20000, s + 1), 800);
+        var minY = Infinity;
+        var maxY = -Infinity;
+        for (var i = 0; i < sampled.ys.length; ++i) {
+            minY = Math.min(minY, sampled.ys[i]);
+            maxY = Math.max(maxY, sampled.ys[i]);
+        }
+        var ticks = niceTicks(minY, maxY, 8);
+        var scaleX = 1200 / sampled.xs[sampled.xs.length - 1];
+        var scaleY = 400 / (maxY - minY);
+        var path = [];
+        for (var i = 0; i < sampled.xs.length; ++i)
+            path.push(((sampled.xs[i] * scaleX) | 0) + "," + (((maxY - sampled.ys[i]) * scaleY) | 0));
+        var points = path.join(" ");
+        for (var i = 0; i < points.length; ++i)
+            checksum = (checksum * 31 + points.charCodeAt(i)) | 0;
+        checksum = (checksum + ticks.length) | 0;
+    }
+    return checksum;
+}
+
+// Diffing: a line based Myers diff between two versions of a generated
+// document, producing an edit script.
+function makeDocument(lines, seed, edits) {
+    var document = [];
+    for (var i = 0; i < lines; ++i)
+        document.push("line " + (i * 7919 % 1000) + " of section " + (i >> 5));
+    for (var i = 0; i < edits; ++i) {
+        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+        var position = seed % document.length;
+        if (seed & 1)
+            document.splice(position, 1);
+        else
+            document.splice(position, 0, "inserted " + i);
+    }
+    return document;
+}
+
+function myersDiff(a, b) {
+    var n = a.length;
+    var m = b.length;
+    var max = n + m;
+    var offset = max + 1;
+    var v = new Array(2 * max + 3);
+    for (var i = 0; i < v.length; ++i)
+        v[i] = 0;
+    var trace = [];
+    for (var d = 0; d <= max; ++d) {
+        trace.push(v.slice(offset - d - 1, offset + d + 2));
+        for (var k = -d; k <= d; k += 2) {
+            var x;
+            if (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]))
+                x = v[offset + k + 1];
+            else
+                x = v[offset + k - 1] + 1;
+            var y = x - k;
+            while (x < n && y < m && a[x] === b[y]) {
+                ++x;
+                ++y;
+            }
+            v[offset + k] = x;
+            if (x >= n && y >= m)
+                return backtrack(trace, a, b);
+        }
+    }
+    return [];
+}
+
+function backtrack(trace, a, b) {
+    var script = [];
+    var x = a.length;
+    var y = b.length;
+    for (var d = trace.length - 1; d > 0; --d) {
+        var v = trace[d];
+        var base = d + 1;
+        var k = x - y;
+        var previousK;
+        if (k == -d || (k != d && v[base + k - 1] < v[base + k + 1]))
+            previousK = k + 1;
+        else
+            previousK = k - 1;
+        var previousX = v[base + previousK];
+        var previousY = previousX - previousK;
+        while (x > previousX && y > previousY) {
+            --x;
+            --y;
+        }
+        if (x == previousX)
+            script.push("+" + b[--y]);
+        else
+            script.push("-" + a[--x]);
+    }
+    return script.reverse();
+}
+
+function diff() {
+    var original = makeDocument(3000, 1, 0);
+    var checksum = 0;
+    for (var r = 0; r < 3; ++r) {
+        var script = myersDiff(original, makeDocument(3000, 1, 40 + r * 20));
+        checksum = (checksum * 31 + script.length) | 0;
+        for (var i = 0; i < script.length; ++i)
+            checksum = (checksum * 31 + script[i].length + script[i].charCodeAt(0)) | 0;
+    }
+    return checksum;
+}
+
+// Integer and floating point arithmetic in the shapes the speculative JIT
+// specializes: int32 loops, doubles, and array indexing.
+function numeric() {
+    var primes = [];
+    var sieve = new Array(200000);
+    for (var i = 0; i < sieve.length; ++i)
+        sieve[i] = true;
+    for (var i = 2; i < sieve.length; ++i) {
+        if (!sieve[i])
+            continue;
+        primes.push(i);
+        for (var j = i * 2; j < sieve.length; j += i)
+            sieve[j] = false;
+    }
+    var sum = 0;
+    for (var i = 0; i < primes.length; ++i)
+        sum = (sum + primes[i] % 97 * (i & 15)) | 0;
+    var x = 0.5;
+    for (var i = 0; i < 200000; ++i)
+        x = 3.9 * x * (1 - x);
+    return sum + ((x * 1000000) | 0);
+}
+
+var workloads = [
+    { name: "chart", run: chart },
+    { name: "diff", run: diff },
+    { name: "numeric", run: numeric }
+];
+
+for (var w = 0; w < workloads.length; ++w) {
+    var workload = workloads[w];
+    var expected = workload.run();
+    var start = Date.now();
+    for (var i = 0; i < iterations; ++i) {
+        var result = workload.run();
+        if (result !== expected)
+            throw "FAIL: " + workload.name + " returned " + result + " after tier-up, expected " + expected;
+    }
+    print(workload.name + ": " + ((Date.now() - start) / iterations).toFixed(2) + " ms");
+}
+
+// Values that make speculative integer code exit to the baseline JIT.
+function check(actual, expected, description) {
+    var same = expected !== expected ? actual !== actual : actual === expected && (actual !== 0 || 1 / actual === 1 / expected);
+    if (!same)
+        throw "FAIL: " + description + " is " + actual + ", expected " + expected;
+}
+
+function add(a, b) { return a + b; }
+function mul(a, b) { return a * b; }
+function div(a, b) { return a / b; }
+function mod(a, b) { return a % b; }
+function negate(a) { return -a; }
+function getX(o) { return o.x; }
+function sumArray(a) { var s = 0; for (var i = 0; i < a.length; ++i) s += a[i]; return s; }
+
+for (var i = 1; i < 100000; ++i) {
+    add(i, 1);
+    mul(i & 1023, 3);
+    div(i * 4, 2);
+    mod(i, 7);
+    negate(i);
+    getX({ x: i });
+}
+var smallIntegers = [];
+for (var i = 0; i < 1000; ++i)
+    smallIntegers.push(i);
+for (var i = 0; i < 200; ++i)
+    sumArray(smallIntegers);
+
+check(add(2147483647, 1), 2147483648, "int32 overflow in add");
+check(add("a", 1), "a1", "string add");
+check(mul(65536, 65536), 4294967296, "int32 overflow in mul");
+check(mul(-1, 0), -0, "negative zero from mul");
+check(div(7, 2), 3.5, "fractional div");
+check(div(0, -1), -0, "negative zero from div");
+check(div(-2147483648, -1), 2147483648, "INT_MIN / -1");
+check(div(1, 0), Infinity, "division by zero");
+check(mod(-5, 5), -0, "negative zero from mod");
+check(mod(-2147483648, -1), -0, "INT_MIN % -1");
+check(mod(5.5, 2), 1.5, "double mod");
+check(mod(1, 0), NaN, "mod by zero");
+check(negate(0), -0, "negative zero from negate");
+check(negate(-2147483648), 2147483648, "negating INT_MIN");
+check(getX({ y: 1, x: 5 }), 5, "polymorphic get_by_id");
+check(getX("string"), undefined, "get_by_id on a string");
+smallIntegers.push(0.5);
+check(sumArray(smallIntegers), 499500.5, "double in an int32 array");
+smallIntegers.push("!");
+check(sumArray(smallIntegers), "499500.5!", "string in an int32 array");
+print("OSR exit checks passed");
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Times the pixel kernels used by FEGaussianBlur, ShadowBlur and the cairo
+// ImageBuffer against the portable code, and checks that every SIMD variant
+// produces the same bytes.
+//
+// Usage: pixel_kernels_benchmark [iterations]
+
+#include "config.h"
+#include "PixelKernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/Vector.h>
+
+using namespace WebCore;
+
+static const int imageWidth = 1023;
+static const int imageHeight = 767;
+static const int pixelCount = imageWidth * imageHeight;
+static const int rowBytes = imageWidth * 4;
+
+struct Images {
+    Vector<unsigned> premultiplied;
+    Vector<unsigned char> unmultiplied;
+    Vector<unsigned char> source;
+    Vector<unsigned char> destination;
+};
+
+static void fillImages(Images& images)
+{
+    images.premultiplied.resize(pixelCount);
+    images.unmultiplied.resize(pixelCount * 4);
+    images.destination.resize(pixelCount * 4);
+
+    srand(1);
+    for (int i = 0; i < pixelCount; ++i) {
+        unsigned alpha = rand() & 0xFF;
+        // Mostly valid premultiplied colors, with a few that exceed their alpha.
+        unsigned limit = (i % 97) ? alpha : 0xFF;
+        unsigned red = limit ? rand() % (limit + 1) : 0;
+        unsigned green = limit ? rand() % (limit + 1) : 0;
+        unsigned blue = limit ? rand() % (limit + 1) : 0;
+        images.premultiplied[i] = alpha << 24 | red << 16 | green << 8 | blue;
+    }
+    for (int i = 0; i < pixelCount * 4; ++i)
+        images.unmultiplied[i] = rand() & 0xFF;
+    images.source = images.unmultiplied;
+}
+
+// Each benchmark writes its result to images.destination.
+typedef void (*BenchmarkFunction)(const PixelKernels&, Images&);
+
+static void gaussianBlur(const PixelKernels& kernels, Images& images, unsigned kernelSize, bool alphaImage)
+{
+    Vector<unsigned char> source = images.source;
+    Vector<unsigned char>& temporary = images.destination;
+    int distanceLeft = (kernelSize - 1) / 2;
+    int distanceRight = kernelSize - distanceLeft;
+    for (int pass = 0; pass < 3; ++pass) {
+        kernels.boxBlur(source.data(), temporary.data(), kernelSize, distanceLeft, distanceRight, 4, rowBytes, imageWidth, imageHeight, alphaImage);
+        kernels.boxBlur(temporary.data(), source.data(), kernelSize, distanceLeft, distanceRight, rowBytes, 4, imageHeight, imageWidth, alphaImage);
+    }
+    images.destination = source;
+}
+
+static void gaussianBlurSmall(const PixelKernels& kernels, Images& images)
+{
+    gaussianBlur(kernels, images, 5, false);
+}
+
+static void gaussianBlurLarge(const PixelKernels& kernels, Images& images)
+{
+    gaussianBlur(kernels, images, 40, false);
+}
+
+// Beyond the kernel size the SIMD reciprocal is exact for.
+static void gaussianBlurHuge(const PixelKernels& kernels, Images& images)
+{
+    gaussianBlur(kernels, images, 4000, false);
+}
+
+static void gaussianBlurAlpha(const PixelKernels& kernels, Images& images)
+{
+    gaussianBlur(kernels, images, 12, true);
+}
+
+static void shadowBlur(const PixelKernels& kernels, Images& images)
+{
+    // The lobes ShadowBlur uses for a blur radius of 20.
+    const int lobes[3][2] = { { 7, 6 }, { 6, 7 }, { 7, 7 } };
+    images.destination = images.source;
+    kernels.shadowBlur(images.destination.data(), imageHeight, imageWidth, 4, rowBytes, lobes);
+    kernels.shadowBlur(images.destination.data(), imageWidth, imageHeight, rowBytes, 4, lobes);
+}
+
+static void getImageData(const PixelKernels& kernels, Images& images)
+{
+    for (int y = 0; y < imageHeight; ++y)
+        kernels.premultipliedARGBToUnmultipliedRGBA(images.premultiplied.data() + y * imageWidth, images.destination.data() + y * rowBytes, imageWidth);
+}
+
+static void getPremultipliedImageData(const PixelKernels& kernels, Images& images)
+{
+    for (int y = 0; y < imageHeight; ++y)
+        kernels.premultipliedARGBToPremultipliedRGBA(images.premultiplied.data() + y * imageWidth, images.destination.data() + y * rowBytes, imageWidth);
+}
+
+static void putImageData(const PixelKernels& kernels, Images& images)
+{
+    unsigned* destination = reinterpret_cast<unsigned*>(images.destination.data());
+    for (int y = 0; y < imageHeight; ++y)
+        kernels.unmultipliedRGBAToPremultipliedARGB(images.unmultiplied.data() + y * rowBytes, destination + y * imageWidth, imageWidth);
+}
+
+static void putPremultipliedImageData(const PixelKernels& kernels, Images& images)
+{
+    unsigned* destination = reinterpret_cast<unsigned*>(images.destination.data());
+    for (int y = 0; y < imageHeight; ++y)
+        kernels.premultipliedRGBAToPremultipliedARGB(images.unmultiplied.data() + y * rowBytes, destination + y * imageWidth, imageWidth);
+}
+
+// Every combination of color and alpha, which the random images do not cover.
+static void allColorsAndAlphas(const PixelKernels& kernels, Images& images)
+{
+    Vector<unsigned> premultiplied(256 * 256);
+    Vector<unsigned char> unmultiplied(256 * 256 * 4);
+    for (unsigned alpha = 0; alpha < 256; ++alpha) {
+        for (unsigned color = 0; color < 256; ++color) {
+            unsigned index = alpha * 256 + color;
+            premultiplied[index] = alpha << 24 | color << 16 | (255 - color) << 8 | color / 2;
+            unsigned char* pixel = unmultiplied.data() + index * 4;
+            pixel[0] = color;
+            pixel[1] = 255 - color;
+            pixel[2] = color / 2;
+            pixel[3] = alpha;
+        }
+    }
+    images.destination.resize(256 * 256 * 8);
+    kernels.premultipliedARGBToUnmultipliedRGBA(premultiplied.data(), images.destination.data(), 256 * 256);
+    kernels.unmultipliedRGBAToPremultipliedARGB(unmultiplied.data(), reinterpret_cast<unsigned*>(images.destination.data()) + 256 * 256, 256 * 256);
+}
+
+struct Benchmark {
+    const char* name;
+    BenchmarkFunction function;
+};
+
+static const Benchmark benchmarks[] = {
+    { "FEGaussianBlur 5px", gaussianBlurSmall },
+    { "FEGaussianBlur 40px", gaussianBlurLarge },
+    { "FEGaussianBlur 4000px", gaussianBlurHuge },
+    { "FEGaussianBlur alpha 12px", gaussianBlurAlpha },
+    { "ShadowBlur 20px", shadowBlur },
+    { "getImageData", getImageData },
+    { "getPremultipliedImageData", getPremultipliedImageData },
+    { "putImageData", putImageData },
+    { "putPremultipliedImageData", putPremultipliedImageData },
+    { "all colors and alphas", allColorsAndAlphas }
+};
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations < 1)
+        iterations = 1;
+
+    Vector<const PixelKernels*> implementations;
+    implementations.append(&portablePixelKernels());
+    if (const PixelKernels* kernels = sse2PixelKernels())
+        implementations.append(kernels);
+    if (const PixelKernels* kernels = avx2PixelKernels())
+        implementations.append(kernels);
+
+    printf("%d x %d pixels, %d iterations, default kernels: %s\n\n", imageWidth, imageHeight, iterations, pixelKernels().name);
+
+    bool mismatch = false;
+    for (size_t i = 0; i < WTF_ARRAY_LENGTH(benchmarks); ++i) {
+        const Benchmark& benchmark = benchmarks[i];
+        printf("%s\n", benchmark.name);
+
+        Images images;
+        fillImages(images);
+        Vector<unsigned char> expected;
+        double portableTime = 0;
+        for (size_t j = 0; j < implementations.size(); ++j) {
+            const PixelKernels& kernels = *implementations[j];
+            double start = monotonicallyIncreasingTime();
+            for (int iteration = 0; iteration < iterations; ++iteration)
+                benchmark.function(kernels, images);
+            double time = (monotonicallyIncreasingTime() - start) * 1000 / iterations;
+
+            if (!j) {
+                portableTime = time;
+                expected = images.destination;
+            }
+            bool matches = images.destination == expected;
+            mismatch |= !matches;
+            printf("    %-10s %9.3f ms  %5.2fx%s\n", kernels.name, time, portableTime / time, matches ? "" : "  OUTPUT DIFFERS");
+        }
+    }
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Page startup as seen by the JIT: many small functions that each run a
+// handful of times while scripts load, followed by a short steady phase that
+// calls a few of them in a loop. Meant to be run with the jsc shell:
+//
+//     jsc StartupBurstBenchmark.js [-- iterations]
+//
+// Compare the "startup" line between builds to see what eager baseline
+// compilation costs; the "steady" line shows how quickly hot code gets back
+// to JIT speed.
+
+var iterations = (typeof arguments != "undefined" && arguments.length) ? parseInt(arguments[0]) : 5;
+
+function moduleSource(id, functionCount) {
+    var lines = [];
+    lines.push("var state = { id: " + id + ", items: [], handlers: {}, total: 0 };");
+    for (var i = 0; i < functionCount; ++i) {
+        var name = "f" + id + "_" + i;
+        lines.push("function " + name + "(a, b) {");
+        lines.push("    var o = { name: '" + name + "', width: a + " + i + ", height: b * 2, visible: true };");
+        lines.push("    if (o.width > 10) o.klass = 'wide'; else o.klass = 'narrow';");
+        lines.push("    state.items.push(o);");
+        lines.push("    state.handlers['" + name + "'] = function (e) { return e.x + o.width - o.height; };");
+        lines.push("    var s = o.name + ':' + o.klass;");
+        lines.push("    state.total += s.length + (o.visible ? 1 : 0);");
+        lines.push("    return o;");
+        lines.push("}");
+    }
+    lines.push("function layout(item, x) { return item.width * x + item.height; }");
+    for (var i = 0; i < functionCount; ++i)
+        lines.push("f" + id + "_" + i + "(" + i + ", " + (i % 5) + ");");
+    lines.push("exports.layout = layout; exports.state = state;");
+    return lines.join("\n");
+}
+
+function startup(round) {
+    var total = 0;
+    var modules = [];
+    for (var m = 0; m < 40; ++m) {
+        var exports = {};
+        new Function("exports", moduleSource(round * 1000 + m, 50))(exports);
+        total += exports.state.total;
+        modules.push(exports);
+    }
+    return { total: total, modules: modules };
+}
+
+function steady(modules) {
+    var sum = 0;
+    for (var r = 0; r < 200; ++r) {
+        for (var m = 0; m < modules.length; ++m) {
+            var items = modules[m].state.items;
+            var layout = modules[m].layout;
+            for (var i = 0; i < items.length; ++i)
+                sum += layout(items[i], r);
+        }
+    }
+    return sum;
+}
+
+var startupTime = 0, steadyTime = 0, check = 0;
+for (var k = 0; k < iterations; ++k) {
+    var start = Date.now();
+    var result = startup(k);
+    startupTime += Date.now() - start;
+    start = Date.now();
+    check += steady(result.modules);
+    steadyTime += Date.now() - start;
+}
+print("startup: " + (startupTime / iterations).toFixed(2) + " ms");
+print("steady: " + (steadyTime / iterations).toFixed(2) + " ms");
+print(check);
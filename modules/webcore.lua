@@ -819,6 +819,7 @@ function copyHeaders(ctx)
         { "platform/win/*.h","include/WebCore"},
         { "platform/network/*.h","include/WebCore"},
         { "platform/network/curl/*.h","include/WebCore"},
+        { "platform/posix/*.h","include/WebCore"},
         { "platform/sql/*.h","include/WebCore"},
         { "platform/cairo/cairo/src/*.h","include/WebCore"},
         { "bindings/*.h","include/WebCore"},
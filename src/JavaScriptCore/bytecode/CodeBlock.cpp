@@ -1433,6 +1433,10 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
     , m_speculativeFailCounter(0)
     , m_optimizationDelayCounter(0)
     , m_reoptimizationRetryCounter(0)
+#if ENABLE(BACKGROUND_JIT)
+    , m_hasLoops(false)
+    , m_interpretedEntryCount(0)
+#endif
 {
     ASSERT(m_source);
     
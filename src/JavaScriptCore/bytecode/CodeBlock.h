@@ -376,6 +376,26 @@ namespace JSC {
         Vector<Instruction>& instructions() { return m_instructions; }
         void discardBytecode() { m_instructions.clear(); }
 
+#if ENABLE(JIT) && ENABLE(INTERPRETER)
+        // Whether a return address saved in a call frame is an interpreter vPC into this
+        // block, rather than a return address into its JIT code.
+        bool containsInstruction(Instruction* vPC)
+        {
+            return vPC >= m_instructions.begin() && vPC < m_instructions.end();
+        }
+#endif
+
+#if ENABLE(BACKGROUND_JIT)
+        // Function code without loops starts out in the interpreter and is queued for
+        // the background JIT once it has been entered often enough.
+        void setHasLoops() { m_hasLoops = true; }
+        bool hasLoops() const { return m_hasLoops; }
+        bool shouldQueueForBackgroundJIT() { return ++m_interpretedEntryCount == Heuristics::backgroundJITCallThreshold; }
+        void resetInterpretedEntryCount() { m_interpretedEntryCount = 0; }
+        // The compiler thread must not be the one to create the rare data.
+        void createRareDataForBackgroundJIT() { createRareDataIfNecessary(); }
+#endif
+
 #ifndef NDEBUG
         unsigned instructionCount() { return m_instructionCount; }
         void setInstructionCount(unsigned instructionCount) { m_instructionCount = instructionCount; }
@@ -1005,6 +1025,10 @@ namespace JSC {
         uint32_t m_speculativeFailCounter;
         uint8_t m_optimizationDelayCounter;
         uint8_t m_reoptimizationRetryCounter;
+#if ENABLE(BACKGROUND_JIT)
+        bool m_hasLoops;
+        unsigned m_interpretedEntryCount;
+#endif
 
         struct RareData {
            WTF_MAKE_FAST_ALLOCATED;
@@ -661,6 +661,9 @@ void BytecodeGenerator::emitOpcode(OpcodeID opcodeID)
 
 void BytecodeGenerator::emitLoopHint()
 {
+#if ENABLE(BACKGROUND_JIT)
+    m_codeBlock->setHasLoops();
+#endif
 #if ENABLE(DFG_JIT)
     emitOpcode(op_loop_hint);
 #endif
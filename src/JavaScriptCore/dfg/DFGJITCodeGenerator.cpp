@@ -219,9 +219,10 @@ void JITCodeGenerator::markCellCard(MacroAssembler& jit, GPRReg owner, GPRReg sc
     jit.move(owner, scratch1);
     jit.andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch1);
     jit.move(owner, scratch2);
-    // consume additional 8 bits as we're using an approximate filter
-    jit.rshift32(TrustedImm32(MarkedBlock::atomShift + 8), scratch2);
-    jit.andPtr(TrustedImm32(MarkedBlock::atomMask >> 8), scratch2);
+    // Test the byte of the mark bitmap that holds the owner's bit. This is an
+    // approximate filter: it lets through owners whose neighbours are marked.
+    jit.rshift32(TrustedImm32(MarkedBlock::atomShift + 3), scratch2);
+    jit.andPtr(TrustedImm32(MarkedBlock::atomMask >> 3), scratch2);
     MacroAssembler::Jump filter = jit.branchTest8(MacroAssembler::Zero, MacroAssembler::BaseIndex(scratch1, scratch2, MacroAssembler::TimesOne, MarkedBlock::offsetOfMarks()));
     jit.move(owner, scratch2);
     jit.rshift32(TrustedImm32(MarkedBlock::cardShift), scratch2);
@@ -345,6 +346,24 @@ void JITCodeGenerator::writeBarrier(JSCell* owner, GPRReg valueGPR, NodeIndex va
 #endif
 }
 
+void JITCodeGenerator::markArrayVectorIfCell(GPRReg storageGPR, GPRReg valueGPR, NodeIndex valueIndex)
+{
+    if (isKnownNotCell(valueIndex))
+        return;
+
+    JITCompiler::Jump notCell;
+    bool hadCellCheck = false;
+    if (!isKnownCell(valueIndex) && !isCellPrediction(m_jit.getPrediction(valueIndex))) {
+        hadCellCheck = true;
+        notCell = m_jit.branchIfNotCell(valueGPR);
+    }
+
+    m_jit.store32(TrustedImm32(1), MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArrayStorage, m_vectorMayContainCells)));
+
+    if (hadCellCheck)
+        notCell.link(&m_jit);
+}
+
 bool JITCodeGenerator::nonSpeculativeCompare(Node& node, MacroAssembler::RelationalCondition cond, S_DFGOperation_EJJ helperFunction)
 {
     NodeIndex branchNodeIndex = detectPeepHoleBranch();
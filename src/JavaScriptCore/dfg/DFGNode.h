@@ -566,12 +566,12 @@ struct Node {
     }
     
     // This corrects the arithmetic node flags, so that irrelevant bits are
-    // ignored. In particular, anything other than ArithMul does not need
-    // to know if it can speculate on negative zero.
+    // ignored. In particular, anything other than ArithMul, ArithDiv and
+    // ArithMod does not need to know if it can speculate on negative zero.
     ArithNodeFlags arithNodeFlags()
     {
         ArithNodeFlags result = rawArithNodeFlags();
-        if (op == ArithMul)
+        if (op == ArithMul || op == ArithDiv || op == ArithMod)
             return result;
         return result & ~NodeNeedsNegZero;
     }
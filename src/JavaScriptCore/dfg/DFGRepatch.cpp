@@ -222,8 +222,13 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
     Structure* structure = baseCell->structure();
     if (!slot.isCacheable())
         return false;
-    if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching())
+    if (structure->typeInfo().prohibitsPropertyCaching())
         return false;
+    if (structure->isUncacheableDictionary()) {
+        // Leave the access uncached rather than generic if the object gets flattened;
+        // we cache it, with the new offsets, the next time around.
+        return asObject(baseCell)->flattenUncacheableDictionaryForCaching(*globalData);
+    }
 
     // Optimize self access.
     if (slot.slotBase() == baseValue) {
@@ -327,9 +332,16 @@ void dfgRepatchGetMethod(ExecState* exec, JSValue baseValue, const Identifier& p
 
 static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identifier&, const PropertySlot& slot, StructureStubInfo& stubInfo)
 {
+    if (baseValue.isCell()
+        && slot.isCacheable()
+        && baseValue.asCell()->structure()->isUncacheableDictionary()
+        && slot.slotBase() == baseValue) {
+        // Keep the structures we already have in the list.
+        return asObject(baseValue)->flattenUncacheableDictionaryForCaching(exec->globalData());
+    }
+
     if (!baseValue.isCell()
         || !slot.isCacheable()
-        || baseValue.asCell()->structure()->isUncacheableDictionary()
         || slot.slotBase() != baseValue
         || slot.cachedPropertyType() != PropertySlot::Value
         || (slot.cachedOffset() * sizeof(JSValue)) > (unsigned)MacroAssembler::MaximumCompactPtrAlignedAddressOffset)
@@ -510,7 +522,7 @@ static bool tryCachePutByID(ExecState* exec, JSValue baseValue, const Identifier
     if (!slot.isCacheable())
         return false;
     if (structure->isUncacheableDictionary())
-        return false;
+        return asObject(baseCell)->flattenUncacheableDictionaryForCaching(*globalData);
 
     // Optimize self access.
     if (slot.base() == baseValue) {
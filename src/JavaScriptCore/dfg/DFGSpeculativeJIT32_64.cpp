@@ -1078,6 +1078,11 @@ void SpeculativeJIT::compile(Node& node)
             
             speculationCheck(m_jit.branchTest32(JITCompiler::Zero, op2GPR));
             
+            // idiv traps on -2^31 / -1, whose quotient is not an int32 anyway.
+            MacroAssembler::Jump denominatorNotNegativeOne = m_jit.branch32(MacroAssembler::NotEqual, op2GPR, TrustedImm32(-1));
+            speculationCheck(m_jit.branch32(MacroAssembler::Equal, op1GPR, TrustedImm32(-2147483647 - 1)));
+            denominatorNotNegativeOne.link(&m_jit);
+            
             // If the user cares about negative zero, then speculate that we're not about
             // to produce negative zero.
             if (!nodeCanIgnoreNegativeZero(node.arithNodeFlags())) {
@@ -1148,6 +1153,21 @@ void SpeculativeJIT::compile(Node& node)
 
         speculationCheck(m_jit.branchTest32(JITCompiler::Zero, op2Gpr));
 
+        // As for ArithDiv, -2^31 % -1 would make idiv trap.
+        MacroAssembler::Jump denominatorNotNegativeOne = m_jit.branch32(MacroAssembler::NotEqual, op2Gpr, TrustedImm32(-1));
+        speculationCheck(m_jit.branch32(MacroAssembler::Equal, op1Gpr, TrustedImm32(-2147483647 - 1)));
+        denominatorNotNegativeOne.link(&m_jit);
+
+        // The numerator is needed after idiv to detect a negative zero result, so
+        // keep it out of the registers idiv clobbers.
+        GPRReg temp1 = InvalidGPRReg;
+        bool checkNegativeZero = !nodeCanIgnoreNegativeZero(node.arithNodeFlags());
+        if (checkNegativeZero && (op1Gpr == X86Registers::eax || op1Gpr == X86Registers::edx)) {
+            temp1 = allocate();
+            m_jit.move(op1Gpr, temp1);
+        }
+        GPRReg numeratorGPR = temp1 != InvalidGPRReg ? temp1 : op1Gpr;
+
         GPRReg temp2 = InvalidGPRReg;
         if (op2Gpr == X86Registers::eax || op2Gpr == X86Registers::edx) {
             temp2 = allocate();
@@ -1162,6 +1182,16 @@ void SpeculativeJIT::compile(Node& node)
         if (temp2 != InvalidGPRReg)
             unlock(temp2);
 
+        // A negative numerator with no remainder produces -0, which is not an int32.
+        if (checkNegativeZero) {
+            MacroAssembler::Jump numeratorPositive = m_jit.branch32(MacroAssembler::GreaterThanOrEqual, numeratorGPR, TrustedImm32(0));
+            speculationCheck(m_jit.branchTest32(MacroAssembler::Zero, edx.gpr()));
+            numeratorPositive.link(&m_jit);
+        }
+
+        if (temp1 != InvalidGPRReg)
+            unlock(temp1);
+
         integerResult(edx.gpr(), m_compileIndex);
         break;
     }
@@ -1457,6 +1487,7 @@ void SpeculativeJIT::compile(Node& node)
         // Store the value to the array.
         m_jit.store32(valueTagReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)));
         m_jit.store32(valuePayloadReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload)));
+        markArrayVectorIfCell(storageReg, valueTagReg, node.child3());
 
         wasBeyondArrayBounds.link(&m_jit);
 
@@ -1489,6 +1520,7 @@ void SpeculativeJIT::compile(Node& node)
         GPRReg propertyReg = property.gpr();
         m_jit.store32(value.tagGPR(), MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)));
         m_jit.store32(value.payloadGPR(), MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload)));
+        markArrayVectorIfCell(storageReg, value.tagGPR(), node.child3());
 
         noResult(m_compileIndex);
         break;
@@ -1521,6 +1553,7 @@ void SpeculativeJIT::compile(Node& node)
         
         m_jit.store32(valueTagGPR, MacroAssembler::BaseIndex(storageGPR, storageLengthGPR, MacroAssembler::TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)));
         m_jit.store32(valuePayloadGPR, MacroAssembler::BaseIndex(storageGPR, storageLengthGPR, MacroAssembler::TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload)));
+        markArrayVectorIfCell(storageGPR, valueTagGPR, node.child2());
         
         m_jit.add32(Imm32(1), storageLengthGPR);
         m_jit.store32(storageLengthGPR, MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArrayStorage, m_length)));
@@ -1199,6 +1199,11 @@ void SpeculativeJIT::compile(Node& node)
             
             speculationCheck(m_jit.branchTest32(JITCompiler::Zero, op2GPR));
             
+            // idiv traps on -2^31 / -1, whose quotient is not an int32 anyway.
+            MacroAssembler::Jump denominatorNotNegativeOne = m_jit.branch32(MacroAssembler::NotEqual, op2GPR, TrustedImm32(-1));
+            speculationCheck(m_jit.branch32(MacroAssembler::Equal, op1GPR, TrustedImm32(-2147483647 - 1)));
+            denominatorNotNegativeOne.link(&m_jit);
+            
             // If the user cares about negative zero, then speculate that we're not about
             // to produce negative zero.
             if (!nodeCanIgnoreNegativeZero(node.arithNodeFlags())) {
@@ -1269,6 +1274,21 @@ void SpeculativeJIT::compile(Node& node)
 
         speculationCheck(m_jit.branchTest32(JITCompiler::Zero, op2Gpr));
 
+        // As for ArithDiv, -2^31 % -1 would make idiv trap.
+        MacroAssembler::Jump denominatorNotNegativeOne = m_jit.branch32(MacroAssembler::NotEqual, op2Gpr, TrustedImm32(-1));
+        speculationCheck(m_jit.branch32(MacroAssembler::Equal, op1Gpr, TrustedImm32(-2147483647 - 1)));
+        denominatorNotNegativeOne.link(&m_jit);
+
+        // The numerator is needed after idiv to detect a negative zero result, so
+        // keep it out of the registers idiv clobbers.
+        GPRReg temp1 = InvalidGPRReg;
+        bool checkNegativeZero = !nodeCanIgnoreNegativeZero(node.arithNodeFlags());
+        if (checkNegativeZero && (op1Gpr == X86Registers::eax || op1Gpr == X86Registers::edx)) {
+            temp1 = allocate();
+            m_jit.move(op1Gpr, temp1);
+        }
+        GPRReg numeratorGPR = temp1 != InvalidGPRReg ? temp1 : op1Gpr;
+
         GPRReg temp2 = InvalidGPRReg;
         if (op2Gpr == X86Registers::eax || op2Gpr == X86Registers::edx) {
             temp2 = allocate();
@@ -1283,6 +1303,16 @@ void SpeculativeJIT::compile(Node& node)
         if (temp2 != InvalidGPRReg)
             unlock(temp2);
 
+        // A negative numerator with no remainder produces -0, which is not an int32.
+        if (checkNegativeZero) {
+            MacroAssembler::Jump numeratorPositive = m_jit.branch32(MacroAssembler::GreaterThanOrEqual, numeratorGPR, TrustedImm32(0));
+            speculationCheck(m_jit.branchTest32(MacroAssembler::Zero, edx.gpr()));
+            numeratorPositive.link(&m_jit);
+        }
+
+        if (temp1 != InvalidGPRReg)
+            unlock(temp1);
+
         integerResult(edx.gpr(), m_compileIndex);
         break;
     }
@@ -1571,6 +1601,7 @@ void SpeculativeJIT::compile(Node& node)
 
         // Store the value to the array.
         m_jit.storePtr(valueReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
+        markArrayVectorIfCell(storageReg, valueReg, node.child3());
 
         wasBeyondArrayBounds.link(&m_jit);
 
@@ -1605,6 +1636,7 @@ void SpeculativeJIT::compile(Node& node)
         GPRReg propertyReg = property.gpr();
         GPRReg valueReg = value.gpr();
         m_jit.storePtr(valueReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
+        markArrayVectorIfCell(storageReg, valueReg, node.child3());
 
         noResult(m_compileIndex);
         break;
@@ -1635,6 +1667,7 @@ void SpeculativeJIT::compile(Node& node)
         MacroAssembler::Jump slowPath = m_jit.branch32(MacroAssembler::AboveOrEqual, storageLengthGPR, MacroAssembler::Address(baseGPR, JSArray::vectorLengthOffset()));
         
         m_jit.storePtr(valueGPR, MacroAssembler::BaseIndex(storageGPR, storageLengthGPR, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
+        markArrayVectorIfCell(storageGPR, valueGPR, node.child2());
         
         m_jit.add32(Imm32(1), storageLengthGPR);
         m_jit.store32(storageLengthGPR, MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArrayStorage, m_length)));
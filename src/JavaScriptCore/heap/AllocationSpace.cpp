@@ -31,6 +31,12 @@
 
 #define COLLECT_ON_EVERY_ALLOCATION 0
 
+// How many leftover blocks each trip through the allocation slow path sweeps
+// on behalf of other size classes. This keeps the garbage from the last
+// collection from outliving it by much, without charging any single
+// allocation for more than a couple of blocks.
+static const unsigned blocksToSweepPerSlowCase = 2;
+
 namespace JSC {
 
 inline void* AllocationSpace::tryAllocate(MarkedSpace::SizeClass& sizeClass)
@@ -47,6 +53,8 @@ void* AllocationSpace::allocateSlowCase(MarkedSpace::SizeClass& sizeClass)
     collectAllGarbage();
     ASSERT(m_heap->m_operationInProgress == NoOperation);
 #endif
+
+    for (unsigned i = 0; i < blocksToSweepPerSlowCase && sweepNextBlock(); ++i) { }
     
     void* result = tryAllocate(sizeClass);
     
@@ -81,7 +89,11 @@ void* AllocationSpace::allocateSlowCase(MarkedSpace::SizeClass& sizeClass)
     if (result)
         return result;
     
+#if !ENABLE(GGC)
+    // A young collection leaves old cells in place, so the heap can still be
+    // past its high water mark afterwards.
     ASSERT(m_markedSpace.waterMark() < m_markedSpace.highWaterMark());
+#endif
     
     m_markedSpace.addBlock(sizeClass, allocateBlock(sizeClass.cellSize, AllocationMustSucceed));
     
@@ -163,11 +175,43 @@ inline TakeIfUnmarked::ReturnType TakeIfUnmarked::returnValue()
 
 void AllocationSpace::shrink()
 {
+    // The blocks about to be freed may be queued for sweeping.
+    m_blocksToSweep.clear();
+    m_nextBlockToSweep = 0;
+
     // We record a temporary list of empties to avoid modifying m_blocks while iterating it.
     TakeIfUnmarked takeIfUnmarked(&m_markedSpace);
     freeBlocks(forEachBlock(takeIfUnmarked));
 }
 
+void AllocationSpace::startSweeping()
+{
+    m_blocksToSweep.clear();
+    m_nextBlockToSweep = 0;
+
+    BlockIterator end = m_blocks.set().end();
+    for (BlockIterator it = m_blocks.set().begin(); it != end; ++it) {
+        if ((*it)->needsSweeping())
+            m_blocksToSweep.append(*it);
+    }
+}
+
+bool AllocationSpace::sweepNextBlock()
+{
+    while (m_nextBlockToSweep < m_blocksToSweep.size()) {
+        MarkedBlock* block = m_blocksToSweep[m_nextBlockToSweep++];
+        // The block's own allocator may have got to it first.
+        if (!block->needsSweeping())
+            continue;
+        block->sweep();
+        return true;
+    }
+
+    m_blocksToSweep.clear();
+    m_nextBlockToSweep = 0;
+    return false;
+}
+
 #if ENABLE(GGC)
 class GatherDirtyCells {
     WTF_MAKE_NONCOPYABLE(GatherDirtyCells);
@@ -41,6 +41,7 @@ public:
     AllocationSpace(Heap* heap)
         : m_heap(heap)
         , m_markedSpace(heap)
+        , m_nextBlockToSweep(0)
     {
     }
     
@@ -66,6 +67,13 @@ public:
     void* allocate(size_t);
     void freeBlocks(MarkedBlock*);
     void shrink();
+
+    // Collections leave dead cells in place. Each size class sweeps its own
+    // blocks as its allocator reaches them; these let the rest of the heap
+    // be swept a block at a time, away from the collector's pause.
+    void startSweeping();
+    bool sweepNextBlock(); // Returns false once every block has been swept.
+    bool hasBlocksToSweep() { return m_nextBlockToSweep < m_blocksToSweep.size(); }
     
 private:
     enum AllocationEffort { AllocationMustSucceed, AllocationCanFail };
@@ -78,6 +86,9 @@ private:
     Heap* m_heap;
     MarkedSpace m_markedSpace;
     MarkedBlockSet m_blocks;
+
+    Vector<MarkedBlock*> m_blocksToSweep;
+    size_t m_nextBlockToSweep;
 };
 
 template<typename Functor> inline typename Functor::ReturnType AllocationSpace::forEachCell(Functor& functor)
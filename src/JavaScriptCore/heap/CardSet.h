@@ -48,6 +48,7 @@ public:
     uint8_t& cardForAtom(const void*);
     bool isCardMarked(size_t);
     bool testAndClear(size_t);
+    void clearAll();
 
 private:
     uint8_t m_cards[cardCount];
@@ -86,6 +87,11 @@ template <size_t cardSize, size_t blockSize> bool CardSet<cardSize, blockSize>::
     return result;
 }
 
+template <size_t cardSize, size_t blockSize> void CardSet<cardSize, blockSize>::clearAll()
+{
+    memset(m_cards, 0, cardCount);
+}
+
 }
 
 #endif
@@ -98,6 +98,29 @@ void HandleHeap::visitWeakHandles(HeapRootVisitor& heapRootVisitor)
     }
 }
 
+#if ENABLE(GGC)
+void HandleHeap::revisitMarkedWeakHandles(HeapRootVisitor& heapRootVisitor)
+{
+    // A young collection does not retrace old cells, but weak handle owners
+    // judge reachability by the opaque roots that tracing their cells adds.
+    // Revisiting the old cells that have owners rebuilds the opaque roots a
+    // full collection would have found.
+    SlotVisitor& visitor = heapRootVisitor.visitor();
+
+    Node* end = m_weakList.end();
+    for (Node* node = m_weakList.begin(); node != end; node = node->next()) {
+        if (!node->weakOwner())
+            continue;
+
+        JSCell* cell = node->slot()->asCell();
+        if (!Heap::isMarked(cell))
+            continue;
+
+        visitor.appendMarkedCell(cell);
+    }
+}
+#endif
+
 void HandleHeap::finalizeWeakHandles()
 {
     Node* end = m_weakList.end();
@@ -63,6 +63,9 @@ public:
 
     void visitStrongHandles(HeapRootVisitor&);
     void visitWeakHandles(HeapRootVisitor&);
+#if ENABLE(GGC)
+    void revisitMarkedWeakHandles(HeapRootVisitor&);
+#endif
     void finalizeWeakHandles();
 
     void writeBarrier(HandleSlot, const JSValue&);
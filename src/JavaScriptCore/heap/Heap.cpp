@@ -21,10 +21,12 @@
 #include "config.h"
 #include "Heap.h"
 
+#include "BackgroundJIT.h"
 #include "CodeBlock.h"
 #include "ConservativeRoots.h"
 #include "GCActivityCallback.h"
 #include "HeapRootVisitor.h"
+#include "Heuristics.h"
 #include "Interpreter.h"
 #include "JSGlobalData.h"
 #include "JSGlobalObject.h"
@@ -32,6 +34,7 @@
 #include "JSONObject.h"
 #include "Tracing.h"
 #include <algorithm>
+#include <wtf/CurrentTime.h>
 
 
 using namespace std;
@@ -209,15 +212,6 @@ inline void ClearMarks::operator()(MarkedBlock* block)
     block->clearMarks();
 }
 
-struct Sweep : MarkedBlock::VoidFunctor {
-    void operator()(MarkedBlock*);
-};
-
-inline void Sweep::operator()(MarkedBlock* block)
-{
-    block->sweep();
-}
-
 struct MarkCount : CountFunctor {
     void operator()(MarkedBlock*);
 };
@@ -309,15 +303,18 @@ Heap::Heap(JSGlobalData* globalData, HeapSize heapSize)
     : m_heapSize(heapSize)
     , m_minBytesPerCycle(heapSizeForHint(heapSize))
     , m_lastFullGCSize(0)
+    , m_youngGCsSinceFullGC(0)
     , m_operationInProgress(NoOperation)
     , m_objectSpace(this)
     , m_extraCost(0)
     , m_markListSet(0)
     , m_activityCallback(DefaultGCActivityCallback::create(this))
     , m_machineThreads(this)
-    , m_slotVisitor(globalData->jsArrayVPtr, globalData->jsFinalObjectVPtr, globalData->jsStringVPtr)
+    , m_sharedData(globalData)
+    , m_slotVisitor(m_sharedData)
     , m_handleHeap(globalData)
     , m_isSafeToCollect(false)
+    , m_recordsPauseTimes(false)
     , m_globalData(globalData)
 {
     m_objectSpace.setHighWaterMark(m_minBytesPerCycle);
@@ -358,6 +355,10 @@ void Heap::destroy()
 #if ENABLE(JIT)
     m_globalData->jitStubs->clearHostFunctionStubs();
 #endif
+#if ENABLE(BACKGROUND_JIT)
+    // Stops the compiler thread and releases the executables it was holding on to.
+    m_globalData->backgroundJIT.clear();
+#endif
 
     delete m_markListSet;
     m_markListSet = 0;
@@ -557,6 +558,8 @@ void Heap::markRoots(bool fullGC)
         CRASH();
     m_operationInProgress = Collection;
 
+    m_sharedData.startMarkingThreadsIfNecessary();
+
     void* dummy;
     
     // We gather conservative roots before clearing mark bits because conservative
@@ -590,67 +593,76 @@ void Heap::markRoots(bool fullGC)
     HeapRootVisitor heapRootVisitor(visitor);
 
 #if ENABLE(GGC)
-    {
-        size_t dirtyCellCount = dirtyCells.size();
+    // Old cells stay marked through a young collection, so tracing stops at
+    // them. The ones that may point at young cells are visited again instead.
+    if (!fullGC) {
         GCPHASE(VisitDirtyCells);
+        size_t dirtyCellCount = dirtyCells.size();
         GCCOUNTER(DirtyCellCount, dirtyCellCount);
-        for (size_t i = 0; i < dirtyCellCount; i++) {
-            heapRootVisitor.visitChildren(dirtyCells[i]);
-            visitor.drain();
-        }
+        for (size_t i = 0; i < dirtyCellCount; i++)
+            visitor.appendMarkedCell(dirtyCells[i]);
+        m_handleHeap.revisitMarkedWeakHandles(heapRootVisitor);
+        visitor.donateAndDrain();
     }
 #endif
 
     {
         GCPHASE(VisitMachineRoots);
         visitor.append(machineThreadRoots);
-        visitor.drain();
+        visitor.donateAndDrain();
     }
     {
         GCPHASE(VisitRegisterFileRoots);
         visitor.append(registerFileRoots);
-        visitor.drain();
+        visitor.donateAndDrain();
     }
     {
         GCPHASE(VisitProtectedObjects);
         markProtectedObjects(heapRootVisitor);
-        visitor.drain();
+        visitor.donateAndDrain();
     }
     {
         GCPHASE(VisitTempSortVectors);
         markTempSortVectors(heapRootVisitor);
-        visitor.drain();
+        visitor.donateAndDrain();
     }
 
     {
         GCPHASE(MarkingArgumentBuffers);
         if (m_markListSet && m_markListSet->size()) {
             MarkedArgumentBuffer::markLists(heapRootVisitor, *m_markListSet);
-            visitor.drain();
+            visitor.donateAndDrain();
         }
     }
     if (m_globalData->exception) {
         GCPHASE(MarkingException);
         heapRootVisitor.visit(&m_globalData->exception);
-        visitor.drain();
+        visitor.donateAndDrain();
     }
     
     {
         GCPHASE(VisitStrongHandles);
         m_handleHeap.visitStrongHandles(heapRootVisitor);
-        visitor.drain();
+        visitor.donateAndDrain();
     }
     
     {
         GCPHASE(HandleStack);
         m_handleStack.visit(heapRootVisitor);
-        visitor.drain();
+        visitor.donateAndDrain();
     }
     
     {
         GCPHASE(TraceCodeBlocks);
         m_jettisonedCodeBlocks.traceCodeBlocks(visitor);
-        visitor.drain();
+        visitor.donateAndDrain();
+    }
+
+    // Wait for the other markers: the weak handle pass below needs the
+    // complete set of opaque roots.
+    {
+        GCPHASE(DrainFromShared);
+        visitor.drainFromShared(SlotVisitor::MasterDrain);
     }
 
     // Weak handles must be marked last, because their owners use the set of
@@ -661,12 +673,14 @@ void Heap::markRoots(bool fullGC)
         do {
             lastOpaqueRootCount = visitor.opaqueRootCount();
             m_handleHeap.visitWeakHandles(heapRootVisitor);
-            visitor.drain();
+            visitor.donateAndDrain();
+            visitor.drainFromShared(SlotVisitor::MasterDrain);
             // If the set of opaque roots has grown, more weak handles may have become reachable.
         } while (lastOpaqueRootCount != visitor.opaqueRootCount());
     }
     GCCOUNTER(VisitedValueCount, visitor.visitCount());
     visitor.reset();
+    m_sharedData.reset();
 
     m_operationInProgress = NoOperation;
 }
@@ -676,9 +690,18 @@ void Heap::clearMarks()
     m_objectSpace.forEachBlock<ClearMarks>();
 }
 
-void Heap::sweep()
+bool Heap::sweepIncrementally(double timeLimit)
 {
-    m_objectSpace.forEachBlock<Sweep>();
+    ASSERT(isValidThreadState(m_globalData));
+    if (m_operationInProgress != NoOperation)
+        return m_objectSpace.hasBlocksToSweep();
+
+    double deadline = WTF::currentTime() + timeLimit;
+    while (m_objectSpace.sweepNextBlock()) {
+        if (WTF::currentTime() >= deadline)
+            return m_objectSpace.hasBlocksToSweep();
+    }
+    return false;
 }
 
 size_t Heap::objectCount()
@@ -737,10 +760,19 @@ void Heap::collect(SweepToggle sweepToggle)
     ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
     ASSERT(m_isSafeToCollect);
     JAVASCRIPTCORE_GC_BEGIN();
+#if ENABLE(BACKGROUND_JIT)
+    // Code blocks must not be visited or finalized while the compiler thread fills in their side tables.
+    MutexLocker compilationLocker(m_globalData->backgroundJIT->compilationLock());
+#endif
+    double collectionStartTime = m_recordsPauseTimes ? WTF::currentTime() : 0;
 #if ENABLE(GGC)
-    bool fullGC = sweepToggle == DoSweep;
-    if (!fullGC)
-        fullGC = (capacity() > 4 * m_lastFullGCSize);  
+    // A young collection leaves every old cell marked, so old garbage waits
+    // for the next full collection. Schedule one once the survivors of young
+    // collections have grown the heap enough, or after a bounded number of
+    // young collections so that dead DOM wrappers cannot pile up for good.
+    bool fullGC = sweepToggle == DoSweep
+        || size() > Heuristics::oldGenerationGrowthFactorForFullGC * m_lastFullGCSize
+        || m_youngGCsSinceFullGC >= Heuristics::maximumYoungGCsBetweenFullGCs;
 #else
     bool fullGC = true;
 #endif
@@ -756,6 +788,7 @@ void Heap::collect(SweepToggle sweepToggle)
         harvestWeakReferences();
         m_handleHeap.finalizeWeakHandles();
         m_globalData->smallStrings.finalizeSmallStrings();
+        m_globalData->reflattenedDictionaryObjects.clear();
     }
 
     JAVASCRIPTCORE_GC_MARKED();
@@ -765,11 +798,13 @@ void Heap::collect(SweepToggle sweepToggle)
         resetAllocator();
     }
 
+    // Dead cells in surviving blocks are swept lazily, by their size class's
+    // allocator or by sweepIncrementally(), rather than in this pause.
     if (sweepToggle == DoSweep) {
-        GCPHASE(Sweeping);
-        sweep();
+        GCPHASE(Shrinking);
         shrink();
     }
+    m_objectSpace.startSweeping();
 
     // To avoid pathological GC churn in large heaps, we set the allocation high
     // water mark to be proportional to the current size of the heap. The exact
@@ -779,10 +814,15 @@ void Heap::collect(SweepToggle sweepToggle)
     size_t proportionalBytes = 2 * newSize;
     if (fullGC) {
         m_lastFullGCSize = newSize;
+        m_youngGCsSinceFullGC = 0;
         m_objectSpace.setHighWaterMark(max(proportionalBytes, m_minBytesPerCycle));
-    }
+    } else
+        ++m_youngGCsSinceFullGC;
     JAVASCRIPTCORE_GC_END();
 
+    if (m_recordsPauseTimes)
+        (fullGC ? m_fullPauseTimes : m_youngPauseTimes).append(WTF::currentTime() - collectionStartTime);
+
     (*m_activityCallback)();
 }
 
@@ -98,6 +98,10 @@ namespace JSC {
         void notifyIsSafeToCollect() { m_isSafeToCollect = true; }
         void collectAllGarbage();
 
+        // Sweeps blocks left over from the last collection until timeLimit
+        // seconds have passed. Returns true if there is more left to sweep.
+        bool sweepIncrementally(double timeLimit);
+
         void reportExtraMemoryCost(size_t cost);
 
         void protect(JSValue);
@@ -127,6 +131,12 @@ namespace JSC {
 
         void getConservativeRegisterRoots(HashSet<JSCell*>& roots);
 
+        // When enabled, the wall clock duration of every collection is kept,
+        // so that tools can report how long the mutator was paused.
+        void setRecordsPauseTimes(bool recordsPauseTimes) { m_recordsPauseTimes = recordsPauseTimes; }
+        const Vector<double>& fullPauseTimes() const { return m_fullPauseTimes; }
+        const Vector<double>& youngPauseTimes() const { return m_youngPauseTimes; }
+
     private:
         friend class MarkedBlock;
         friend class AllocationSpace;
@@ -159,7 +169,6 @@ namespace JSC {
         void collect(SweepToggle);
         void shrink();
         void releaseFreeBlocks();
-        void sweep();
 
         RegisterFile& registerFile();
 
@@ -171,6 +180,7 @@ namespace JSC {
         const HeapSize m_heapSize;
         const size_t m_minBytesPerCycle;
         size_t m_lastFullGCSize;
+        unsigned m_youngGCsSinceFullGC;
         
         OperationInProgress m_operationInProgress;
         AllocationSpace m_objectSpace;
@@ -196,6 +206,7 @@ namespace JSC {
         OwnPtr<GCActivityCallback> m_activityCallback;
         
         MachineThreads m_machineThreads;
+        MarkStackThreadSharedData m_sharedData;
         SlotVisitor m_slotVisitor;
         HandleHeap m_handleHeap;
         HandleStack m_handleStack;
@@ -204,6 +215,10 @@ namespace JSC {
         
         bool m_isSafeToCollect;
 
+        bool m_recordsPauseTimes;
+        Vector<double> m_fullPauseTimes;
+        Vector<double> m_youngPauseTimes;
+
         JSGlobalData* m_globalData;
     };
 
@@ -28,15 +28,24 @@
 
 #include "ConservativeRoots.h"
 #include "Heap.h"
+#include "Heuristics.h"
 #include "JSArray.h"
 #include "JSCell.h"
+#include "JSGlobalData.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
+#include "SlotVisitor.h"
 #include "Structure.h"
 #include "WriteBarrier.h"
+#include <wtf/MainThread.h>
 
 namespace JSC {
 
+// How many cells a marker visits before it checks whether another marker has
+// run out of work. Small enough to keep idle markers fed, large enough that
+// the check stays off the profile.
+static const unsigned minimumNumberOfScansBetweenRebalance = 100;
+
 MarkStackArray::MarkStackArray()
     : m_top(0)
     , m_allocated(pageSize())
@@ -79,13 +88,137 @@ void MarkStackArray::shrinkAllocation(size_t size)
     m_capacity = m_allocated / sizeof(JSCell*);
 }
 
+void MarkStackArray::donateSomeCellsTo(MarkStackArray& other)
+{
+    // Give away the bottom half of the stack. Those cells were pushed first,
+    // so they tend to lead into the largest unexplored parts of the graph,
+    // while the cells we keep are the ones still warm in this core's cache.
+    size_t numberOfCellsToDonate = m_top / 2;
+    if (!numberOfCellsToDonate)
+        return;
+
+    for (size_t i = 0; i < numberOfCellsToDonate; ++i)
+        other.append(m_data[i]);
+
+    m_top -= numberOfCellsToDonate;
+    memmove(m_data, m_data + numberOfCellsToDonate, m_top * sizeof(const JSCell*));
+}
+
+void MarkStackArray::stealSomeCellsFrom(MarkStackArray& other, size_t numberOfMarkers)
+{
+    // Take an even share, so that every marker woken by the same donation
+    // finds something left to do.
+    ASSERT(numberOfMarkers);
+    size_t numberOfCellsToSteal = std::max<size_t>(other.size() / numberOfMarkers, 1);
+    for (size_t i = 0; i < numberOfCellsToSteal && !other.isEmpty(); ++i)
+        append(other.removeLast());
+}
+
+MarkStackThreadSharedData::MarkStackThreadSharedData(JSGlobalData* globalData)
+    : m_globalData(globalData)
+    , m_numberOfMarkers(1)
+    , m_numberOfActiveParallelMarkers(0)
+    , m_parallelMarkersShouldExit(false)
+    , m_firstWeakReferenceHarvester(0)
+{
+}
+
+MarkStackThreadSharedData::~MarkStackThreadSharedData()
+{
+#if ENABLE(PARALLEL_GC)
+    // Destroy our marking threads.
+    {
+        MutexLocker locker(m_markingLock);
+        m_parallelMarkersShouldExit = true;
+        m_markingCondition.broadcast();
+    }
+    for (unsigned i = 0; i < m_markingThreads.size(); ++i)
+        waitForThreadCompletion(m_markingThreads[i], 0);
+#endif
+}
+
+void MarkStackThreadSharedData::startMarkingThreadsIfNecessary()
+{
+#if ENABLE(PARALLEL_GC)
+    if (m_numberOfMarkers > 1 || Heuristics::numberOfGCMarkers <= 1)
+        return;
+
+    m_numberOfMarkers = Heuristics::numberOfGCMarkers;
+    for (unsigned i = 1; i < m_numberOfMarkers; ++i) {
+        ThreadIdentifier thread = createThread(markingThreadStartFunc, this, "JavaScriptCore::Marking");
+        if (!thread) {
+            // Carry on with however many markers we managed to start.
+            m_numberOfMarkers = i;
+            break;
+        }
+        m_markingThreads.append(thread);
+    }
+#endif
+}
+
+#if ENABLE(PARALLEL_GC)
+void* MarkStackThreadSharedData::markingThreadStartFunc(void* shared)
+{
+    static_cast<MarkStackThreadSharedData*>(shared)->markingThreadMain();
+    return 0;
+}
+
+void MarkStackThreadSharedData::markingThreadMain()
+{
+    SlotVisitor slotVisitor(*this);
+    slotVisitor.drainFromShared(SlotVisitor::SlaveDrain);
+}
+#endif
+
+void MarkStackThreadSharedData::reset()
+{
+    ASSERT(!m_numberOfActiveParallelMarkers);
+    ASSERT(m_sharedMarkStack.isEmpty());
+    m_sharedMarkStack.shrinkAllocation(pageSize());
+    m_opaqueRoots.clear();
+}
+
+MarkStack::MarkStack(MarkStackThreadSharedData& shared)
+    : m_jsArrayVPtr(shared.m_globalData->jsArrayVPtr)
+    , m_jsFinalObjectVPtr(shared.m_globalData->jsFinalObjectVPtr)
+    , m_jsStringVPtr(shared.m_globalData->jsStringVPtr)
+    , m_shared(shared)
+#if !ASSERT_DISABLED
+    , m_isCheckingForDefaultMarkViolation(false)
+    , m_isDraining(false)
+#endif
+    , m_visitCount(0)
+{
+}
+
 void MarkStack::reset()
 {
     m_visitCount = 0;
     m_stack.shrinkAllocation(pageSize());
+    ASSERT(m_opaqueRoots.isEmpty());
+}
+
+void MarkStack::mergeOpaqueRoots()
+{
+    ASSERT(!m_opaqueRoots.isEmpty());
+    {
+        MutexLocker locker(m_shared.m_opaqueRootsLock);
+        HashSet<void*>::iterator end = m_opaqueRoots.end();
+        for (HashSet<void*>::iterator iter = m_opaqueRoots.begin(); iter != end; ++iter)
+            m_shared.m_opaqueRoots.add(*iter);
+    }
     m_opaqueRoots.clear();
 }
 
+void MarkStack::addWeakReferenceHarvester(WeakReferenceHarvester* weakReferenceHarvester)
+{
+    MutexLocker locker(m_shared.m_weakReferenceHarvesterLock);
+    if (weakReferenceHarvester->m_nextAndFlag & 1)
+        return;
+    weakReferenceHarvester->m_nextAndFlag = reinterpret_cast<uintptr_t>(m_shared.m_firstWeakReferenceHarvester) | 1;
+    m_shared.m_firstWeakReferenceHarvester = weakReferenceHarvester;
+}
+
 void MarkStack::append(ConservativeRoots& conservativeRoots)
 {
     JSCell** roots = conservativeRoots.roots();
@@ -120,23 +253,116 @@ ALWAYS_INLINE static void visitChildren(SlotVisitor& visitor, const JSCell* cell
     cell->methodTable()->visitChildren(const_cast<JSCell*>(cell), visitor);
 }
 
+void SlotVisitor::donateKnownParallel()
+{
+    // Every one of these checks errs towards not donating; the next check is
+    // only minimumNumberOfScansBetweenRebalance cells away.
+
+    // A marker that is about to run dry has nothing worth giving.
+    if (m_stack.size() < 2)
+        return;
+
+    // If there is still shared work queued up, nobody is starving. This read
+    // is racy, which is fine: a stale answer only delays the next donation.
+    if (!m_shared.m_sharedMarkStack.isEmpty())
+        return;
+
+    // If the lock is contended, another marker is already donating.
+    if (!m_shared.m_markingLock.tryLock())
+        return;
+
+    m_stack.donateSomeCellsTo(m_shared.m_sharedMarkStack);
+    if (m_shared.m_numberOfActiveParallelMarkers < m_shared.m_numberOfMarkers)
+        m_shared.m_markingCondition.broadcast();
+
+    m_shared.m_markingLock.unlock();
+}
+
 void SlotVisitor::drain()
 {
     void* jsFinalObjectVPtr = m_jsFinalObjectVPtr;
     void* jsArrayVPtr = m_jsArrayVPtr;
     void* jsStringVPtr = m_jsStringVPtr;
 
+#if ENABLE(PARALLEL_GC)
+    if (m_shared.m_numberOfMarkers > 1) {
+        while (!m_stack.isEmpty()) {
+            for (unsigned countdown = minimumNumberOfScansBetweenRebalance; !m_stack.isEmpty() && countdown--;)
+                visitChildren(*this, m_stack.removeLast(), jsFinalObjectVPtr, jsArrayVPtr, jsStringVPtr);
+            donateKnownParallel();
+        }
+
+        mergeOpaqueRootsIfNecessary();
+        return;
+    }
+#endif
+
     while (!m_stack.isEmpty())
         visitChildren(*this, m_stack.removeLast(), jsFinalObjectVPtr, jsArrayVPtr, jsStringVPtr);
 }
 
+void SlotVisitor::drainFromShared(SharedDrainMode sharedDrainMode)
+{
+    if (m_shared.m_numberOfMarkers == 1) {
+        // Everything was already drained by the one marker there is.
+        ASSERT_UNUSED(sharedDrainMode, sharedDrainMode == MasterDrain);
+        ASSERT(m_stack.isEmpty());
+        ASSERT(m_shared.m_sharedMarkStack.isEmpty());
+        return;
+    }
+
+    {
+        MutexLocker locker(m_shared.m_markingLock);
+        m_shared.m_numberOfActiveParallelMarkers++;
+    }
+    while (true) {
+        {
+            MutexLocker locker(m_shared.m_markingLock);
+            m_shared.m_numberOfActiveParallelMarkers--;
+
+            if (sharedDrainMode == MasterDrain) {
+                // Wait until either marking has terminated, or there is work
+                // for us to do.
+                while (true) {
+                    if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                        return;
+
+                    if (!m_shared.m_sharedMarkStack.isEmpty())
+                        break;
+
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+                }
+            } else {
+                ASSERT(sharedDrainMode == SlaveDrain);
+
+                // If we were the last active marker, let the master know that
+                // marking has terminated.
+                if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                    m_shared.m_markingCondition.broadcast();
+
+                while (m_shared.m_sharedMarkStack.isEmpty() && !m_shared.m_parallelMarkersShouldExit)
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+
+                // The heap is being destroyed.
+                if (m_shared.m_parallelMarkersShouldExit)
+                    return;
+            }
+
+            m_stack.stealSomeCellsFrom(m_shared.m_sharedMarkStack, m_shared.m_numberOfMarkers);
+            m_shared.m_numberOfActiveParallelMarkers++;
+        }
+
+        drain();
+    }
+}
+
 void SlotVisitor::harvestWeakReferences()
 {
-    while (m_firstWeakReferenceHarvester) {
-        WeakReferenceHarvester* current = m_firstWeakReferenceHarvester;
+    while (m_shared.m_firstWeakReferenceHarvester) {
+        WeakReferenceHarvester* current = m_shared.m_firstWeakReferenceHarvester;
         WeakReferenceHarvester* next = reinterpret_cast<WeakReferenceHarvester*>(current->m_nextAndFlag & ~1);
         current->m_nextAndFlag = 0;
-        m_firstWeakReferenceHarvester = next;
+        m_shared.m_firstWeakReferenceHarvester = next;
         current->visitWeakReferences(*this);
     }
 }
@@ -37,6 +37,7 @@
 #include <wtf/Noncopyable.h>
 #include <wtf/OSAllocator.h>
 #include <wtf/PageBlock.h>
+#include <wtf/Threading.h>
 
 namespace JSC {
 
@@ -44,6 +45,7 @@ namespace JSC {
     class JSGlobalData;
     class MarkStack;
     class Register;
+    class SlotVisitor;
     template<typename T> class WriteBarrierBase;
     template<typename T> class JITWriteBarrier;
     
@@ -58,9 +60,15 @@ namespace JSC {
         const JSCell* removeLast();
 
         bool isEmpty();
+        size_t size();
 
         void shrinkAllocation(size_t);
 
+        // Work distribution between parallel markers. Both sides of a transfer
+        // must be protected by the caller.
+        void donateSomeCellsTo(MarkStackArray& other);
+        void stealSomeCellsFrom(MarkStackArray& other, size_t numberOfMarkers);
+
     private:
         const JSCell** m_data;
         size_t m_top;
@@ -68,6 +76,49 @@ namespace JSC {
         size_t m_allocated;
     };
 
+    // State that every SlotVisitor of a heap works against: the mark stack that
+    // markers donate to and steal from, the marking threads themselves, and
+    // the results that must be seen as a whole once marking is done.
+    class MarkStackThreadSharedData {
+        WTF_MAKE_NONCOPYABLE(MarkStackThreadSharedData);
+    public:
+        MarkStackThreadSharedData(JSGlobalData*);
+        ~MarkStackThreadSharedData();
+
+        // Marking threads are started on the first collection, so that heaps
+        // which never collect do not pay for them.
+        void startMarkingThreadsIfNecessary();
+        unsigned numberOfMarkers() const { return m_numberOfMarkers; }
+
+        void reset();
+
+    private:
+        friend class MarkStack;
+        friend class SlotVisitor;
+
+#if ENABLE(PARALLEL_GC)
+        void markingThreadMain();
+        static void* markingThreadStartFunc(void* heap);
+#endif
+
+        JSGlobalData* m_globalData;
+        unsigned m_numberOfMarkers;
+
+        Vector<ThreadIdentifier> m_markingThreads;
+
+        Mutex m_markingLock;
+        ThreadCondition m_markingCondition;
+        MarkStackArray m_sharedMarkStack;
+        unsigned m_numberOfActiveParallelMarkers;
+        bool m_parallelMarkersShouldExit;
+
+        Mutex m_opaqueRootsLock;
+        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
+
+        Mutex m_weakReferenceHarvesterLock;
+        WeakReferenceHarvester* m_firstWeakReferenceHarvester;
+    };
+
     class MarkStack {
         WTF_MAKE_NONCOPYABLE(MarkStack);
         friend class HeapRootVisitor; // Allowed to mark a JSValue* or JSCell** directly.
@@ -76,7 +127,7 @@ namespace JSC {
         static void* allocateStack(size_t);
         static void releaseStack(void*, size_t);
 
-        MarkStack(void* jsArrayVPtr, void* jsFinalObjectVPtr, void* jsStringVPtr);
+        MarkStack(MarkStackThreadSharedData&);
         ~MarkStack();
 
         void append(ConservativeRoots&);
@@ -84,11 +135,18 @@ namespace JSC {
         template<typename T> void append(JITWriteBarrier<T>*);
         template<typename T> void append(WriteBarrierBase<T>*);
         void appendValues(WriteBarrierBase<Unknown>*, size_t count);
+
+#if ENABLE(GGC)
+        // Queues a cell that is already marked so that its children get
+        // visited again. Young collections use this to retrace old cells
+        // that may have come to point at young ones.
+        void appendMarkedCell(JSCell*);
+#endif
         
         template<typename T>
         void appendUnbarrieredPointer(T**);
         
-        bool addOpaqueRoot(void*);
+        void addOpaqueRoot(void*);
         bool containsOpaqueRoot(void*);
         int opaqueRootCount();
 
@@ -100,17 +158,15 @@ namespace JSC {
         VTableSpectrum m_visitedTypeCounts;
 #endif
 
-        void addWeakReferenceHarvester(WeakReferenceHarvester* weakReferenceHarvester)
-        {
-            if (weakReferenceHarvester->m_nextAndFlag & 1)
-                return;
-            weakReferenceHarvester->m_nextAndFlag = reinterpret_cast<uintptr_t>(m_firstWeakReferenceHarvester) | 1;
-            m_firstWeakReferenceHarvester = weakReferenceHarvester;
-        }
+        void addWeakReferenceHarvester(WeakReferenceHarvester*);
 
     protected:
         static void validate(JSCell*);
 
+        void mergeOpaqueRoots();
+        void mergeOpaqueRootsIfNecessary();
+        void mergeOpaqueRootsIfProfitable();
+
         void append(JSValue*);
         void append(JSValue*, size_t count);
         void append(JSCell**);
@@ -122,8 +178,9 @@ namespace JSC {
         void* m_jsArrayVPtr;
         void* m_jsFinalObjectVPtr;
         void* m_jsStringVPtr;
-        HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
-        WeakReferenceHarvester* m_firstWeakReferenceHarvester;
+        HashSet<void*> m_opaqueRoots; // Roots found by this visitor that are not yet in the shared set.
+
+        MarkStackThreadSharedData& m_shared;
         
 #if !ASSERT_DISABLED
     public:
@@ -134,37 +191,52 @@ namespace JSC {
         size_t m_visitCount;
     };
 
-    inline MarkStack::MarkStack(void* jsArrayVPtr, void* jsFinalObjectVPtr, void* jsStringVPtr)
-        : m_jsArrayVPtr(jsArrayVPtr)
-        , m_jsFinalObjectVPtr(jsFinalObjectVPtr)
-        , m_jsStringVPtr(jsStringVPtr)
-        , m_firstWeakReferenceHarvester(0)
-#if !ASSERT_DISABLED
-        , m_isCheckingForDefaultMarkViolation(false)
-        , m_isDraining(false)
-#endif
-        , m_visitCount(0)
-    {
-    }
-
     inline MarkStack::~MarkStack()
     {
         ASSERT(m_stack.isEmpty());
     }
 
-    inline bool MarkStack::addOpaqueRoot(void* root)
+    inline void MarkStack::addOpaqueRoot(void* root)
     {
-        return m_opaqueRoots.add(root).second;
+        if (m_shared.m_numberOfMarkers == 1) {
+            // Nobody else is marking, so there is nothing to lock against.
+            m_shared.m_opaqueRoots.add(root);
+            return;
+        }
+
+        // Collect locally and merge in batches, so that the shared set's lock
+        // is not taken once per DOM wrapper.
+        mergeOpaqueRootsIfProfitable();
+        m_opaqueRoots.add(root);
     }
 
+    // Only meaningful once marking has reached termination, when every
+    // visitor's roots have been merged into the shared set.
     inline bool MarkStack::containsOpaqueRoot(void* root)
     {
-        return m_opaqueRoots.contains(root);
+        ASSERT(m_opaqueRoots.isEmpty());
+        return m_shared.m_opaqueRoots.contains(root);
     }
 
     inline int MarkStack::opaqueRootCount()
     {
-        return m_opaqueRoots.size();
+        ASSERT(m_opaqueRoots.isEmpty());
+        return m_shared.m_opaqueRoots.size();
+    }
+
+    inline void MarkStack::mergeOpaqueRootsIfNecessary()
+    {
+        if (m_opaqueRoots.isEmpty())
+            return;
+        mergeOpaqueRoots();
+    }
+
+    inline void MarkStack::mergeOpaqueRootsIfProfitable()
+    {
+        static const int mergeThreshold = 100;
+        if (static_cast<int>(m_opaqueRoots.size()) < mergeThreshold)
+            return;
+        mergeOpaqueRoots();
     }
 
     inline void* MarkStack::allocateStack(size_t size)
@@ -195,6 +267,11 @@ namespace JSC {
         return !m_top;
     }
 
+    inline size_t MarkStackArray::size()
+    {
+        return m_top;
+    }
+
     ALWAYS_INLINE void MarkStack::append(JSValue* slot, size_t count)
     {
         for (size_t i = 0; i < count; ++i) {
@@ -226,6 +303,13 @@ namespace JSC {
         internalAppend(*slot);
     }
 
+#if ENABLE(GGC)
+    inline void MarkStack::appendMarkedCell(JSCell* cell)
+    {
+        m_stack.append(cell);
+    }
+#endif
+
     ALWAYS_INLINE void MarkStack::internalAppend(JSValue value)
     {
         ASSERT(value);
@@ -234,8 +318,6 @@ namespace JSC {
         internalAppend(value.asCell());
     }
 
-    class SlotVisitor;
-
 } // namespace JSC
 
 #endif
@@ -69,7 +69,7 @@ namespace JSC {
         // Ensure natural alignment for native types whilst recognizing that the smallest
         // object the heap will commonly allocate is four words.
         static const size_t atomSize = 4 * sizeof(void*);
-        static const size_t atomShift = 5;
+        static const size_t atomShift = sizeof(void*) == 8 ? 5 : 4; // log2(atomSize); the JIT's write barrier filter depends on it.
         static const size_t blockSize = 16 * KB;
         static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
 
@@ -104,6 +104,10 @@ namespace JSC {
         enum SweepMode { SweepOnly, SweepToFreeList };
         FreeCell* sweep(SweepMode = SweepOnly);
 
+        // True for a block that came out of the last collection with dead
+        // cells whose destructors have not run yet.
+        bool needsSweeping();
+
         // While allocating from a free list, MarkedBlock temporarily has bogus
         // cell liveness data. To restore accurate cell liveness data, call one
         // of these functions:
@@ -207,6 +211,11 @@ namespace JSC {
         return m_heap;
     }
 
+    inline bool MarkedBlock::needsSweeping()
+    {
+        return m_state == Marked;
+    }
+
     inline void MarkedBlock::didConsumeFreeList()
     {
         HEAP_LOG_BLOCK_STATE_TRANSITION(this);
@@ -221,6 +230,10 @@ namespace JSC {
 
         ASSERT(m_state != New && m_state != FreeListed);
         m_marks.clearAll();
+#if ENABLE(GGC)
+        // A full collection traces everything, so no card needs revisiting.
+        m_cards.clearAll();
+#endif
 
         // This will become true at the end of the mark phase. We set it now to
         // avoid an extra pass to do so later.
@@ -254,6 +267,7 @@ namespace JSC {
 
     inline size_t MarkedBlock::atomNumber(const void* p)
     {
+        COMPILE_ASSERT(1 << atomShift == atomSize, MarkedBlock_atomShift_matches_atomSize);
         return (reinterpret_cast<Bits>(p) - reinterpret_cast<Bits>(this)) / atomSize;
     }
 
@@ -264,7 +278,11 @@ namespace JSC {
 
     inline bool MarkedBlock::testAndSetMarked(const void* p)
     {
+#if ENABLE(PARALLEL_GC)
+        return m_marks.concurrentTestAndSet(atomNumber(p));
+#else
         return m_marks.testAndSet(atomNumber(p));
+#endif
     }
 
     inline void MarkedBlock::setMarked(const void* p)
@@ -33,15 +33,42 @@ namespace JSC {
 class SlotVisitor : public MarkStack {
     friend class HeapRootVisitor;
 public:
-    SlotVisitor(void* jsArrayVPtr, void* jsFinalObjectVPtr, void* jsStringVPtr);
+    SlotVisitor(MarkStackThreadSharedData&);
 
+    // Offers part of the local stack to idle markers, if there are any.
+    void donate();
     void drain();
+    void donateAndDrain();
+
+    enum SharedDrainMode { SlaveDrain, MasterDrain };
+    // Takes part in marking until the shared stack is exhausted and every
+    // other marker is idle (MasterDrain), or until the heap shuts the
+    // marking threads down (SlaveDrain).
+    void drainFromShared(SharedDrainMode);
+
     void harvestWeakReferences();
+
+private:
+    void donateKnownParallel();
 };
 
-inline SlotVisitor::SlotVisitor(void* jsArrayVPtr, void* jsFinalObjectVPtr, void* jsStringVPtr)
-    : MarkStack(jsArrayVPtr, jsFinalObjectVPtr, jsStringVPtr)
+inline SlotVisitor::SlotVisitor(MarkStackThreadSharedData& shared)
+    : MarkStack(shared)
+{
+}
+
+inline void SlotVisitor::donate()
+{
+    if (m_shared.m_numberOfMarkers == 1)
+        return;
+
+    donateKnownParallel();
+}
+
+inline void SlotVisitor::donateAndDrain()
 {
+    donate();
+    drain();
 }
 
 } // namespace JSC
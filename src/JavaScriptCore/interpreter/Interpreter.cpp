@@ -69,6 +69,10 @@
 #include "JIT.h"
 #endif
 
+#if ENABLE(BACKGROUND_JIT)
+#include "BackgroundJIT.h"
+#endif
+
 #define WTF_USE_GCC_COMPUTED_GOTO_WORKAROUND (ENABLE(COMPUTED_GOTO_INTERPRETER) && !defined(__llvm__))
 
 using namespace std;
@@ -89,6 +93,19 @@ static NEVER_INLINE JSValue concatenateStrings(ExecState* exec, Register* string
     return jsString(exec, strings, count);
 }
 
+// Whether property access caches may be written into the instruction stream.
+// While the JIT is enabled, interpreted bytecode can be read by the background
+// JIT at any time, so it is left as the bytecode generator wrote it.
+static inline bool canSpecializeInstructions(CallFrame* callFrame)
+{
+#if ENABLE(BACKGROUND_JIT)
+    return !callFrame->globalData().canUseJIT();
+#else
+    UNUSED_PARAM(callFrame);
+    return true;
+#endif
+}
+
 NEVER_INLINE bool Interpreter::resolve(CallFrame* callFrame, Instruction* vPC, JSValue& exceptionValue)
 {
     int dst = vPC[1].u.operand;
@@ -176,7 +193,7 @@ NEVER_INLINE bool Interpreter::resolveGlobal(CallFrame* callFrame, Instruction*
     PropertySlot slot(globalObject);
     if (globalObject->getPropertySlot(callFrame, ident, slot)) {
         JSValue result = slot.getValue(callFrame, ident);
-        if (slot.isCacheableValue() && !globalObject->structure()->isUncacheableDictionary() && slot.slotBase() == globalObject) {
+        if (slot.isCacheableValue() && !globalObject->structure()->isUncacheableDictionary() && slot.slotBase() == globalObject && canSpecializeInstructions(callFrame)) {
             vPC[3].u.structure.set(callFrame->globalData(), codeBlock->ownerExecutable(), globalObject->structure());
             vPC[4] = slot.cachedOffset();
             callFrame->uncheckedR(dst) = JSValue(result);
@@ -251,7 +268,7 @@ NEVER_INLINE bool Interpreter::resolveGlobalDynamic(CallFrame* callFrame, Instru
     PropertySlot slot(globalObject);
     if (globalObject->getPropertySlot(callFrame, ident, slot)) {
         JSValue result = slot.getValue(callFrame, ident);
-        if (slot.isCacheableValue() && !globalObject->structure()->isUncacheableDictionary() && slot.slotBase() == globalObject) {
+        if (slot.isCacheableValue() && !globalObject->structure()->isUncacheableDictionary() && slot.slotBase() == globalObject && canSpecializeInstructions(callFrame)) {
             vPC[3].u.structure.set(callFrame->globalData(), codeBlock->ownerExecutable(), globalObject->structure());
             vPC[4] = slot.cachedOffset();
             ASSERT(result);
@@ -622,10 +639,12 @@ NEVER_INLINE bool Interpreter::unwindCallFrame(CallFrame*& callFrame, JSValue ex
     // inside the call instruction that triggered the exception we
     // have to subtract 1.
 #if ENABLE(JIT) && ENABLE(INTERPRETER)
-    if (callerFrame->globalData().canUseJIT())
-        bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnPC());
-    else
+    // The caller is interpreted when the JIT is disabled, and with the
+    // background JIT may be interpreted even though it has JIT code.
+    if (codeBlock->containsInstruction(callFrame->returnVPC()))
         bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnVPC()) - 1;
+    else
+        bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnPC());
 #elif ENABLE(JIT)
     bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnPC());
 #else
@@ -967,8 +986,8 @@ JSValue Interpreter::executeCall(CallFrame* callFrame, JSObject* function, CallT
 
             m_reentryDepth++;  
 #if ENABLE(JIT)
-            if (callFrame->globalData().canUseJIT())
-                result = callData.js.functionExecutable->generatedJITCodeForCall().execute(&m_registerFile, newCallFrame, callDataScopeChain->globalData);
+            if (!!newCodeBlock->getJITCode())
+                result = newCodeBlock->getJITCode().execute(&m_registerFile, newCallFrame, callDataScopeChain->globalData);
             else
 #endif
                 result = privateExecute(Normal, &m_registerFile, newCallFrame);
@@ -1065,8 +1084,8 @@ JSObject* Interpreter::executeConstruct(CallFrame* callFrame, JSObject* construc
 
             m_reentryDepth++;  
 #if ENABLE(JIT)
-            if (callFrame->globalData().canUseJIT())
-                result = constructData.js.functionExecutable->generatedJITCodeForConstruct().execute(&m_registerFile, newCallFrame, constructDataScopeChain->globalData);
+            if (!!newCodeBlock->getJITCode())
+                result = newCodeBlock->getJITCode().execute(&m_registerFile, newCallFrame, constructDataScopeChain->globalData);
             else
 #endif
                 result = privateExecute(Normal, &m_registerFile, newCallFrame);
@@ -1176,9 +1195,9 @@ JSValue Interpreter::execute(CallFrameClosure& closure)
         m_reentryDepth++;  
 #if ENABLE(JIT)
 #if ENABLE(INTERPRETER)
-        if (closure.newCallFrame->globalData().canUseJIT())
+        if (!!closure.newCallFrame->codeBlock()->getJITCode())
 #endif
-            result = closure.functionExecutable->generatedJITCodeForCall().execute(&m_registerFile, closure.newCallFrame, closure.globalData);
+            result = closure.newCallFrame->codeBlock()->getJITCode().execute(&m_registerFile, closure.newCallFrame, closure.globalData);
 #if ENABLE(INTERPRETER)
         else
 #endif
@@ -1356,7 +1375,7 @@ NEVER_INLINE ScopeChainNode* Interpreter::createExceptionScope(CallFrame* callFr
 NEVER_INLINE void Interpreter::tryCachePutByID(CallFrame* callFrame, CodeBlock* codeBlock, Instruction* vPC, JSValue baseValue, const PutPropertySlot& slot)
 {
     // Recursive invocation may already have specialized this instruction.
-    if (vPC[0].u.opcode != getOpcode(op_put_by_id))
+    if (vPC[0].u.opcode != getOpcode(op_put_by_id) || !canSpecializeInstructions(callFrame))
         return;
 
     if (!baseValue.isCell())
@@ -1371,11 +1390,17 @@ NEVER_INLINE void Interpreter::tryCachePutByID(CallFrame* callFrame, CodeBlock*
     JSCell* baseCell = baseValue.asCell();
     Structure* structure = baseCell->structure();
 
-    if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching()) {
+    if (structure->typeInfo().prohibitsPropertyCaching()) {
         vPC[0] = getOpcode(op_put_by_id_generic);
         return;
     }
 
+    if (structure->isUncacheableDictionary()) {
+        if (!asObject(baseCell)->flattenUncacheableDictionaryForCaching(callFrame->globalData()))
+            vPC[0] = getOpcode(op_put_by_id_generic);
+        return;
+    }
+
     // Cache miss: record Structure to compare against next time.
     Structure* lastStructure = vPC[4].u.structure.get();
     if (structure != lastStructure) {
@@ -1435,7 +1460,7 @@ NEVER_INLINE void Interpreter::uncachePutByID(CodeBlock*, Instruction* vPC)
 NEVER_INLINE void Interpreter::tryCacheGetByID(CallFrame* callFrame, CodeBlock* codeBlock, Instruction* vPC, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot)
 {
     // Recursive invocation may already have specialized this instruction.
-    if (vPC[0].u.opcode != getOpcode(op_get_by_id))
+    if (vPC[0].u.opcode != getOpcode(op_get_by_id) || !canSpecializeInstructions(callFrame))
         return;
 
     // FIXME: Cache property access for immediates.
@@ -1463,11 +1488,18 @@ NEVER_INLINE void Interpreter::tryCacheGetByID(CallFrame* callFrame, CodeBlock*
 
     Structure* structure = baseValue.asCell()->structure();
 
-    if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching()) {
+    if (structure->typeInfo().prohibitsPropertyCaching()) {
         vPC[0] = getOpcode(op_get_by_id_generic);
         return;
     }
 
+    // The slot offsets are stale once the object is flattened, so cache on the next access.
+    if (structure->isUncacheableDictionary()) {
+        if (!asObject(baseValue)->flattenUncacheableDictionaryForCaching(*globalData))
+            vPC[0] = getOpcode(op_get_by_id_generic);
+        return;
+    }
+
     // Cache miss
     Structure* lastStructure = vPC[4].u.structure.get();
     if (structure != lastStructure) {
@@ -1590,9 +1622,9 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         return JSValue();
     }
     
-#if ENABLE(JIT)
+#if ENABLE(JIT) && !ENABLE(BACKGROUND_JIT)
 #if ENABLE(INTERPRETER)
-    // Mixing Interpreter + JIT is not supported.
+    // Mixing Interpreter + JIT is only supported by the background JIT.
     if (callFrame->globalData().canUseJIT())
 #endif
         ASSERT_NOT_REACHED();
@@ -4220,6 +4252,16 @@ skip_id_custom_self:
             }
 
             callFrame->init(newCodeBlock, vPC + OPCODE_LENGTH(op_call), callDataScopeChain, previousCallFrame, argCount, asFunction(v));
+#if ENABLE(BACKGROUND_JIT)
+            if (!!newCodeBlock->getJITCode()) {
+                JSValue returnValue = executeJITCode(previousCallFrame, callFrame, newCodeBlock);
+                callFrame = previousCallFrame;
+                CHECK_FOR_EXCEPTION();
+                functionReturnValue = returnValue;
+                vPC += OPCODE_LENGTH(op_call);
+                NEXT_INSTRUCTION();
+            }
+#endif
             codeBlock = newCodeBlock;
             ASSERT(codeBlock == callFrame->codeBlock());
             *topCallFrameSlot = callFrame;
@@ -4390,6 +4432,16 @@ skip_id_custom_self:
             }
 
             callFrame->init(newCodeBlock, vPC + OPCODE_LENGTH(op_call_varargs), callDataScopeChain, previousCallFrame, argCount, asFunction(v));
+#if ENABLE(BACKGROUND_JIT)
+            if (!!newCodeBlock->getJITCode()) {
+                JSValue returnValue = executeJITCode(previousCallFrame, callFrame, newCodeBlock);
+                callFrame = previousCallFrame;
+                CHECK_FOR_EXCEPTION();
+                functionReturnValue = returnValue;
+                vPC += OPCODE_LENGTH(op_call_varargs);
+                NEXT_INSTRUCTION();
+            }
+#endif
             codeBlock = newCodeBlock;
             ASSERT(codeBlock == callFrame->codeBlock());
             *topCallFrameSlot = callFrame;
@@ -4564,6 +4616,18 @@ skip_id_custom_self:
         for (size_t count = codeBlock->m_numVars; i < count; ++i)
             callFrame->uncheckedR(i) = jsUndefined();
 
+#if ENABLE(BACKGROUND_JIT)
+        if (codeBlock->codeType() == FunctionCode && globalData->canUseJIT()) {
+            BackgroundJIT* backgroundJIT = globalData->backgroundJIT.get();
+            if (backgroundJIT->hasFinishedCompilations())
+                backgroundJIT->installFinishedCompilations();
+            if (codeBlock->shouldQueueForBackgroundJIT())
+                backgroundJIT->enqueue(codeBlock);
+        }
+#endif
+
+        CHECK_FOR_TIMEOUT();
+
         vPC += OPCODE_LENGTH(op_enter);
         NEXT_INSTRUCTION();
     }
@@ -4717,6 +4781,16 @@ skip_id_custom_self:
             }
 
             callFrame->init(newCodeBlock, vPC + OPCODE_LENGTH(op_construct), callDataScopeChain, previousCallFrame, argCount, asFunction(v));
+#if ENABLE(BACKGROUND_JIT)
+            if (!!newCodeBlock->getJITCode()) {
+                JSValue returnValue = executeJITCode(previousCallFrame, callFrame, newCodeBlock);
+                callFrame = previousCallFrame;
+                CHECK_FOR_EXCEPTION();
+                functionReturnValue = returnValue;
+                vPC += OPCODE_LENGTH(op_construct);
+                NEXT_INSTRUCTION();
+            }
+#endif
             codeBlock = newCodeBlock;
             *topCallFrameSlot = callFrame;
             vPC = newCodeBlock->instructions().begin();
@@ -5119,6 +5193,79 @@ skip_id_custom_self:
 #endif // ENABLE(INTERPRETER)
 }
 
+#if ENABLE(BACKGROUND_JIT)
+JSValue Interpreter::executeInterpreted(CallFrame* callFrame, CodeBlock* codeBlock)
+{
+    JSGlobalData& globalData = callFrame->globalData();
+    BackgroundJIT* backgroundJIT = globalData.backgroundJIT.get();
+    if (backgroundJIT->hasFinishedCompilations())
+        backgroundJIT->installFinishedCompilations();
+
+    // Every switch between JIT code and the interpreter nests another native
+    // call, so code that keeps switching is compiled right away.
+    if (!codeBlock->getJITCode() && m_reentryDepth >= MaxSmallThreadReentryDepth)
+        backgroundJIT->compileNow(codeBlock);
+
+    if (m_reentryDepth >= MaxSmallThreadReentryDepth && m_reentryDepth >= globalData.maxReentryDepth)
+        return checkedReturn(throwStackOverflowError(callFrame));
+
+    Register* oldEnd = m_registerFile.end();
+    int argCount = static_cast<int>(callFrame->argumentCountIncludingThis());
+    size_t registerOffset = argCount + RegisterFile::CallFrameHeaderSize;
+    if (!m_registerFile.grow(oldEnd + registerOffset))
+        return checkedReturn(throwStackOverflowError(callFrame));
+
+    CallFrame* newCallFrame = CallFrame::create(oldEnd);
+    newCallFrame->uncheckedR(0) = callFrame->hostThisValue();
+    for (int i = 1; i < argCount; ++i)
+        newCallFrame->uncheckedR(i) = callFrame->argument(i - 1);
+
+    newCallFrame = slideRegisterWindowForCall(codeBlock, &m_registerFile, newCallFrame, registerOffset, argCount);
+    if (UNLIKELY(!newCallFrame)) {
+        m_registerFile.shrink(oldEnd);
+        return checkedReturn(throwStackOverflowError(callFrame));
+    }
+
+    JSFunction* function = asFunction(callFrame->callee());
+    newCallFrame->init(codeBlock, 0, function->scope(), callFrame->addHostCallFrameFlag(), argCount, function);
+
+    TopCallFrameSetter topCallFrame(globalData, newCallFrame);
+
+    JSValue result;
+    {
+        SamplingTool::CallRecord callRecord(m_sampler.get());
+
+        m_reentryDepth++;
+        if (!!codeBlock->getJITCode())
+            result = codeBlock->getJITCode().execute(&m_registerFile, newCallFrame, &globalData);
+        else
+            result = privateExecute(Normal, &m_registerFile, newCallFrame);
+        m_reentryDepth--;
+    }
+
+    m_registerFile.shrink(oldEnd);
+    return checkedReturn(result);
+}
+
+// Runs the JIT code of a function that interpreted code called. The callee's
+// frame is already set up; it is entered as if from the host, so that JIT code
+// returns and unwinds to here rather than into the interpreted caller.
+JSValue Interpreter::executeJITCode(CallFrame* callFrame, CallFrame* newCallFrame, CodeBlock* newCodeBlock)
+{
+    JSGlobalData& globalData = callFrame->globalData();
+    if (m_reentryDepth >= MaxSmallThreadReentryDepth && m_reentryDepth >= globalData.maxReentryDepth)
+        return throwStackOverflowError(callFrame);
+
+    newCallFrame->setCallerFrame(callFrame->addHostCallFrameFlag());
+    TopCallFrameSetter topCallFrame(globalData, newCallFrame);
+
+    m_reentryDepth++;
+    JSValue result = newCodeBlock->getJITCode().execute(&m_registerFile, newCallFrame, &globalData);
+    m_reentryDepth--;
+    return result;
+}
+#endif
+
 JSValue Interpreter::retrieveArguments(CallFrame* callFrame, JSFunction* function) const
 {
     CallFrame* functionCallFrame = findFunctionCallFrame(callFrame, function);
@@ -5148,6 +5295,16 @@ JSValue Interpreter::retrieveCaller(CallFrame* callFrame, JSFunction* function)
         return jsNull();
 
     CallFrame* callerFrame = functionCallFrame->callerFrame();
+#if ENABLE(BACKGROUND_JIT)
+    // Calls between interpreted and JIT code are made as if from the host.
+    if (callerFrame->hasHostCallFrameFlag() && callerFrame != CallFrame::noCaller()) {
+        CallFrame* frame = callerFrame->removeHostCallFrameFlag();
+        if (BackgroundJIT::isInterpreterThunkFrame(frame))
+            callerFrame = frame->callerFrame();
+        else if (frame->codeBlock())
+            callerFrame = frame;
+    }
+#endif
     if (callerFrame->hasHostCallFrameFlag())
         return jsNull();
 
@@ -5165,6 +5322,14 @@ void Interpreter::retrieveLastCaller(CallFrame* callFrame, int& lineNumber, intp
     sourceURL = UString();
 
     CallFrame* callerFrame = callFrame->callerFrame();
+#if ENABLE(BACKGROUND_JIT)
+    // An interpreted function called from JIT code sits above an interpreter
+    // thunk frame, which holds the return address into the JIT caller.
+    if (callerFrame->hasHostCallFrameFlag() && callerFrame != CallFrame::noCaller() && BackgroundJIT::isInterpreterThunkFrame(callerFrame->removeHostCallFrameFlag())) {
+        callFrame = callerFrame->removeHostCallFrameFlag();
+        callerFrame = callFrame->callerFrame();
+    }
+#endif
     if (callerFrame->hasHostCallFrameFlag())
         return;
 
@@ -5173,7 +5338,9 @@ void Interpreter::retrieveLastCaller(CallFrame* callFrame, int& lineNumber, intp
         return;
     unsigned bytecodeOffset = 0;
 #if ENABLE(INTERPRETER)
-    if (!callerFrame->globalData().canUseJIT())
+#if ENABLE(JIT)
+    if (callerCodeBlock->containsInstruction(callFrame->returnVPC()))
+#endif
         bytecodeOffset = callerCodeBlock->bytecodeOffset(callFrame->returnVPC());
 #if ENABLE(JIT)
     else
@@ -116,6 +116,10 @@ namespace JSC {
         JSValue executeCall(CallFrame*, JSObject* function, CallType, const CallData&, JSValue thisValue, const ArgList&);
         JSObject* executeConstruct(CallFrame*, JSObject* function, ConstructType, const ConstructData&, const ArgList&);
         JSValue execute(EvalExecutable* evalNode, CallFrame*, JSValue thisValue, ScopeChainNode*);
+#if ENABLE(BACKGROUND_JIT)
+        // Runs the code of a function that JIT code called through an interpreter thunk.
+        JSValue executeInterpreted(CallFrame* thunkFrame, CodeBlock*);
+#endif
 
         JSValue retrieveArguments(CallFrame*, JSFunction*) const;
         JS_EXPORT_PRIVATE JSValue retrieveCaller(CallFrame*, JSFunction*) const;
@@ -159,6 +163,10 @@ namespace JSC {
 
         NEVER_INLINE bool unwindCallFrame(CallFrame*&, JSValue, unsigned& bytecodeOffset, CodeBlock*&);
 
+#if ENABLE(BACKGROUND_JIT)
+        NEVER_INLINE JSValue executeJITCode(CallFrame*, CallFrame* newCallFrame, CodeBlock* newCodeBlock);
+#endif
+
         static ALWAYS_INLINE CallFrame* slideRegisterWindowForCall(CodeBlock*, RegisterFile*, CallFrame*, size_t registerOffset, int argc);
 
         static CallFrame* findFunctionCallFrame(CallFrame*, JSFunction*);
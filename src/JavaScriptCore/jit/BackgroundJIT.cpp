@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "BackgroundJIT.h"
+
+#if ENABLE(BACKGROUND_JIT)
+
+#include "CodeBlock.h"
+#include "ExecutableAllocator.h"
+#include "Interpreter.h"
+#include "JIT.h"
+#include "JSFunction.h"
+#include "StrongInlines.h"
+
+namespace JSC {
+
+static EncodedJSValue JSC_HOST_CALL callInterpretedFunction(ExecState* exec)
+{
+    FunctionExecutable* executable = asFunction(exec->callee())->jsExecutable();
+    return JSValue::encode(exec->interpreter()->executeInterpreted(exec, &executable->generatedBytecodeForCall()));
+}
+
+static EncodedJSValue JSC_HOST_CALL constructInterpretedFunction(ExecState* exec)
+{
+    FunctionExecutable* executable = asFunction(exec->callee())->jsExecutable();
+    return JSValue::encode(exec->interpreter()->executeInterpreted(exec, &executable->generatedBytecodeForConstruct()));
+}
+
+BackgroundJIT::Compilation::Compilation(JSGlobalData& globalData, CodeBlock* codeBlock)
+    : executable(globalData, static_cast<FunctionExecutable*>(codeBlock->ownerExecutable()))
+    , codeBlock(codeBlock)
+    , kind(codeBlock->m_isConstructor ? CodeForConstruct : CodeForCall)
+{
+}
+
+BackgroundJIT::BackgroundJIT(JSGlobalData& globalData)
+    : m_globalData(globalData)
+    , m_compilerThread(0)
+    , m_compilerThreadShouldQuit(false)
+    , m_hasFinishedCompilations(false)
+{
+}
+
+BackgroundJIT::~BackgroundJIT()
+{
+    if (m_compilerThread) {
+        {
+            MutexLocker locker(m_queueLock);
+            m_compilerThreadShouldQuit = true;
+            m_queueCondition.signal();
+        }
+        waitForThreadCompletion(m_compilerThread, 0);
+    }
+
+    deleteAllValues(m_queue);
+    deleteAllValues(m_finished);
+}
+
+JITCode BackgroundJIT::interpreterThunkFor(CodeSpecializationKind kind)
+{
+    if (kind == CodeForCall) {
+        if (!m_callThunk)
+            m_callThunk = JIT::compileCTIDirectNativeCall(&m_globalData, callInterpretedFunction);
+        return JITCode::HostFunction(m_callThunk);
+    }
+    ASSERT(kind == CodeForConstruct);
+    if (!m_constructThunk)
+        m_constructThunk = JIT::compileCTIDirectNativeCall(&m_globalData, constructInterpretedFunction);
+    return JITCode::HostFunction(m_constructThunk);
+}
+
+void BackgroundJIT::enqueue(CodeBlock* codeBlock)
+{
+    ASSERT(!codeBlock->getJITCode());
+    // The compiler thread records call return offsets in the code block's rare
+    // data, which the interpreter may otherwise create at the same time.
+    codeBlock->createRareDataForBackgroundJIT();
+    Compilation* compilation = new Compilation(m_globalData, codeBlock);
+
+    MutexLocker locker(m_queueLock);
+    if (!m_compilerThread) {
+        m_compilerThread = createThread(compilerThreadStartFunc, this, "JavaScriptCore::BackgroundJIT");
+        ASSERT(m_compilerThread);
+    }
+    m_queue.append(compilation);
+    m_queueCondition.signal();
+}
+
+bool BackgroundJIT::isQueuedOrFinished(FunctionExecutable* executable)
+{
+    MutexLocker locker(m_queueLock);
+    for (size_t i = 0; i < m_queue.size(); ++i) {
+        if (m_queue[i]->executable.get() == executable)
+            return true;
+    }
+    for (size_t i = 0; i < m_finished.size(); ++i) {
+        if (m_finished[i]->executable.get() == executable)
+            return true;
+    }
+    return false;
+}
+
+void BackgroundJIT::cancel(FunctionExecutable* executable)
+{
+    // Executables that were never queued are the common case, and are also
+    // what the collector finalizes while it holds the compilation lock.
+    if (!isQueuedOrFinished(executable))
+        return;
+
+    Vector<Compilation*> cancelled;
+    {
+        MutexLocker compilationLocker(m_compilationLock);
+        MutexLocker locker(m_queueLock);
+        for (size_t i = m_queue.size(); i--;) {
+            if (m_queue[i]->executable.get() == executable) {
+                cancelled.append(m_queue[i]);
+                m_queue.remove(i);
+            }
+        }
+        for (size_t i = m_finished.size(); i--;) {
+            if (m_finished[i]->executable.get() == executable) {
+                cancelled.append(m_finished[i]);
+                m_finished.remove(i);
+            }
+        }
+        m_hasFinishedCompilations = !m_finished.isEmpty();
+    }
+    // Strong handles are released on this thread, outside the locks.
+    deleteAllValues(cancelled);
+}
+
+void BackgroundJIT::compileNow(CodeBlock* codeBlock)
+{
+    {
+        MutexLocker compilationLocker(m_compilationLock);
+        MutexLocker locker(m_queueLock);
+        for (size_t i = 0; i < m_queue.size(); ++i) {
+            if (m_queue[i]->codeBlock == codeBlock) {
+                // Finish it here instead; the executable is still referenced by the caller.
+                delete m_queue[i];
+                m_queue.remove(i);
+                break;
+            }
+        }
+    }
+    installFinishedCompilations();
+    if (!!codeBlock->getJITCode())
+        return;
+
+    Compilation compilation(m_globalData, codeBlock);
+    compilation.jitCode = JIT::compile(&m_globalData, codeBlock, &compilation.jitCodeWithArityCheck);
+    install(&compilation);
+}
+
+void BackgroundJIT::install(Compilation* compilation)
+{
+    if (!compilation->jitCode) {
+        // The compiler thread declined; give the function another warm-up.
+        compilation->codeBlock->resetInterpretedEntryCount();
+        return;
+    }
+    compilation->executable->installJITCodeFor(compilation->kind, compilation->jitCode, compilation->jitCodeWithArityCheck);
+}
+
+void BackgroundJIT::installFinishedCompilations()
+{
+    Vector<Compilation*> finished;
+    {
+        MutexLocker locker(m_queueLock);
+        finished.swap(m_finished);
+        m_hasFinishedCompilations = false;
+    }
+    for (size_t i = 0; i < finished.size(); ++i) {
+        install(finished[i]);
+        delete finished[i];
+    }
+}
+
+bool BackgroundJIT::isInterpreterThunkFrame(ExecState* frame)
+{
+    if (frame->codeBlock())
+        return false;
+    JSObject* callee = frame->callee();
+    return callee && callee->inherits(&JSFunction::s_info) && !asFunction(callee)->isHostFunction();
+}
+
+void* BackgroundJIT::compilerThreadStartFunc(void* backgroundJIT)
+{
+    static_cast<BackgroundJIT*>(backgroundJIT)->compilerThreadMain();
+    return 0;
+}
+
+void BackgroundJIT::compilerThreadMain()
+{
+    while (true) {
+        {
+            MutexLocker locker(m_queueLock);
+            while (m_queue.isEmpty() && !m_compilerThreadShouldQuit)
+                m_queueCondition.wait(m_queueLock);
+            if (m_compilerThreadShouldQuit)
+                return;
+        }
+
+        MutexLocker compilationLocker(m_compilationLock);
+        Compilation* compilation;
+        {
+            MutexLocker locker(m_queueLock);
+            // The main thread may have cancelled or taken over the compilation
+            // while this thread was waiting for the lock.
+            if (m_queue.isEmpty())
+                continue;
+            compilation = m_queue.first();
+            m_queue.remove(0);
+        }
+
+        // Running out of executable memory means throwing code away, which only
+        // the main thread can do.
+        if (!ExecutableAllocator::underMemoryPressure())
+            compilation->jitCode = JIT::compile(&m_globalData, compilation->codeBlock, &compilation->jitCodeWithArityCheck);
+
+        MutexLocker locker(m_queueLock);
+        m_finished.append(compilation);
+        m_hasFinishedCompilations = true;
+    }
+}
+
+} // namespace JSC
+
+#endif // ENABLE(BACKGROUND_JIT)
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BackgroundJIT_h
+#define BackgroundJIT_h
+
+#if ENABLE(BACKGROUND_JIT)
+
+#include "Executable.h"
+#include "JITCode.h"
+#include "Strong.h"
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+    class CodeBlock;
+    class ExecState;
+    class JSGlobalData;
+
+    // Compiles hot interpreted functions with the baseline JIT on a thread of
+    // its own. Function code without loops starts out in the interpreter: its
+    // executable's JIT entry points are thunks that run the bytecode, so JIT
+    // callers need not know which tier their callee is in. The interpreter
+    // queues a function once it has been entered often enough, and finished
+    // code is installed on the main thread the next time an interpreted
+    // function is entered.
+    //
+    // The compiler thread only reads a code block's bytecode and fills in its
+    // JIT side tables. Bytecode is not rewritten by the interpreter while the
+    // JIT is enabled, the garbage collector takes compilationLock() before it
+    // visits code blocks, and the executable stays alive until its compilation
+    // has been installed or cancelled.
+    class BackgroundJIT {
+        WTF_MAKE_NONCOPYABLE(BackgroundJIT); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        static PassOwnPtr<BackgroundJIT> create(JSGlobalData& globalData)
+        {
+            return adoptPtr(new BackgroundJIT(globalData));
+        }
+
+        ~BackgroundJIT();
+
+        // The JIT code of a function that is still being interpreted.
+        JITCode interpreterThunkFor(CodeSpecializationKind);
+
+        void enqueue(CodeBlock*);
+
+        // Waits out or drops any compilation of the executable's code, which is
+        // about to be thrown away.
+        void cancel(FunctionExecutable*);
+
+        // Compiles the code block on the calling thread, unless its code is
+        // already installed.
+        void compileNow(CodeBlock*);
+
+        bool hasFinishedCompilations() const { return m_hasFinishedCompilations; }
+        void installFinishedCompilations();
+
+        Mutex& compilationLock() { return m_compilationLock; }
+
+        // Whether the frame belongs to an interpreter thunk, which sits between
+        // a JIT caller and the interpreted frame of its callee.
+        static bool isInterpreterThunkFrame(ExecState*);
+
+    private:
+        BackgroundJIT(JSGlobalData&);
+
+        struct Compilation {
+            WTF_MAKE_FAST_ALLOCATED;
+        public:
+            Compilation(JSGlobalData&, CodeBlock*);
+
+            Strong<FunctionExecutable> executable;
+            CodeBlock* codeBlock;
+            CodeSpecializationKind kind;
+            JITCode jitCode;
+            MacroAssemblerCodePtr jitCodeWithArityCheck;
+        };
+
+        bool isQueuedOrFinished(FunctionExecutable*);
+        void install(Compilation*);
+
+        static void* compilerThreadStartFunc(void*);
+        void compilerThreadMain();
+
+        JSGlobalData& m_globalData;
+
+        MacroAssemblerCodeRef m_callThunk;
+        MacroAssemblerCodeRef m_constructThunk;
+
+        ThreadIdentifier m_compilerThread;
+        bool m_compilerThreadShouldQuit;
+
+        // Guards the queue and the finished list. Whoever also needs
+        // m_compilationLock takes it first.
+        Mutex m_queueLock;
+        ThreadCondition m_queueCondition;
+        Vector<Compilation*> m_queue;
+        Vector<Compilation*> m_finished;
+        volatile bool m_hasFinishedCompilations;
+
+        // Held by the compiler thread while it compiles.
+        Mutex m_compilationLock;
+    };
+
+} // namespace JSC
+
+#endif // ENABLE(BACKGROUND_JIT)
+
+#endif // BackgroundJIT_h
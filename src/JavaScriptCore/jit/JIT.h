@@ -254,6 +254,16 @@ namespace JSC {
             return jit.privateCompileCTINativeCall(globalData, func);
         }
 
+#if ENABLE(BACKGROUND_JIT)
+        // Unlike compileCTINativeCall(), which may return the shared thunk that finds its target
+        // through the callee's NativeExecutable, the returned code always calls func directly.
+        static CodeRef compileCTIDirectNativeCall(JSGlobalData* globalData, NativeFunction func)
+        {
+            JIT jit(globalData, 0);
+            return jit.privateCompileCTIDirectNativeCall(globalData, func);
+        }
+#endif
+
         static void patchGetByIdSelf(CodeBlock* codeblock, StructureStubInfo*, Structure*, size_t cachedOffset, ReturnAddressPtr returnAddress);
         static void patchPutByIdReplace(CodeBlock* codeblock, StructureStubInfo*, Structure*, size_t cachedOffset, ReturnAddressPtr returnAddress, bool direct);
         static void patchMethodCallProto(JSGlobalData&, CodeBlock* codeblock, MethodCallLinkInfo&, JSObject*, Structure*, JSObject*, ReturnAddressPtr);
@@ -294,6 +304,9 @@ namespace JSC {
         PassRefPtr<ExecutableMemoryHandle> privateCompileCTIMachineTrampolines(JSGlobalData*, TrampolineStructure*);
         Label privateCompileCTINativeCall(JSGlobalData*, bool isConstruct = false);
         CodeRef privateCompileCTINativeCall(JSGlobalData*, NativeFunction);
+#if ENABLE(BACKGROUND_JIT)
+        CodeRef privateCompileCTIDirectNativeCall(JSGlobalData*, NativeFunction);
+#endif
         void privateCompilePatchGetArrayLength(ReturnAddressPtr returnAddress);
 
         void addSlowCase(Jump);
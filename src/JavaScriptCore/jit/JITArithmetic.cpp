@@ -716,8 +716,14 @@ void JIT::emit_op_mod(Instruction* currentInstruction)
     emitJumpSlowCaseIfNotImmediateInteger(regT2);
 
     addSlowCase(branchPtr(Equal, regT2, TrustedImmPtr(JSValue::encode(jsNumber(0)))));
+    addSlowCase(branch32(Equal, regT0, TrustedImm32(0x80000000))); // -2147483648 / -1 => EXC_ARITHMETIC
+    move(regT0, regT3); // Save dividend payload, in case of 0.
     m_assembler.cdq();
     m_assembler.idivl_r(regT2);
+    // If the remainder is zero and the dividend is negative, the result is -0.
+    Jump nonZeroResult = branchTest32(NonZero, regT1);
+    addSlowCase(branchTest32(NonZero, regT3, TrustedImm32(0x80000000)));
+    nonZeroResult.link(this);
     emitFastArithReTagImmediate(regT1, regT0);
     emitPutVirtualRegister(result);
 }
@@ -725,13 +731,18 @@ void JIT::emit_op_mod(Instruction* currentInstruction)
 void JIT::emitSlow_op_mod(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned result = currentInstruction[1].u.operand;
+    unsigned op1 = currentInstruction[2].u.operand;
+    unsigned op2 = currentInstruction[3].u.operand;
 
     linkSlowCase(iter);
     linkSlowCase(iter);
     linkSlowCase(iter);
+    linkSlowCase(iter);
+    linkSlowCase(iter);
+    // The negative zero check comes after idiv has clobbered regT0, so reload the operands.
     JITStubCall stubCall(this, cti_op_mod);
-    stubCall.addArgument(regT0);
-    stubCall.addArgument(regT2);
+    stubCall.addArgument(op1, regT2);
+    stubCall.addArgument(op2, regT2);
     stubCall.call(result);
 }
 
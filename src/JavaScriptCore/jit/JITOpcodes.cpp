@@ -298,6 +298,65 @@ JIT::CodeRef JIT::privateCompileCTINativeCall(JSGlobalData* globalData, NativeFu
     return CodeRef::createSelfManagedCodeRef(globalData->jitStubs->ctiNativeCall());
 }
 
+#if ENABLE(BACKGROUND_JIT)
+JIT::CodeRef JIT::privateCompileCTIDirectNativeCall(JSGlobalData* globalData, NativeFunction func)
+{
+    emitPutImmediateToCallFrameHeader(0, RegisterFile::CodeBlock);
+
+#if CPU(X86_64)
+    // Load caller frame's scope chain into this callframe so that whatever we call can
+    // get to its global data.
+    emitGetFromCallFrameHeaderPtr(RegisterFile::CallerFrame, regT0);
+    emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, regT1, regT0);
+    emitPutCellToCallFrameHeader(regT1, RegisterFile::ScopeChain);
+
+    peek(regT1);
+    emitPutToCallFrameHeader(regT1, RegisterFile::ReturnPC);
+
+    // Calling convention:      f(edi, esi, edx, ecx, ...);
+    // Host function signature: f(ExecState*);
+    move(callFrameRegister, X86Registers::edi);
+
+    subPtr(TrustedImm32(16 - sizeof(void*)), stackPointerRegister); // Align stack after call.
+
+    move(regT0, callFrameRegister); // Eagerly restore caller frame register to avoid loading from stack.
+    Call nativeCall = call();
+
+    addPtr(TrustedImm32(16 - sizeof(void*)), stackPointerRegister);
+#else
+#error "The background JIT is not supported on this platform."
+#endif
+
+    // Check for an exception
+    loadPtr(&(globalData->exception), regT2);
+    Jump exceptionHandler = branchTestPtr(NonZero, regT2);
+
+    // Return.
+    ret();
+
+    // Handle an exception
+    exceptionHandler.link(this);
+
+    // Grab the return address.
+    preserveReturnAddressAfterCall(regT1);
+
+    move(TrustedImmPtr(&globalData->exceptionLocation), regT2);
+    storePtr(regT1, regT2);
+    poke(callFrameRegister, OBJECT_OFFSETOF(struct JITStackFrame, callFrame) / sizeof(void*));
+
+    storePtr(callFrameRegister, &globalData->topCallFrame);
+    // Set the return address.
+    move(TrustedImmPtr(FunctionPtr(ctiVMThrowTrampoline).value()), regT1);
+    restoreReturnAddressBeforeReturn(regT1);
+
+    ret();
+
+    LinkBuffer patchBuffer(*globalData, this);
+    patchBuffer.link(nativeCall, FunctionPtr(func));
+    return patchBuffer.finalizeCode();
+}
+#endif
+
 void JIT::emit_op_mov(Instruction* currentInstruction)
 {
     int dst = currentInstruction[1].u.operand;
@@ -1124,6 +1183,9 @@ void JIT::emit_op_enter(Instruction*)
     for (size_t j = 0; j < count; ++j)
         emitInitRegister(j);
 
+    // Count calls as well as loop iterations, so time spent in functions
+    // without loops is still seen by the watchdog and the sampling profiler.
+    emitTimeoutCheck();
 }
 
 void JIT::emit_op_create_activation(Instruction* currentInstruction)
@@ -1401,6 +1401,10 @@ void JIT::emit_op_enter(Instruction*)
     // object lifetime and increasing GC pressure.
     for (int i = 0; i < m_codeBlock->m_numVars; ++i)
         emitStore(i, jsUndefined());
+
+    // Count calls as well as loop iterations, so time spent in functions
+    // without loops is still seen by the watchdog and the sampling profiler.
+    emitTimeoutCheck();
 }
 
 void JIT::emit_op_create_activation(Instruction* currentInstruction)
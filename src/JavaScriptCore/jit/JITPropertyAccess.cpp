@@ -222,7 +222,11 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
 
     end.link(this);
 
-    emitWriteBarrier(regT0, regT3, regT1, regT3, ShouldFilterImmediates, WriteBarrierForPropertyAccess);
+    // Only cells need the collector to look at the vector again.
+    Jump notCell = emitJumpIfNotJSCell(regT3);
+    store32(TrustedImm32(1), Address(regT2, OBJECT_OFFSETOF(ArrayStorage, m_vectorMayContainCells)));
+    emitWriteBarrier(regT0, regT3, regT1, regT3, UnconditionalWriteBarrier, WriteBarrierForPropertyAccess);
+    notCell.link(this);
 }
 
 void JIT::emitSlow_op_put_by_val(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
@@ -1048,14 +1052,21 @@ void JIT::emitWriteBarrier(RegisterID owner, RegisterID value, RegisterID scratc
     
 #if ENABLE(GGC)
     Jump filterCells;
-    if (mode == ShouldFilterImmediates)
+    if (mode == ShouldFilterImmediates) {
+#if USE(JSVALUE64)
         filterCells = emitJumpIfNotJSCell(value);
+#else
+        // On JSVALUE32_64 the value register holds the tag.
+        filterCells = branch32(NotEqual, value, TrustedImm32(JSValue::CellTag));
+#endif
+    }
     move(owner, scratch);
     andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch);
     move(owner, scratch2);
-    // consume additional 8 bits as we're using an approximate filter
-    rshift32(TrustedImm32(MarkedBlock::atomShift + 8), scratch2);
-    andPtr(TrustedImm32(MarkedBlock::atomMask >> 8), scratch2);
+    // Test the byte of the mark bitmap that holds the owner's bit. This is an
+    // approximate filter: it lets through owners whose neighbours are marked.
+    rshift32(TrustedImm32(MarkedBlock::atomShift + 3), scratch2);
+    andPtr(TrustedImm32(MarkedBlock::atomMask >> 3), scratch2);
     Jump filter = branchTest8(Zero, BaseIndex(scratch, scratch2, TimesOne, MarkedBlock::offsetOfMarks()));
     move(owner, scratch2);
     rshift32(TrustedImm32(MarkedBlock::cardShift), scratch2);
@@ -1081,8 +1092,13 @@ void JIT::emitWriteBarrier(JSCell* owner, RegisterID value, RegisterID scratch,
     
 #if ENABLE(GGC)
     Jump filterCells;
-    if (mode == ShouldFilterImmediates)
+    if (mode == ShouldFilterImmediates) {
+#if USE(JSVALUE64)
         filterCells = emitJumpIfNotJSCell(value);
+#else
+        filterCells = branch32(NotEqual, value, TrustedImm32(JSValue::CellTag));
+#endif
+    }
     uint8_t* cardAddress = Heap::addressOfCardFor(owner);
     move(TrustedImmPtr(cardAddress), scratch);
     store8(TrustedImm32(1), Address(scratch));
@@ -266,7 +266,15 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     addSlowCase(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsArrayVPtr)));
     addSlowCase(branch32(AboveOrEqual, regT2, Address(regT0, JSArray::vectorLengthOffset())));
 
-    emitWriteBarrier(regT0, regT1, regT1, regT3, UnconditionalWriteBarrier, WriteBarrierForPropertyAccess);
+    // Only cells need the collector to look at the vector again. The barrier takes
+    // the value's tag, like the other 32_64 callers.
+    emitLoadTag(value, regT1);
+    loadPtr(Address(regT0, JSArray::storageOffset()), regT3);
+    Jump notCell = branch32(NotEqual, regT1, TrustedImm32(JSValue::CellTag));
+    store32(TrustedImm32(1), Address(regT3, OBJECT_OFFSETOF(ArrayStorage, m_vectorMayContainCells)));
+    notCell.link(this);
+    emitWriteBarrier(regT0, regT1, regT1, regT3, ShouldFilterImmediates, WriteBarrierForPropertyAccess);
+
     loadPtr(Address(regT0, JSArray::storageOffset()), regT3);
     
     Jump empty = branch32(Equal, BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)), TrustedImm32(JSValue::EmptyValueTag));
@@ -420,7 +428,7 @@ void JIT::emit_op_put_by_id(Instruction* currentInstruction)
     
     END_UNINTERRUPTED_SEQUENCE(sequencePutById);
 
-    emitWriteBarrier(regT0, regT2, regT1, regT2, ShouldFilterImmediates, WriteBarrierForPropertyAccess);
+    emitWriteBarrier(regT0, regT3, regT1, regT2, ShouldFilterImmediates, WriteBarrierForPropertyAccess);
     
     ASSERT_JIT_OFFSET_UNUSED(displacementLabel1, differenceBetween(hotPathBegin, displacementLabel1), patchOffsetPutByIdPropertyMapOffset1);
     ASSERT_JIT_OFFSET_UNUSED(displacementLabel2, differenceBetween(hotPathBegin, displacementLabel2), patchOffsetPutByIdPropertyMapOffset2);
@@ -815,11 +815,19 @@ NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* co
     JSCell* baseCell = baseValue.asCell();
     Structure* structure = baseCell->structure();
 
-    if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching()) {
+    if (structure->typeInfo().prohibitsPropertyCaching()) {
         ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
         return;
     }
 
+    // Don't let a delete on one object poison the call site for good; once the
+    // object has been flattened the next put through here can be cached.
+    if (structure->isUncacheableDictionary()) {
+        if (!asObject(baseCell)->flattenUncacheableDictionaryForCaching(callFrame->globalData()))
+            ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+        return;
+    }
+
     // If baseCell != base, then baseCell must be a proxy for another object.
     if (baseCell != slot.base()) {
         ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
@@ -883,11 +891,18 @@ NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* co
     JSCell* baseCell = baseValue.asCell();
     Structure* structure = baseCell->structure();
 
-    if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching()) {
+    if (structure->typeInfo().prohibitsPropertyCaching()) {
         ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
         return;
     }
 
+    // The slot offsets are stale once the object is flattened, so cache on the next access.
+    if (structure->isUncacheableDictionary()) {
+        if (!asObject(baseCell)->flattenUncacheableDictionaryForCaching(*globalData))
+            ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
+        return;
+    }
+
     // Cache hit: Specialize instruction and ref Structures.
 
     if (slot.slotBase() == baseValue) {
@@ -1375,6 +1390,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
+    stackFrame.globalData->inlineCacheStatistics.genericPutByIdCalls++;
     PutPropertySlot slot(stackFrame.callFrame->codeBlock()->isStrictMode());
     stackFrame.args[0].jsValue().put(stackFrame.callFrame, stackFrame.args[1].identifier(), stackFrame.args[2].jsValue(), slot);
     CHECK_FOR_EXCEPTION_AT_END();
@@ -1384,6 +1400,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
     
+    stackFrame.globalData->inlineCacheStatistics.genericPutByIdCalls++;
     PutPropertySlot slot(stackFrame.callFrame->codeBlock()->isStrictMode());
     stackFrame.args[0].jsValue().putDirect(stackFrame.callFrame, stackFrame.args[1].identifier(), stackFrame.args[2].jsValue(), slot);
     CHECK_FOR_EXCEPTION_AT_END();
@@ -1393,6 +1410,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_generic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
+    stackFrame.globalData->inlineCacheStatistics.genericGetByIdCalls++;
     CallFrame* callFrame = stackFrame.callFrame;
     Identifier& ident = stackFrame.args[1].identifier();
 
@@ -1681,7 +1699,14 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_self_fail)
 
     if (baseValue.isCell()
         && slot.isCacheable()
-        && !baseValue.asCell()->structure()->isUncacheableDictionary()
+        && baseValue.asCell()->structure()->isUncacheableDictionary()
+        && slot.slotBase() == baseValue) {
+        // Keep the structures we already have in the list; the dictionary itself is
+        // either flattened and cached next time around, or treated as a hash map.
+        if (!asObject(baseValue)->flattenUncacheableDictionaryForCaching(callFrame->globalData()))
+            ctiPatchCallByReturnAddress(callFrame->codeBlock(), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
+    } else if (baseValue.isCell()
+        && slot.isCacheable()
         && slot.slotBase() == baseValue) {
 
         CodeBlock* codeBlock = callFrame->codeBlock();
@@ -1911,6 +1936,13 @@ DEFINE_STUB_FUNCTION(void, optimize_from_loop)
     CodeBlock* codeBlock = callFrame->codeBlock();
     unsigned bytecodeIndex = stackFrame.args[0].int32();
 
+    // Optimized code has no timeout checks, so the sampling profiler would
+    // never see it. Stay in the baseline JIT while a profile is recorded.
+    if (stackFrame.globalData->samplingProfiler) {
+        codeBlock->optimizeAfterWarmUp();
+        return;
+    }
+
 #if ENABLE(JIT_VERBOSE_OSR)
     printf("Entered optimize_from_loop with executeCounter = %d, reoptimizationRetryCounter = %u, optimizationDelayCounter = %u\n", codeBlock->executeCounter(), codeBlock->reoptimizationRetryCounter(), codeBlock->optimizationDelayCounter());
 #endif
@@ -2008,6 +2040,11 @@ DEFINE_STUB_FUNCTION(void, optimize_from_ret)
     
     CallFrame* callFrame = stackFrame.callFrame;
     CodeBlock* codeBlock = callFrame->codeBlock();
+
+    if (stackFrame.globalData->samplingProfiler) {
+        codeBlock->optimizeAfterWarmUp();
+        return;
+    }
     
 #if ENABLE(JIT_VERBOSE_OSR)
     printf("Entered optimize_from_ret with executeCounter = %d, reoptimizationRetryCounter = %u, optimizationDelayCounter = %u\n", codeBlock->executeCounter(), codeBlock->reoptimizationRetryCounter(), codeBlock->optimizationDelayCounter());
@@ -3798,6 +3835,9 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, to_object)
 
 MacroAssemblerCodeRef JITThunks::ctiStub(JSGlobalData* globalData, ThunkGenerator generator)
 {
+#if ENABLE(BACKGROUND_JIT)
+    MutexLocker locker(m_ctiStubMapLock);
+#endif
     std::pair<CTIStubMap::iterator, bool> entry = m_ctiStubMap.add(generator, MacroAssemblerCodeRef());
     if (entry.second)
         entry.first->second = generator(globalData);
@@ -36,6 +36,7 @@
 #include "Register.h"
 #include "ThunkGenerators.h"
 #include <wtf/HashMap.h>
+#include <wtf/Threading.h>
 
 #if ENABLE(JIT)
 
@@ -305,6 +306,10 @@ namespace JSC {
     private:
         typedef HashMap<ThunkGenerator, MacroAssemblerCodeRef> CTIStubMap;
         CTIStubMap m_ctiStubMap;
+#if ENABLE(BACKGROUND_JIT)
+        // Baseline code compiled on the background JIT thread looks up stubs too.
+        Mutex m_ctiStubMapLock;
+#endif
         typedef HashMap<NativeFunction, Weak<NativeExecutable> > HostFunctionStubMap;
         OwnPtr<HostFunctionStubMap> m_hostFunctionStubMap;
         RefPtr<ExecutableMemoryHandle> m_executableMemory;
@@ -26,12 +26,15 @@
 #include "Completion.h"
 #include "CurrentTime.h"
 #include "ExceptionHelpers.h"
+#include "Heuristics.h"
 #include "InitializeThreading.h"
 #include "JSArray.h"
 #include "JSFunction.h"
 #include "JSLock.h"
 #include "JSString.h"
+#include "SamplingProfiler.h"
 #include "SamplingTool.h"
+#include <algorithm>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -105,11 +108,17 @@ struct Options {
     Options()
         : interactive(false)
         , dump(false)
+        , printGCPauses(false)
+        , printInlineCacheStatistics(false)
+        , samplingProfileFile(0)
     {
     }
 
     bool interactive;
     bool dump;
+    bool printGCPauses;
+    bool printInlineCacheStatistics;
+    const char* samplingProfileFile;
     Vector<Script> scripts;
     Vector<UString> arguments;
 };
@@ -517,14 +526,58 @@ static void runInteractive(GlobalObject* globalObject)
     printf("\n");
 }
 
+static void printGCPauseHistogram(const char* kind, const Vector<double>& pauseTimes)
+{
+    printf("%s GC pauses: %lu collections, %u marker(s)\n", kind, static_cast<unsigned long>(pauseTimes.size()), Heuristics::numberOfGCMarkers);
+    if (pauseTimes.isEmpty())
+        return;
+
+    Vector<double> sortedTimes(pauseTimes);
+    std::sort(sortedTimes.begin(), sortedTimes.end());
+
+    double total = 0;
+    for (size_t i = 0; i < sortedTimes.size(); ++i)
+        total += sortedTimes[i];
+    printf("  total %.2fms, mean %.2fms, median %.2fms, 90%% %.2fms, max %.2fms\n",
+        total * 1000, total * 1000 / sortedTimes.size(), sortedTimes[sortedTimes.size() / 2] * 1000,
+        sortedTimes[sortedTimes.size() * 9 / 10] * 1000, sortedTimes.last() * 1000);
+
+    // Power of two buckets in milliseconds: [0, 1), [1, 2), [2, 4) ... [256, inf).
+    const size_t numberOfBuckets = 10;
+    unsigned long buckets[numberOfBuckets] = { 0 };
+    unsigned long largestBucket = 0;
+    for (size_t i = 0; i < sortedTimes.size(); ++i) {
+        size_t bucket = 0;
+        for (double limit = 1; bucket < numberOfBuckets - 1 && sortedTimes[i] * 1000 >= limit; limit *= 2)
+            ++bucket;
+        largestBucket = std::max(largestBucket, ++buckets[bucket]);
+    }
+
+    const unsigned long barWidth = 50;
+    for (size_t bucket = 0; bucket < numberOfBuckets; ++bucket) {
+        unsigned long lowerBound = bucket ? 1ul << (bucket - 1) : 0;
+        if (bucket == numberOfBuckets - 1)
+            printf("  [%4lu,  inf) ms %6lu ", lowerBound, buckets[bucket]);
+        else
+            printf("  [%4lu, %4lu) ms %6lu ", lowerBound, 1ul << bucket, buckets[bucket]);
+        for (unsigned long i = 0; i < (buckets[bucket] * barWidth + largestBucket - 1) / largestBucket; ++i)
+            putchar('#');
+        putchar('\n');
+    }
+}
+
 static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help = false)
 {
     fprintf(stderr, "Usage: jsc [options] [files] [-- arguments]\n");
+    fprintf(stderr, "  -c         Prints how many property accesses missed the inline caches on exit\n");
     fprintf(stderr, "  -d         Dumps bytecode (debug builds only)\n");
     fprintf(stderr, "  -e         Evaluate argument as script code\n");
     fprintf(stderr, "  -f         Specifies a source file (deprecated)\n");
+    fprintf(stderr, "  -g         Prints a histogram of garbage collection pauses on exit\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -i         Enables interactive mode (default if no files are specified)\n");
+    fprintf(stderr, "  -m count   Sets the number of threads marking during garbage collection (%u by default)\n", Heuristics::numberOfGCMarkers);
+    fprintf(stderr, "  -p file    Samples the JavaScript stack every millisecond and writes folded stacks to file\n");
 #if HAVE(SIGNAL_H)
     fprintf(stderr, "  -s         Installs signal handlers that exit on a crash (Unix platforms only)\n");
 #endif
@@ -558,6 +611,29 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             options.dump = true;
             continue;
         }
+        if (!strcmp(arg, "-g")) {
+            options.printGCPauses = true;
+            continue;
+        }
+        if (!strcmp(arg, "-c")) {
+            options.printInlineCacheStatistics = true;
+            continue;
+        }
+        if (!strcmp(arg, "-m")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            int numberOfGCMarkers = atoi(argv[i]);
+            if (numberOfGCMarkers < 1)
+                printUsageStatement(globalData);
+            Heuristics::numberOfGCMarkers = numberOfGCMarkers;
+            continue;
+        }
+        if (!strcmp(arg, "-p")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            options.samplingProfileFile = argv[i];
+            continue;
+        }
         if (!strcmp(arg, "-s")) {
 #if HAVE(SIGNAL_H)
             signal(SIGILL, _exit);
@@ -589,12 +665,43 @@ int jscmain(int argc, char** argv, JSGlobalData* globalData)
 
     Options options;
     parseArguments(argc, argv, options, globalData);
+    globalData->heap.setRecordsPauseTimes(options.printGCPauses);
+
+    if (options.samplingProfileFile) {
+        globalData->samplingProfiler = SamplingProfiler::create(*globalData, 1);
+        globalData->samplingProfiler->start();
+    }
 
     GlobalObject* globalObject = GlobalObject::create(*globalData, GlobalObject::createStructure(*globalData, jsNull()), options.arguments);
     bool success = runWithScripts(globalObject, options.scripts, options.dump);
     if (options.interactive && success)
         runInteractive(globalObject);
 
+    if (options.samplingProfileFile) {
+        OwnPtr<SamplingProfiler> profiler = globalData->samplingProfiler.release();
+        profiler->stop();
+        CString stacks = profiler->foldedStacks();
+        FILE* file = fopen(options.samplingProfileFile, "w");
+        if (file) {
+            fwrite(stacks.data(), 1, stacks.length(), file);
+            fclose(file);
+        } else
+            fprintf(stderr, "Could not open file: %s\n", options.samplingProfileFile);
+    }
+
+    if (options.printGCPauses) {
+        printGCPauseHistogram("Full", globalData->heap.fullPauseTimes());
+        printGCPauseHistogram("Young", globalData->heap.youngPauseTimes());
+    }
+
+    if (options.printInlineCacheStatistics) {
+        const InlineCacheStatistics& statistics = globalData->inlineCacheStatistics;
+        printf("Generic get_by_id calls: %llu\n", static_cast<unsigned long long>(statistics.genericGetByIdCalls));
+        printf("Generic put_by_id calls: %llu\n", static_cast<unsigned long long>(statistics.genericPutByIdCalls));
+        printf("Uncacheable dictionary accesses: %llu\n", static_cast<unsigned long long>(statistics.uncacheableDictionaryAccesses));
+        printf("Dictionary flattenings: %llu\n", static_cast<unsigned long long>(statistics.dictionaryFlattenings));
+    }
+
     return success ? 0 : 3;
 }
 
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "SourceProviderCache.h"
 
+#include "Identifier.h"
 #include "SourceProviderCacheItem.h"
 
 namespace JSC {
@@ -53,4 +54,140 @@ void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCache
     m_contentByteSize += size;
 }
 
+// Bump whenever the parser changes what it stores in an item.
+static const uint32_t encodingVersion = 1;
+
+enum {
+    UsesEvalFlag = 1 << 0,
+    StrictModeFlag = 1 << 1,
+    NeedsFullActivationFlag = 1 << 2
+};
+
+template <typename T> static void append(Vector<char>& buffer, const T& value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void appendVariables(Vector<char>& buffer, const Vector<RefPtr<StringImpl> >& variables)
+{
+    append(buffer, static_cast<uint32_t>(variables.size()));
+    for (size_t i = 0; i < variables.size(); ++i) {
+        StringImpl* name = variables[i].get();
+        append(buffer, static_cast<uint32_t>(name->length()));
+        buffer.append(reinterpret_cast<const char*>(name->characters()), name->length() * sizeof(UChar));
+    }
+}
+
+void SourceProviderCache::encode(Vector<char>& buffer) const
+{
+    append(buffer, encodingVersion);
+    append(buffer, static_cast<uint32_t>(m_map.size()));
+
+    HashMap<int, SourceProviderCacheItem*>::const_iterator end = m_map.end();
+    for (HashMap<int, SourceProviderCacheItem*>::const_iterator it = m_map.begin(); it != end; ++it) {
+        const SourceProviderCacheItem* item = it->second;
+        uint8_t flags = (item->usesEval ? UsesEvalFlag : 0) | (item->strictMode ? StrictModeFlag : 0) | (item->needsFullActivation ? NeedsFullActivationFlag : 0);
+        append(buffer, static_cast<int32_t>(it->first));
+        append(buffer, static_cast<int32_t>(item->closeBraceLine));
+        append(buffer, static_cast<int32_t>(item->closeBracePos));
+        append(buffer, flags);
+        appendVariables(buffer, item->usedVariables);
+        appendVariables(buffer, item->writtenVariables);
+    }
+}
+
+class CacheDecoder {
+public:
+    CacheDecoder(const char* data, size_t size)
+        : m_position(data)
+        , m_end(data + size)
+    {
+    }
+
+    template <typename T> bool read(T& value)
+    {
+        if (static_cast<size_t>(m_end - m_position) < sizeof(value))
+            return false;
+        memcpy(&value, m_position, sizeof(value));
+        m_position += sizeof(value);
+        return true;
+    }
+
+    bool readVariables(JSGlobalData* globalData, Vector<RefPtr<StringImpl> >& variables)
+    {
+        uint32_t count;
+        if (!read(count) || count > static_cast<size_t>(m_end - m_position) / sizeof(uint32_t))
+            return false;
+        variables.reserveInitialCapacity(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t length;
+            if (!read(length) || !length || length > static_cast<size_t>(m_end - m_position) / sizeof(UChar))
+                return false;
+            Vector<UChar, 32> characters(length);
+            memcpy(characters.data(), m_position, length * sizeof(UChar));
+            m_position += length * sizeof(UChar);
+            // The parser compares variables by identity, so they have to be
+            // the identifiers it would have made itself.
+            variables.uncheckedAppend(Identifier(globalData, characters.data(), length).impl());
+        }
+        return true;
+    }
+
+    bool atEnd() const { return m_position == m_end; }
+
+private:
+    const char* m_position;
+    const char* m_end;
+};
+
+bool SourceProviderCache::decode(JSGlobalData* globalData, const char* data, size_t size, const UChar* source, int sourceLength)
+{
+    CacheDecoder decoder(data, size);
+    uint32_t version;
+    uint32_t count;
+    if (!decoder.read(version) || version != encodingVersion || !decoder.read(count))
+        return false;
+
+    Vector<std::pair<int, SourceProviderCacheItem*> > items;
+    bool isValid = true;
+    for (uint32_t i = 0; i < count && isValid; ++i) {
+        int32_t openBracePos;
+        int32_t closeBraceLine;
+        int32_t closeBracePos;
+        uint8_t flags;
+        if (!decoder.read(openBracePos) || !decoder.read(closeBraceLine) || !decoder.read(closeBracePos) || !decoder.read(flags)) {
+            isValid = false;
+            break;
+        }
+
+        // The parser jumps straight from one brace to the other, so both
+        // had better be where the item says they are.
+        if (openBracePos < 0 || closeBracePos <= openBracePos || closeBracePos >= sourceLength
+            || source[openBracePos] != '{' || source[closeBracePos] != '}' || closeBraceLine <= 0
+            || m_map.contains(openBracePos)) {
+            isValid = false;
+            break;
+        }
+
+        OwnPtr<SourceProviderCacheItem> item = adoptPtr(new SourceProviderCacheItem(closeBraceLine, closeBracePos));
+        item->usesEval = flags & UsesEvalFlag;
+        item->strictMode = flags & StrictModeFlag;
+        item->needsFullActivation = flags & NeedsFullActivationFlag;
+        isValid = decoder.readVariables(globalData, item->usedVariables) && decoder.readVariables(globalData, item->writtenVariables);
+        items.append(std::make_pair(static_cast<int>(openBracePos), item.leakPtr()));
+    }
+
+    if (!isValid || !decoder.atEnd()) {
+        for (size_t i = 0; i < items.size(); ++i)
+            delete items[i].second;
+        return false;
+    }
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        SourceProviderCacheItem* item = items[i].second;
+        add(items[i].first, adoptPtr(item), item->approximateByteSize());
+    }
+    return true;
+}
+
 }
@@ -25,9 +25,12 @@
 
 #include <wtf/HashMap.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/unicode/Unicode.h>
 
 namespace JSC {
 
+class JSGlobalData;
 class SourceProviderCacheItem;
 
 class SourceProviderCache {
@@ -40,6 +43,14 @@ public:
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
 
+    // Lets an embedder keep what the parser learned about a source across
+    // runs. Encoded data only describes the exact source it was made from;
+    // decode() checks it against that source and adds nothing if it does not
+    // fit. The variable names are made identifiers of the given JSGlobalData.
+    bool isEmpty() const { return m_map.isEmpty(); }
+    JS_EXPORT_PRIVATE void encode(Vector<char>&) const;
+    JS_EXPORT_PRIVATE bool decode(JSGlobalData*, const char* data, size_t, const UChar* source, int sourceLength);
+
 private:
     HashMap<int, SourceProviderCacheItem*> m_map;
     unsigned m_contentByteSize;
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SamplingProfiler.h"
+
+#include "BackgroundJIT.h"
+#include "CodeBlock.h"
+#include "Executable.h"
+#include "InternalFunction.h"
+#include "JSFunction.h"
+#include "JSGlobalData.h"
+#include "UStringConcatenate.h"
+
+using namespace std;
+
+namespace JSC {
+
+static const char* GlobalCodeExecution = "(program)";
+static const char* EvalCodeExecution = "(eval)";
+static const char* AnonymousFunction = "(anonymous function)";
+static const char* NativeCodeExecution = "(native function)";
+
+// Deeper stacks keep their innermost frames; anything beyond this would be
+// unreadable in a flame graph anyway.
+static const size_t maximumStackDepth = 256;
+
+SamplingProfiler::SamplingProfiler(JSGlobalData& globalData, unsigned samplingInterval)
+    : m_globalData(globalData)
+    , m_samplingInterval(samplingInterval ? samplingInterval : 1)
+    , m_previousCheckInterval(0)
+    , m_isSampling(false)
+    , m_sampleCount(0)
+{
+    m_frames.append(CallIdentifier());
+    m_nodes.append(StackNode(0, 0));
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+void SamplingProfiler::start()
+{
+    if (m_isSampling)
+        return;
+
+    TimeoutChecker& timeoutChecker = m_globalData.timeoutChecker;
+    ASSERT(!timeoutChecker.samplingProfiler());
+    m_previousCheckInterval = timeoutChecker.checkInterval();
+    timeoutChecker.setCheckInterval(m_samplingInterval);
+    timeoutChecker.setSamplingProfiler(this);
+    m_isSampling = true;
+}
+
+void SamplingProfiler::stop()
+{
+    if (!m_isSampling)
+        return;
+
+    TimeoutChecker& timeoutChecker = m_globalData.timeoutChecker;
+    ASSERT(timeoutChecker.samplingProfiler() == this);
+    timeoutChecker.setSamplingProfiler(0);
+    timeoutChecker.setCheckInterval(m_previousCheckInterval);
+    m_isSampling = false;
+}
+
+// Names a frame without allocating in the JS heap: the sample is taken in the
+// middle of running code, so only strings that already exist are used.
+static bool callIdentifierForFrame(ExecState* exec, ExecState* frame, CallIdentifier& result)
+{
+    JSObject* callee = frame->callee();
+    if (!callee) {
+        CodeBlock* codeBlock = frame->codeBlock();
+        if (!codeBlock)
+            return false;
+        ScriptExecutable* executable = codeBlock->ownerExecutable();
+        result = CallIdentifier(codeBlock->codeType() == EvalCode ? EvalCodeExecution : GlobalCodeExecution, executable->sourceURL(), executable->lineNo());
+        return true;
+    }
+
+    if (callee->inherits(&JSFunction::s_info)) {
+        JSFunction* function = asFunction(callee);
+        if (!function->isHostFunction()) {
+            FunctionExecutable* executable = function->jsExecutable();
+            const UString& name = executable->name().ustring();
+            result = CallIdentifier(name.isEmpty() ? AnonymousFunction : name, executable->sourceURL(), executable->lineNo());
+            return true;
+        }
+        const UString& name = function->name(exec);
+        result = CallIdentifier(name.isEmpty() ? NativeCodeExecution : name, UString(), 0);
+        return true;
+    }
+
+    if (callee->inherits(&InternalFunction::s_info)) {
+        const UString& name = static_cast<InternalFunction*>(callee)->name(exec);
+        result = CallIdentifier(name.isEmpty() ? NativeCodeExecution : name, UString(), 0);
+        return true;
+    }
+
+    result = CallIdentifier(NativeCodeExecution, UString(), 0);
+    return true;
+}
+
+unsigned SamplingProfiler::frameIdentifier(ExecState* exec, ExecState* frame)
+{
+    CallIdentifier callIdentifier;
+    if (!callIdentifierForFrame(exec, frame, callIdentifier))
+        return 0;
+
+    pair<HashMap<CallIdentifier, unsigned>::iterator, bool> result = m_frameIdentifiers.add(callIdentifier, m_frames.size());
+    if (result.second)
+        m_frames.append(callIdentifier);
+    return result.first->second;
+}
+
+void SamplingProfiler::takeSample(ExecState* exec, unsigned weight)
+{
+    ASSERT(m_isSampling);
+
+    m_stackBuffer.shrink(0);
+    for (ExecState* frame = exec; frame && m_stackBuffer.size() < maximumStackDepth; frame = frame->trueCallerFrame()) {
+#if ENABLE(BACKGROUND_JIT)
+        // The interpreted frame above it already stands for the same function.
+        if (BackgroundJIT::isInterpreterThunkFrame(frame))
+            continue;
+#endif
+        unsigned identifier = frameIdentifier(exec, frame);
+        if (!identifier)
+            break;
+        m_stackBuffer.append(identifier);
+    }
+    if (m_stackBuffer.isEmpty())
+        return;
+
+    unsigned node = 0;
+    for (size_t i = m_stackBuffer.size(); i--;) {
+        pair<HashMap<pair<unsigned, unsigned>, unsigned>::iterator, bool> result = m_children.add(make_pair(node, m_stackBuffer[i]), m_nodes.size());
+        if (result.second)
+            m_nodes.append(StackNode(node, m_stackBuffer[i]));
+        node = result.first->second;
+    }
+
+    m_nodes[node].selfWeight += weight;
+    ++m_sampleCount;
+}
+
+static void appendFrameLabel(Vector<char>& label, const CallIdentifier& callIdentifier)
+{
+    UString text = callIdentifier.m_name;
+    if (!callIdentifier.m_url.isEmpty())
+        text = makeUString(text, " (", callIdentifier.m_url, ":", UString::number(callIdentifier.m_lineNumber), ")");
+
+    CString utf8 = text.utf8();
+    const char* data = utf8.data();
+    for (size_t i = 0; i < utf8.length(); ++i) {
+        // ';' separates frames and a newline ends a stack in the folded format.
+        char c = data[i];
+        if (c == ';')
+            c = ',';
+        else if (c == '\n' || c == '\r')
+            c = ' ';
+        label.append(c);
+    }
+}
+
+CString SamplingProfiler::foldedStacks() const
+{
+    Vector<Vector<char> > labels(m_frames.size());
+    for (size_t i = 1; i < m_frames.size(); ++i)
+        appendFrameLabel(labels[i], m_frames[i]);
+
+    Vector<char> output;
+    Vector<unsigned, 64> stack;
+    for (size_t i = 1; i < m_nodes.size(); ++i) {
+        if (!m_nodes[i].selfWeight)
+            continue;
+
+        stack.shrink(0);
+        for (unsigned node = i; node; node = m_nodes[node].parent)
+            stack.append(m_nodes[node].frame);
+
+        for (size_t j = stack.size(); j--;) {
+            output.append(labels[stack[j]].data(), labels[stack[j]].size());
+            if (j)
+                output.append(';');
+        }
+
+        char count[16];
+        int length = snprintf(count, sizeof(count), " %u\n", m_nodes[i].selfWeight);
+        output.append(count, length);
+    }
+
+    return CString(output.data(), output.size());
+}
+
+} // namespace JSC
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SamplingProfiler_h
+#define SamplingProfiler_h
+
+#include "CallIdentifier.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+    class ExecState;
+    class JSGlobalData;
+
+    // Periodically records the JavaScript call stack of a JSGlobalData.
+    // Samples are taken from the TimeoutChecker, so they land on the same
+    // safe points the watchdog uses (loop back-edges in the interpreter and
+    // the baseline JIT). Each stack is stored once in a trie; the result can
+    // be exported in the folded format understood by flamegraph.pl.
+    class SamplingProfiler {
+        WTF_MAKE_NONCOPYABLE(SamplingProfiler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        static PassOwnPtr<SamplingProfiler> create(JSGlobalData& globalData, unsigned samplingInterval)
+        {
+            return adoptPtr(new SamplingProfiler(globalData, samplingInterval));
+        }
+
+        ~SamplingProfiler();
+
+        void start();
+        void stop();
+        bool isSampling() const { return m_isSampling; }
+
+        // Called by the TimeoutChecker. The weight is the CPU time in
+        // milliseconds since the previous check.
+        void takeSample(ExecState*, unsigned weight);
+
+        unsigned sampleCount() const { return m_sampleCount; }
+
+        // One line per distinct stack, outermost frame first:
+        // "(program) (a.js:1);f (a.js:3);g (a.js:7) 42\n". The count is the
+        // CPU time in milliseconds attributed to that stack.
+        CString foldedStacks() const;
+
+    private:
+        SamplingProfiler(JSGlobalData&, unsigned samplingInterval);
+
+        unsigned frameIdentifier(ExecState*, ExecState* frame);
+
+        struct StackNode {
+            StackNode(unsigned parent, unsigned frame)
+                : parent(parent)
+                , frame(frame)
+                , selfWeight(0)
+            {
+            }
+
+            unsigned parent;
+            unsigned frame;
+            unsigned selfWeight;
+        };
+
+        JSGlobalData& m_globalData;
+        unsigned m_samplingInterval;
+        unsigned m_previousCheckInterval;
+        bool m_isSampling;
+        unsigned m_sampleCount;
+
+        // Frame identifiers and stack nodes both start at 1; node 0 is the
+        // root and frame 0 is never used, so no child key is ever (0, 0).
+        Vector<CallIdentifier> m_frames;
+        HashMap<CallIdentifier, unsigned> m_frameIdentifiers;
+        Vector<StackNode> m_nodes;
+        HashMap<std::pair<unsigned, unsigned>, unsigned> m_children;
+        Vector<unsigned, 64> m_stackBuffer;
+    };
+
+} // namespace JSC
+
+#endif // SamplingProfiler_h
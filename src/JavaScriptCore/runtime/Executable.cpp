@@ -26,6 +26,7 @@
 #include "config.h"
 #include "Executable.h"
 
+#include "BackgroundJIT.h"
 #include "BytecodeGenerator.h"
 #include "CodeBlock.h"
 #include "DFGDriver.h"
@@ -456,6 +457,13 @@ JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChain
 
 #if ENABLE(JIT)
     JSGlobalData* globalData = scopeChainNode->globalData;
+#if ENABLE(BACKGROUND_JIT)
+    if (globalData->canUseJIT() && jitType == JITCode::BaselineJIT && !m_codeBlockForCall->hasLoops()) {
+        // Interpret this code until it gets hot enough for the background JIT to compile it.
+        m_jitCodeForCall = globalData->backgroundJIT->interpreterThunkFor(CodeForCall);
+        m_jitCodeForCallWithArityCheck = m_jitCodeForCall.addressForCall();
+    } else
+#endif
     if (globalData->canUseJIT()) {
         bool dfgCompiled = false;
         if (jitType == JITCode::DFGJIT)
@@ -514,6 +522,13 @@ JSObject* FunctionExecutable::compileForConstructInternal(ExecState* exec, Scope
 
 #if ENABLE(JIT)
     JSGlobalData* globalData = scopeChainNode->globalData;
+#if ENABLE(BACKGROUND_JIT)
+    if (globalData->canUseJIT() && jitType == JITCode::BaselineJIT && !m_codeBlockForConstruct->hasLoops()) {
+        // Interpret this code until it gets hot enough for the background JIT to compile it.
+        m_jitCodeForConstruct = globalData->backgroundJIT->interpreterThunkFor(CodeForConstruct);
+        m_jitCodeForConstructWithArityCheck = m_jitCodeForConstruct.addressForCall();
+    } else
+#endif
     if (globalData->canUseJIT()) {
         bool dfgCompiled = false;
         if (jitType == JITCode::DFGJIT)
@@ -568,6 +583,27 @@ void FunctionExecutable::jettisonOptimizedCodeForConstruct(JSGlobalData& globalD
 }
 #endif
 
+#if ENABLE(BACKGROUND_JIT)
+void FunctionExecutable::installJITCodeFor(CodeSpecializationKind kind, const JITCode& jitCode, MacroAssemblerCodePtr jitCodeWithArityCheck)
+{
+    FunctionCodeBlock* codeBlock = codeBlockFor(kind).get();
+    ASSERT(codeBlock && !codeBlock->getJITCode());
+    if (kind == CodeForCall) {
+        m_jitCodeForCall = jitCode;
+        m_jitCodeForCallWithArityCheck = jitCodeWithArityCheck;
+    } else {
+        ASSERT(kind == CodeForConstruct);
+        m_jitCodeForConstruct = jitCode;
+        m_jitCodeForConstructWithArityCheck = jitCodeWithArityCheck;
+    }
+    // The bytecode stays, since interpreted frames of this code may still be live.
+    codeBlock->setJITCode(jitCode, jitCodeWithArityCheck);
+    // Calls that were linked to the interpreter thunk get relinked to the new code.
+    codeBlock->unlinkIncomingCalls();
+    Heap::heap(this)->reportExtraMemoryCost(codeBlock->getJITCode().size());
+}
+#endif
+
 void FunctionExecutable::visitChildren(JSCell* cell, SlotVisitor& visitor)
 {
     FunctionExecutable* thisObject = static_cast<FunctionExecutable*>(cell);
@@ -593,6 +629,10 @@ void FunctionExecutable::discardCode()
         return;
     if (!m_jitCodeForConstruct && m_codeBlockForConstruct)
         return;
+#endif
+#if ENABLE(BACKGROUND_JIT)
+    if (m_codeBlockForCall || m_codeBlockForConstruct)
+        Heap::heap(this)->globalData()->backgroundJIT->cancel(this);
 #endif
     clearCodeVirtual();
 }
@@ -613,14 +653,12 @@ void FunctionExecutable::clearCodeVirtual()
 void FunctionExecutable::unlinkCalls()
 {
 #if ENABLE(JIT)
-    if (!!m_jitCodeForCall) {
-        ASSERT(m_codeBlockForCall);
+    // Interpreted code has no calls to unlink, and under ENABLE(BACKGROUND_JIT) its call
+    // link infos may be in the middle of being filled in by the compiler thread.
+    if (!!m_jitCodeForCall && !!m_codeBlockForCall->getJITCode())
         m_codeBlockForCall->unlinkCalls();
-    }
-    if (!!m_jitCodeForConstruct) {
-        ASSERT(m_codeBlockForConstruct);
+    if (!!m_jitCodeForConstruct && !!m_codeBlockForConstruct->getJITCode())
         m_codeBlockForConstruct->unlinkCalls();
-    }
 #endif
 }
 
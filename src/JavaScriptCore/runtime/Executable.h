@@ -553,6 +553,11 @@ namespace JSC {
             }
         }
 #endif
+
+#if ENABLE(BACKGROUND_JIT)
+        // Replaces the interpreter thunk of code that the background JIT has compiled.
+        void installJITCodeFor(CodeSpecializationKind, const JITCode&, MacroAssemblerCodePtr jitCodeWithArityCheck);
+#endif
         
         bool isGeneratedFor(CodeSpecializationKind kind)
         {
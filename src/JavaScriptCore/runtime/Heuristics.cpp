@@ -26,7 +26,9 @@
 #include "config.h"
 #include "Heuristics.h"
 
+#include <algorithm>
 #include <limits>
+#include <wtf/NumberOfCores.h>
 
 // Set to 1 to control the heuristics using environment variables.
 #define ENABLE_RUN_TIME_HEURISTICS 0
@@ -60,6 +62,12 @@ unsigned maximumOptimizationDelay;
 double desiredProfileLivenessRate;
 double desiredProfileFullnessRate;
 
+unsigned numberOfGCMarkers;
+double oldGenerationGrowthFactorForFullGC;
+unsigned maximumYoungGCsBetweenFullGCs;
+
+unsigned backgroundJITCallThreshold;
+
 #if ENABLE(RUN_TIME_HEURISTICS)
 static bool parse(const char* string, int32_t& value)
 {
@@ -118,6 +126,25 @@ void initializeHeuristics()
     SET(maximumOptimizationDelay,   5);
     SET(desiredProfileLivenessRate, 0.75);
     SET(desiredProfileFullnessRate, 0.25);
+
+#if ENABLE(PARALLEL_GC)
+    // Beyond a handful of markers the shared mark stack's lock, not the
+    // number of cores, limits how fast the heap can be traced.
+    unsigned cpusToUse = std::min(numberOfProcessorCores(), 4);
+    SET(numberOfGCMarkers, std::max(cpusToUse, 1u));
+#else
+    SET(numberOfGCMarkers, 1);
+#endif
+
+    // Young collections cannot reclaim old cells, so a full collection runs
+    // once the survivors of young collections have doubled the heap, or after
+    // enough young collections that old garbage would otherwise pile up.
+    SET(oldGenerationGrowthFactorForFullGC, 2.0);
+    SET(maximumYoungGCsBetweenFullGCs,      16);
+
+    // Functions without loops are interpreted until they have been entered this
+    // many times, and then baseline compiled off the main thread.
+    SET(backgroundJITCallThreshold, 20);
     
     ASSERT(executionCounterValueForDontOptimizeAnytimeSoon <= executionCounterValueForOptimizeAfterLongWarmUp);
     ASSERT(executionCounterValueForOptimizeAfterLongWarmUp <= executionCounterValueForOptimizeAfterWarmUp);
@@ -51,6 +51,12 @@ extern unsigned maximumOptimizationDelay;
 extern double desiredProfileLivenessRate;
 extern double desiredProfileFullnessRate;
 
+extern unsigned numberOfGCMarkers;
+extern double oldGenerationGrowthFactorForFullGC;
+extern unsigned maximumYoungGCsBetweenFullGCs;
+
+extern unsigned backgroundJITCallThreshold;
+
 void initializeHeuristics();
 
 } } // namespace JSC::Heuristics
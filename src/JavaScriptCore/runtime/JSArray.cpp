@@ -172,6 +172,7 @@ void JSArray::finishCreation(JSGlobalData& globalData, unsigned initialLength, A
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
     m_storage->reportedMapCapacity = 0;
+    m_storage->m_vectorMayContainCells = false;
 
     if (creationMode == CreateCompact) {
 #if CHECK_ARRAY_CONSISTENCY
@@ -219,6 +220,7 @@ void JSArray::finishCreation(JSGlobalData& globalData, const ArgList& list)
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
     m_storage->reportedMapCapacity = 0;
+    m_storage->m_vectorMayContainCells = false;
 #if CHECK_ARRAY_CONSISTENCY
     m_storage->m_inCompactInitialization = false;
 #endif
@@ -226,8 +228,10 @@ void JSArray::finishCreation(JSGlobalData& globalData, const ArgList& list)
     size_t i = 0;
     WriteBarrier<Unknown>* vector = m_storage->m_vector;
     ArgList::const_iterator end = list.end();
-    for (ArgList::const_iterator it = list.begin(); it != end; ++it, ++i)
+    for (ArgList::const_iterator it = list.begin(); it != end; ++it, ++i) {
         vector[i].set(globalData, this, *it);
+        didStoreInVector(m_storage, *it);
+    }
     for (; i < initialStorage; i++)
         vector[i].clear();
 
@@ -383,6 +387,7 @@ void JSArray::putByIndex(JSCell* cell, ExecState* exec, unsigned i, JSValue valu
 
     if (i < thisObject->m_vectorLength) {
         WriteBarrier<Unknown>& valueSlot = storage->m_vector[i];
+        didStoreInVector(storage, value);
         if (valueSlot) {
             valueSlot.set(exec->globalData(), thisObject, value);
             thisObject->checkConsistency();
@@ -439,6 +444,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
         if (increaseVectorLength(i + 1)) {
             storage = m_storage;
             storage->m_vector[i].set(exec->globalData(), this, value);
+            didStoreInVector(storage, value);
             ++storage->m_numValuesInVector;
             checkConsistency();
         } else
@@ -491,8 +497,11 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
         for (unsigned j = vectorLength; j < max(vectorLength, MIN_SPARSE_ARRAY_INDEX); ++j)
             vector[j].clear();
         JSGlobalData& globalData = exec->globalData();
-        for (unsigned j = max(vectorLength, MIN_SPARSE_ARRAY_INDEX); j < newVectorLength; ++j)
-            vector[j].set(globalData, this, map->take(j).get());
+        for (unsigned j = max(vectorLength, MIN_SPARSE_ARRAY_INDEX); j < newVectorLength; ++j) {
+            JSValue movedValue = map->take(j).get();
+            vector[j].set(globalData, this, movedValue);
+            didStoreInVector(storage, movedValue);
+        }
     }
 
     ASSERT(i < newVectorLength);
@@ -501,6 +510,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
     storage->m_numValuesInVector = newNumValuesInVector;
 
     storage->m_vector[i].set(exec->globalData(), this, value);
+    didStoreInVector(storage, value);
 
     checkConsistency();
 
@@ -788,6 +798,7 @@ void JSArray::push(ExecState* exec, JSValue value)
 
     if (storage->m_length < m_vectorLength) {
         storage->m_vector[storage->m_length].set(exec->globalData(), this, value);
+        didStoreInVector(storage, value);
         ++storage->m_numValuesInVector;
         ++storage->m_length;
         checkConsistency();
@@ -800,6 +811,7 @@ void JSArray::push(ExecState* exec, JSValue value)
             if (increaseVectorLength(storage->m_length + 1)) {
                 storage = m_storage;
                 storage->m_vector[storage->m_length].set(exec->globalData(), this, value);
+                didStoreInVector(storage, value);
                 ++storage->m_numValuesInVector;
                 ++storage->m_length;
                 checkConsistency();
@@ -918,8 +930,12 @@ void JSArray::visitChildren(JSCell* cell, SlotVisitor& visitor)
     
     ArrayStorage* storage = thisObject->m_storage;
 
-    unsigned usedVectorLength = std::min(storage->m_length, thisObject->m_vectorLength);
-    visitor.appendValues(storage->m_vector, usedVectorLength);
+    // Numeric arrays can be large and are rewritten often, which would
+    // otherwise have every young collection walk them again.
+    if (storage->m_vectorMayContainCells) {
+        unsigned usedVectorLength = std::min(storage->m_length, thisObject->m_vectorLength);
+        visitor.appendValues(storage->m_vector, usedVectorLength);
+    }
 
     if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
         SparseArrayValueMap::iterator end = map->end();
@@ -1219,7 +1235,9 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
     iter.start_iter_least(tree);
     JSGlobalData& globalData = exec->globalData();
     for (unsigned i = 0; i < numDefined; ++i) {
-        storage->m_vector[i].set(globalData, this, tree.abstractor().m_nodes[*iter].value);
+        JSValue value = tree.abstractor().m_nodes[*iter].value;
+        storage->m_vector[i].set(globalData, this, value);
+        didStoreInVector(storage, value);
         ++iter;
     }
 
@@ -1313,8 +1331,10 @@ unsigned JSArray::compactForSorting()
         }
 
         SparseArrayValueMap::iterator end = map->end();
-        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it)
+        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
             storage->m_vector[numDefined++].setWithoutWriteBarrier(it->second.get());
+            didStoreInVector(storage, it->second.get());
+        }
 
         delete map;
         storage->m_sparseValueMap = 0;
@@ -41,6 +41,10 @@ namespace JSC {
         void* subclassData; // A JSArray subclass can use this to fill the vector lazily.
         void* m_allocBase; // Pointer to base address returned by malloc().  Keeping this pointer does eliminate false positives from the leak detector.
         size_t reportedMapCapacity;
+        // Cleared while m_vector has only ever held numbers and other immediates,
+        // so that the collector can skip the vector. Every store into m_vector
+        // has to set it if the value is a cell; the JITs store to it directly.
+        unsigned m_vectorMayContainCells;
 #if CHECK_ARRAY_CONSISTENCY
         bool m_inCompactInitialization;
 #endif
@@ -137,6 +141,7 @@ namespace JSC {
                     storage->m_length = i + 1;
             }
             x.set(globalData, this, v);
+            didStoreInVector(m_storage, v);
         }
         
         void uncheckedSetIndex(JSGlobalData& globalData, unsigned i, JSValue v)
@@ -147,6 +152,7 @@ namespace JSC {
             ASSERT(storage->m_inCompactInitialization);
 #endif
             storage->m_vector[i].set(globalData, this, v);
+            didStoreInVector(storage, v);
         }
 
         void fillArgList(ExecState*, MarkedArgumentBuffer&);
@@ -187,6 +193,12 @@ namespace JSC {
         bool getOwnPropertySlotSlowCase(ExecState*, unsigned propertyName, PropertySlot&);
         void putSlowCase(ExecState*, unsigned propertyName, JSValue);
 
+        static void didStoreInVector(ArrayStorage* storage, JSValue value)
+        {
+            if (value.isCell())
+                storage->m_vectorMayContainCells = true;
+        }
+
         unsigned getNewVectorLength(unsigned desiredLength);
         bool increaseVectorLength(unsigned newLength);
         bool increaseVectorPrefixLength(unsigned newLength);
@@ -30,6 +30,7 @@
 #include "JSGlobalData.h"
 
 #include "ArgList.h"
+#include "BackgroundJIT.h"
 #include "Heap.h"
 #include "CommonIdentifiers.h"
 #include "DebuggerActivation.h"
@@ -55,6 +56,7 @@
 #endif
 #include "RegExpCache.h"
 #include "RegExpObject.h"
+#include "SamplingProfiler.h"
 #include "StrictEvalActivation.h"
 #include "StrongInlines.h"
 #include <wtf/Threading.h>
@@ -266,6 +268,9 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
 #endif
     jitStubs = adoptPtr(new JITThunks(this));
 #endif
+#if ENABLE(BACKGROUND_JIT)
+    backgroundJIT = BackgroundJIT::create(*this);
+#endif
 
     heap.notifyIsSafeToCollect();
 }
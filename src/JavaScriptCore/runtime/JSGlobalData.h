@@ -57,6 +57,9 @@ struct OpaqueJSClassContextData;
 
 namespace JSC {
 
+#if ENABLE(BACKGROUND_JIT)
+    class BackgroundJIT;
+#endif
     class CodeBlock;
     class CommonIdentifiers;
     class HandleStack;
@@ -68,6 +71,7 @@ namespace JSC {
     class NativeExecutable;
     class Parser;
     class RegExpCache;
+    class SamplingProfiler;
     class Stringifier;
     class Structure;
     class UString;
@@ -98,6 +102,28 @@ namespace JSC {
         double increment;
     };
 
+    // Counts property accesses that the inline caches could not handle. Only the
+    // slow paths touch these, so keeping them always on is essentially free.
+    struct InlineCacheStatistics {
+        InlineCacheStatistics()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            genericGetByIdCalls = 0;
+            genericPutByIdCalls = 0;
+            uncacheableDictionaryAccesses = 0;
+            dictionaryFlattenings = 0;
+        }
+
+        uint64_t genericGetByIdCalls;
+        uint64_t genericPutByIdCalls;
+        uint64_t uncacheableDictionaryAccesses;
+        uint64_t dictionaryFlattenings;
+    };
+
     enum ThreadStackType {
         ThreadStackTypeLarge,
         ThreadStackTypeSmall
@@ -218,6 +244,9 @@ namespace JSC {
             return jitStubs->ctiStub(this, generator);
         }
         NativeExecutable* getHostFunction(NativeFunction, ThunkGenerator, DFG::Intrinsic);
+#endif
+#if ENABLE(BACKGROUND_JIT)
+        OwnPtr<BackgroundJIT> backgroundJIT;
 #endif
         NativeExecutable* getHostFunction(NativeFunction, NativeFunction constructor);
 
@@ -264,6 +293,16 @@ namespace JSC {
 
         double cachedUTCOffset;
         DSTOffsetCache dstOffsetCache;
+
+        InlineCacheStatistics inlineCacheStatistics;
+        // Objects that went from an uncacheable dictionary back to a cacheable structure.
+        // Their structures may be shared with ordinary objects, so this is kept per object.
+        // Every collection clears it, so the address of a dead object is never mistaken
+        // for a live one.
+        HashSet<JSObject*> reflattenedDictionaryObjects;
+
+        // Non-null while an embedder is collecting a sampling profile.
+        OwnPtr<SamplingProfiler> samplingProfiler;
         
         UString cachedDateString;
         double cachedDateStringValue;
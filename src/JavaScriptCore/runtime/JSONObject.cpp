@@ -36,9 +36,11 @@
 #include "LocalScope.h"
 #include "Lookup.h"
 #include "PropertyNameArray.h"
+#include "StrongInlines.h"
 #include "UStringBuilder.h"
 #include "UStringConcatenate.h"
 #include <wtf/MathExtras.h>
+#include <wtf/dtoa.h>
 
 namespace JSC {
 
@@ -83,6 +85,7 @@ class Stringifier {
 public:
     Stringifier(ExecState*, const Local<Unknown>& replacer, const Local<Unknown>& space);
     Local<Unknown> stringify(Handle<Unknown>);
+    bool stringify(Handle<Unknown>, JSONStringifySink&);
 
     void visitAggregate(SlotVisitor&);
 
@@ -109,9 +112,12 @@ private:
     static void appendQuotedString(UStringBuilder&, const UString&);
 
     JSValue toJSON(JSValue, const PropertyNameForFunctionCall&);
+    PassRefPtr<PropertyNameArrayData> ownPropertyNames(JSObject*);
 
     enum StringifyResult { StringifyFailed, StringifySucceeded, StringifyFailedDueToUndefinedValue };
+    StringifyResult appendStringifiedRoot(UStringBuilder&, Handle<Unknown>);
     StringifyResult appendStringifiedValue(UStringBuilder&, JSValue, JSObject* holder, const PropertyNameForFunctionCall&);
+    void flushToSink(UStringBuilder&);
 
     bool willIndent() const;
     void indent();
@@ -129,6 +135,13 @@ private:
     Vector<Holder, 16> m_holderStack;
     UString m_repeatedGap;
     UString m_indent;
+
+    // Objects built from the same literal or constructor share a Structure, so the
+    // property names of the last plain object are reused for the next one.
+    Strong<Structure> m_cachedPropertyNamesStructure;
+    RefPtr<PropertyNameArrayData> m_cachedPropertyNames;
+
+    JSONStringifySink* m_sink;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -147,6 +160,36 @@ static inline JSValue unwrapBoxedPrimitive(ExecState* exec, JSValue value)
     return value;
 }
 
+static const unsigned sinkChunkLength = 32 * 1024;
+
+static inline void appendNumber(UStringBuilder& builder, JSValue value)
+{
+    if (value.isInt32()) {
+        UChar buffer[12];
+        UChar* end = buffer + WTF_ARRAY_LENGTH(buffer);
+        UChar* p = end;
+        int32_t number = value.asInt32();
+        unsigned magnitude = number < 0 ? -static_cast<unsigned>(number) : number;
+        do {
+            *--p = static_cast<UChar>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (number < 0)
+            *--p = '-';
+        builder.append(p, end - p);
+        return;
+    }
+
+    double number = value.asNumber();
+    if (!isfinite(number)) {
+        builder.append("null");
+        return;
+    }
+    NumberToStringBuffer buffer;
+    const char* characters = numberToString(number, buffer);
+    builder.append(characters, strlen(characters));
+}
+
 static inline UString gap(ExecState* exec, JSValue space)
 {
     const unsigned maxGapLength = 10;
@@ -209,6 +252,7 @@ Stringifier::Stringifier(ExecState* exec, const Local<Unknown>& replacer, const
     , m_arrayReplacerPropertyNames(exec)
     , m_replacerCallType(CallTypeNone)
     , m_gap(gap(exec, space.get()))
+    , m_sink(0)
 {
     if (!m_replacer.isObject())
         return;
@@ -249,21 +293,65 @@ Stringifier::Stringifier(ExecState* exec, const Local<Unknown>& replacer, const
 }
 
 Local<Unknown> Stringifier::stringify(Handle<Unknown> value)
+{
+    UStringBuilder result;
+    switch (appendStringifiedRoot(result, value)) {
+        case StringifyFailed:
+            return Local<Unknown>(m_exec->globalData(), jsNull());
+        case StringifyFailedDueToUndefinedValue:
+            return Local<Unknown>(m_exec->globalData(), jsUndefined());
+        case StringifySucceeded:
+            break;
+    }
+    return Local<Unknown>(m_exec->globalData(), jsString(m_exec, result.toUString()));
+}
+
+bool Stringifier::stringify(Handle<Unknown> value, JSONStringifySink& sink)
+{
+    UStringBuilder result;
+    m_sink = &sink;
+    StringifyResult stringifyResult = appendStringifiedRoot(result, value);
+    m_sink = 0;
+    if (stringifyResult != StringifySucceeded)
+        return false;
+    if (!result.isEmpty())
+        sink.append(result.characters(), result.length());
+    return true;
+}
+
+Stringifier::StringifyResult Stringifier::appendStringifiedRoot(UStringBuilder& builder, Handle<Unknown> value)
 {
     JSObject* object = constructEmptyObject(m_exec);
     if (m_exec->hadException())
-        return Local<Unknown>(m_exec->globalData(), jsNull());
+        return StringifyFailed;
 
     PropertyNameForFunctionCall emptyPropertyName(m_exec->globalData().propertyNames->emptyIdentifier);
     object->putDirect(m_exec->globalData(), m_exec->globalData().propertyNames->emptyIdentifier, value.get());
 
-    UStringBuilder result;
-    if (appendStringifiedValue(result, value.get(), object, emptyPropertyName) != StringifySucceeded)
-        return Local<Unknown>(m_exec->globalData(), jsUndefined());
+    if (appendStringifiedValue(builder, value.get(), object, emptyPropertyName) != StringifySucceeded)
+        return StringifyFailedDueToUndefinedValue;
     if (m_exec->hadException())
-        return Local<Unknown>(m_exec->globalData(), jsNull());
+        return StringifyFailed;
+    return StringifySucceeded;
+}
 
-    return Local<Unknown>(m_exec->globalData(), jsString(m_exec, result.toUString()));
+void Stringifier::flushToSink(UStringBuilder& builder)
+{
+    // appendNextProperty looks at the last character to decide whether a separator
+    // is needed, and a surrogate pair must not be split between two chunks, so the
+    // tail of the output stays in the builder.
+    unsigned length = builder.length() - 1;
+    if (length && U16_IS_LEAD(builder[length - 1]))
+        --length;
+    m_sink->append(builder.characters(), length);
+
+    UChar tail[2];
+    unsigned tailLength = builder.length() - length;
+    for (unsigned i = 0; i < tailLength; ++i)
+        tail[i] = builder[length + i];
+    builder.clear();
+    builder.reserveCapacity(sinkChunkLength + sinkChunkLength / 4);
+    builder.append(tail, tailLength);
 }
 
 void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& value)
@@ -324,10 +412,13 @@ void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& val
 inline JSValue Stringifier::toJSON(JSValue value, const PropertyNameForFunctionCall& propertyName)
 {
     ASSERT(!m_exec->hadException());
-    if (!value.isObject() || !asObject(value)->hasProperty(m_exec, m_exec->globalData().propertyNames->toJSON))
+    if (!value.isObject())
         return value;
 
-    JSValue toJSONFunction = asObject(value)->get(m_exec, m_exec->globalData().propertyNames->toJSON);
+    PropertySlot slot(value);
+    if (!asObject(value)->getPropertySlot(m_exec, m_exec->globalData().propertyNames->toJSON, slot))
+        return value;
+    JSValue toJSONFunction = slot.getValue(m_exec, m_exec->globalData().propertyNames->toJSON);
     if (m_exec->hadException())
         return jsNull();
 
@@ -345,6 +436,25 @@ inline JSValue Stringifier::toJSON(JSValue value, const PropertyNameForFunctionC
     return call(m_exec, object, callType, callData, value, args);
 }
 
+PassRefPtr<PropertyNameArrayData> Stringifier::ownPropertyNames(JSObject* object)
+{
+    // The names of a plain object that is not in dictionary mode are fully
+    // determined by its Structure.
+    Structure* structure = object->structure();
+    bool isCachable = object->classInfo() == &JSFinalObject::s_info && !structure->isDictionary();
+    if (isCachable && m_cachedPropertyNamesStructure.get() == structure)
+        return m_cachedPropertyNames;
+
+    PropertyNameArray objectPropertyNames(m_exec);
+    object->getOwnPropertyNames(m_exec, objectPropertyNames);
+    RefPtr<PropertyNameArrayData> propertyNames = objectPropertyNames.releaseData();
+    if (isCachable) {
+        m_cachedPropertyNamesStructure.set(m_exec->globalData(), structure);
+        m_cachedPropertyNames = propertyNames;
+    }
+    return propertyNames.release();
+}
+
 Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder& builder, JSValue value, JSObject* holder, const PropertyNameForFunctionCall& propertyName)
 {
     // Call the toJSON function.
@@ -386,11 +496,7 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
     }
 
     if (value.isNumber()) {
-        double number = value.asNumber();
-        if (!isfinite(number))
-            builder.append("null");
-        else
-            builder.append(UString::number(number));
+        appendNumber(builder, value);
         return StringifySucceeded;
     }
 
@@ -428,6 +534,8 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
         while (m_holderStack.last().appendNextProperty(*this, builder)) {
             if (m_exec->hadException())
                 return StringifyFailed;
+            if (m_sink && builder.length() >= sinkChunkLength)
+                flushToSink(builder);
             if (!--tickCount) {
                 if (localTimeoutChecker.didTimeOut(m_exec)) {
                     throwError(m_exec, createInterruptedExecutionException(&m_exec->globalData()));
@@ -492,11 +600,8 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
-            else {
-                PropertyNameArray objectPropertyNames(exec);
-                m_object->getOwnPropertyNames(exec, objectPropertyNames);
-                m_propertyNames = objectPropertyNames.releaseData();
-            }
+            else
+                m_propertyNames = stringifier.ownPropertyNames(m_object.get());
             m_size = m_propertyNames->propertyNameVector().size();
             builder.append('{');
         }
@@ -862,4 +967,10 @@ UString JSONStringify(ExecState* exec, JSValue value, unsigned indent)
     return result.getString(exec);
 }
 
+bool JSONStringify(ExecState* exec, JSValue value, unsigned indent, JSONStringifySink& sink)
+{
+    LocalScope scope(exec->globalData());
+    return Stringifier(exec, Local<Unknown>(exec->globalData(), jsNull()), Local<Unknown>(exec->globalData(), jsNumber(indent))).stringify(Local<Unknown>(exec->globalData(), value), sink);
+}
+
 } // namespace JSC
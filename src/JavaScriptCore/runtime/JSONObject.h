@@ -62,8 +62,20 @@ namespace JSC {
 
     };
 
+    // Receives the output of JSONStringify in chunks, so that large values can be
+    // serialized without materializing the whole string.
+    class JSONStringifySink {
+    public:
+        virtual ~JSONStringifySink() { }
+        virtual void append(const UChar*, unsigned length) = 0;
+    };
+
     UString JSONStringify(ExecState* exec, JSValue value, unsigned indent);
 
+    // Returns false if the value does not serialize to anything or an exception
+    // was thrown, in which case any output already passed to the sink is incomplete.
+    bool JSONStringify(ExecState*, JSValue, unsigned indent, JSONStringifySink&);
+
 } // namespace JSC
 
 #endif // JSONObject_h
@@ -655,6 +655,51 @@ void JSObject::removeDirect(JSGlobalData& globalData, const Identifier& property
         putUndefinedAtDirectOffset(offset);
 }
 
+// Called by the inline caches when they see an object that became an uncacheable
+// dictionary, typically because a property was deleted. The first time around the
+// object is given a cacheable structure again, shared with similar objects where
+// possible. If it turns back into a dictionary before the next collection it is most
+// likely being used as a hash map, and we leave it alone rather than redoing this after
+// every delete. Returns false in that case, and the caller should stop trying to cache.
+bool JSObject::flattenUncacheableDictionaryForCaching(JSGlobalData& globalData)
+{
+    Structure* structure = this->structure();
+    ASSERT(structure->isUncacheableDictionary());
+
+    globalData.inlineCacheStatistics.uncacheableDictionaryAccesses++;
+    if (structure->typeInfo().prohibitsPropertyCaching())
+        return false;
+    if (!globalData.reflattenedDictionaryObjects.add(this).second)
+        return false;
+
+    JSValue prototype = structure->storedPrototype();
+    if (structure->classInfo() == &JSFinalObject::s_info && prototype.isObject()) {
+        Vector<size_t, 8> oldOffsets;
+        Vector<size_t, 8> newOffsets;
+        if (Structure* sharedStructure = structure->sharedStructureForDictionary(globalData, asObject(prototype)->inheritorID(globalData), oldOffsets, newOffsets)) {
+            Vector<JSValue, 8> values(oldOffsets.size());
+            for (size_t i = 0; i < oldOffsets.size(); ++i)
+                values[i] = getDirectOffset(oldOffsets[i]);
+
+            // The compiled property accesses pick inline or out of line storage based on the
+            // structure, so move the properties back inline if they fit there again.
+            if (sharedStructure->isUsingInlineStorage() && !isUsingInlineStorage()) {
+                delete [] m_propertyStorage.get();
+                m_propertyStorage.set(globalData, this, reinterpret_cast<PropertyStorage>(this + 1));
+            }
+            setStructure(globalData, sharedStructure);
+            for (size_t i = 0; i < newOffsets.size(); ++i)
+                putDirectOffset(globalData, newOffsets[i], values[i]);
+            globalData.inlineCacheStatistics.dictionaryFlattenings++;
+            return true;
+        }
+    }
+
+    structure->flattenDictionaryStructure(globalData, this);
+    globalData.inlineCacheStatistics.dictionaryFlattenings++;
+    return true;
+}
+
 NEVER_INLINE void JSObject::fillGetterPropertySlot(PropertySlot& slot, WriteBarrierBase<Unknown>* location)
 {
     if (JSObject* getterFunction = asGetterSetter(location->get())->getter()) {
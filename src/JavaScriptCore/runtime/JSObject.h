@@ -229,6 +229,8 @@ namespace JSC {
             structure()->flattenDictionaryStructure(globalData, this);
         }
 
+        bool flattenUncacheableDictionaryForCaching(JSGlobalData&);
+
         JSGlobalObject* globalObject() const
         {
             ASSERT(structure()->globalObject());
@@ -32,7 +32,13 @@
 
 namespace JSC {
     
-static const unsigned substringFromRopeCutoff = 4;
+// Slices shorter than this that span several fibers are cheaper to take from
+// the flattened rope than to build as ropes of their own.
+static const unsigned substringFromRopeCutoff = 32;
+
+// Ropes built by appending in a loop are deep on one side; past this depth a
+// slice flattens the fiber it is in rather than keep walking down.
+static const unsigned maxSubstringFromRopeDepth = 16;
 
 const ClassInfo JSString::s_info = { "string", 0, 0, 0, CREATE_METHOD_TABLE(JSString) };
 
@@ -127,6 +133,45 @@ void JSString::resolveRopeSlowCase(ExecState* exec, UChar* buffer) const
     ASSERT(!isRope());
 }
 
+// A slice of a rope is made of the fibers it covers, so slicing does not copy
+// the characters of the whole rope the way resolving it would.
+JSString* JSString::substringFromRope(ExecState* exec, unsigned offset, unsigned length, unsigned depth)
+{
+    ASSERT(length && offset + length <= m_length);
+    if (!offset && length == m_length)
+        return this;
+    if (!isRope() || depth == maxSubstringFromRopeDepth)
+        return jsSubstring(&exec->globalData(), value(exec), offset, length);
+
+    size_t first = 0;
+    while (offset >= m_fibers[first]->length()) {
+        offset -= m_fibers[first]->length();
+        ++first;
+        ASSERT(first < s_maxInternalRopeLength && m_fibers[first]);
+    }
+    JSString* fiber = m_fibers[first].get();
+    if (offset + length <= fiber->length())
+        return fiber->substringFromRope(exec, offset, length, depth + 1);
+
+    if (length < substringFromRopeCutoff) {
+        for (size_t i = 0; i < first; ++i)
+            offset += m_fibers[i]->length();
+        return jsSubstring(&exec->globalData(), value(exec), offset, length);
+    }
+
+    RopeBuilder builder(exec->globalData());
+    for (size_t i = first; length; ++i) {
+        ASSERT(i < s_maxInternalRopeLength && m_fibers[i]);
+        fiber = m_fibers[i].get();
+        unsigned pieceLength = std::min(length, fiber->length() - offset);
+        if (pieceLength)
+            builder.append(fiber->substringFromRope(exec, offset, pieceLength, depth + 1));
+        length -= pieceLength;
+        offset = 0;
+    }
+    return builder.release();
+}
+
 void JSString::outOfMemory(ExecState* exec) const
 {
     for (size_t i = 0; i < s_maxInternalRopeLength && m_fibers[i]; ++i)
@@ -225,6 +225,8 @@ namespace JSC {
 
         JSValue replaceCharacter(ExecState*, UChar, const UString& replacement);
 
+        bool equal(ExecState*, JSString*);
+
         static Structure* createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue proto)
         {
             return Structure::create(globalData, globalObject, proto, TypeInfo(StringType, OverridesGetOwnPropertySlot), &s_info);
@@ -245,6 +247,7 @@ namespace JSC {
 
         void resolveRope(ExecState*) const;
         void resolveRopeSlowCase(ExecState*, UChar*) const;
+        JSString* substringFromRope(ExecState*, unsigned offset, unsigned length, unsigned depth);
         void outOfMemory(ExecState*) const;
 
         virtual JSObject* toThisObject(ExecState*) const;
@@ -356,6 +359,8 @@ namespace JSC {
         JSGlobalData* globalData = &exec->globalData();
         if (!length)
             return globalData->smallStrings.emptyString(globalData);
+        if (s->isRope())
+            return s->substringFromRope(exec, offset, length, 0);
         return jsSubstring(globalData, s->value(exec), offset, length);
     }
 
@@ -392,6 +397,16 @@ namespace JSC {
         return fixupVPtr(globalData, JSString::createNull(*globalData));
     }
 
+    inline bool JSString::equal(ExecState* exec, JSString* other)
+    {
+        // Strings of different lengths can be told apart without flattening either rope.
+        if (m_length != other->m_length)
+            return false;
+        if (this == other)
+            return true;
+        return value(exec) == other->value(exec);
+    }
+
     inline JSString* jsEmptyString(ExecState* exec) { return jsEmptyString(&exec->globalData()); }
     inline JSString* jsString(ExecState* exec, const UString& s) { return jsString(&exec->globalData(), s); }
     inline JSString* jsSingleCharacterString(ExecState* exec, UChar c) { return jsSingleCharacterString(&exec->globalData(), c); }
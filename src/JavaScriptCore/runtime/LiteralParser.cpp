@@ -120,23 +120,46 @@ bool LiteralParser::tryJSONPParse(Vector<JSONPData>& results, bool needsFullSour
     return m_lexer.currentToken().type == TokEnd;
 }
     
+// Keys of the same object often share their first character ("first", "flags"),
+// so the recent caches are indexed by both ends of the string and its length.
+static ALWAYS_INLINE unsigned recentCacheIndex(const UChar* characters, size_t length, unsigned cacheSize)
+{
+    return (characters[0] ^ characters[length - 1] ^ (length << 3)) & (cacheSize - 1);
+}
+
 ALWAYS_INLINE const Identifier LiteralParser::makeIdentifier(const UChar* characters, size_t length)
 {
     if (!length)
         return m_exec->globalData().propertyNames->emptyIdentifier;
-    if (characters[0] >= MaximumCachableCharacter)
-        return Identifier(&m_exec->globalData(), characters, length);
 
     if (length == 1) {
+        if (characters[0] >= MaximumCachableCharacter)
+            return Identifier(&m_exec->globalData(), characters, length);
         if (!m_shortIdentifiers[characters[0]].isNull())
             return m_shortIdentifiers[characters[0]];
         m_shortIdentifiers[characters[0]] = Identifier(&m_exec->globalData(), characters, length);
         return m_shortIdentifiers[characters[0]];
     }
-    if (!m_recentIdentifiers[characters[0]].isNull() && Identifier::equal(m_recentIdentifiers[characters[0]].impl(), characters, length))
-        return m_recentIdentifiers[characters[0]];
-    m_recentIdentifiers[characters[0]] = Identifier(&m_exec->globalData(), characters, length);
-    return m_recentIdentifiers[characters[0]];
+    Identifier& recent = m_recentIdentifiers[recentCacheIndex(characters, length, MaximumCachableCharacter)];
+    if (!recent.isNull() && Identifier::equal(recent.impl(), characters, length))
+        return recent;
+    recent = Identifier(&m_exec->globalData(), characters, length);
+    return recent;
+}
+
+// String values are not property names, so there is no point in adding them
+// to the identifier table. Repeated values still share their characters.
+ALWAYS_INLINE JSValue LiteralParser::makeJSString(const UChar* characters, size_t length)
+{
+    if (!length)
+        return jsEmptyString(m_exec);
+    if (length == 1)
+        return jsSingleCharacterString(m_exec, characters[0]);
+
+    UString& recent = m_recentStrings[recentCacheIndex(characters, length, MaximumCachableCharacter)];
+    if (recent.isNull() || !Identifier::equal(recent.impl(), characters, length))
+        recent = UString(characters, length);
+    return jsString(m_exec, recent);
 }
 
 template <LiteralParser::ParserMode mode> LiteralParser::TokenType LiteralParser::Lexer::lex(LiteralParserToken& token)
@@ -593,7 +616,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     case TokString: {
                         Lexer::LiteralParserToken stringToken = m_lexer.currentToken();
                         m_lexer.next();
-                        lastValue = jsString(m_exec, makeIdentifier(stringToken.stringToken, stringToken.stringLength).ustring());
+                        lastValue = makeJSString(stringToken.stringToken, stringToken.stringLength);
                         break;
                     }
                     case TokNumber: {
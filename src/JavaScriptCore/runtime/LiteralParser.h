@@ -146,7 +146,9 @@ namespace JSC {
         static unsigned const MaximumCachableCharacter = 128;
         FixedArray<Identifier, MaximumCachableCharacter> m_shortIdentifiers;
         FixedArray<Identifier, MaximumCachableCharacter> m_recentIdentifiers;
+        FixedArray<UString, MaximumCachableCharacter> m_recentStrings;
         ALWAYS_INLINE const Identifier makeIdentifier(const UChar* characters, size_t length);
+        ALWAYS_INLINE JSValue makeJSString(const UChar* characters, size_t length);
     };
 
 }
@@ -231,6 +231,8 @@ RegExp::RegExp(JSGlobalData& globalData, const UString& patternString, RegExpFla
     , m_flags(flags)
     , m_constructionError(0)
     , m_numSubpatterns(0)
+    , m_lastMatch(0)
+    , m_isInStrongCache(false)
 #if ENABLE(REGEXP_TRACING)
     , m_rtMatchCallCount(0)
     , m_rtMatchFoundCount(0)
@@ -280,7 +282,6 @@ void RegExp::compile(JSGlobalData* globalData, Yarr::YarrCharSize charSize)
     if (!m_representation) {
         ASSERT(m_state == NotCompiled);
         m_representation = adoptPtr(new RegExpRepresentation);
-        globalData->regExpCache()->addToStrongCache(this);
         m_state = ByteCode;
     }
 
@@ -343,6 +344,7 @@ int RegExp::match(JSGlobalData& globalData, const UString& s, int startOffset, V
 
     if (m_state != ParseError) {
         compileIfNecessary(globalData, s.is8Bit() ? Yarr::Char8 : Yarr::Char16);
+        globalData.regExpCache()->didMatch(this);
 
         int offsetVectorSize = (m_numSubpatterns + 1) * 2;
         int* offsetVector;
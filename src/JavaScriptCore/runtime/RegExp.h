@@ -103,6 +103,8 @@ namespace JSC {
         RegExpFlags m_flags;
         const char* m_constructionError;
         unsigned m_numSubpatterns;
+        uint64_t m_lastMatch;
+        bool m_isInStrongCache;
 #if ENABLE(REGEXP_TRACING)
         unsigned m_rtMatchCallCount;
         unsigned m_rtMatchFoundCount;
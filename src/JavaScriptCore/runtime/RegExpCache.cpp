@@ -51,7 +51,7 @@ RegExp* RegExpCache::lookupOrCreate(const UString& patternString, RegExpFlags fl
 }
 
 RegExpCache::RegExpCache(JSGlobalData* globalData)
-    : m_nextEntryInStrongCache(0)
+    : m_matchCount(0)
     , m_globalData(globalData)
 {
 }
@@ -65,20 +65,33 @@ void RegExpCache::finalize(Handle<Unknown> handle, void*)
 
 void RegExpCache::addToStrongCache(RegExp* regExp)
 {
-    UString pattern = regExp->pattern();
-    if (pattern.length() > maxStrongCacheablePatternLength)
+    if (regExp->pattern().length() > maxStrongCacheablePatternLength)
         return;
-    m_strongCache[m_nextEntryInStrongCache].set(*m_globalData, regExp);
-    m_nextEntryInStrongCache++;
-    if (m_nextEntryInStrongCache == maxStrongCacheableEntries)
-        m_nextEntryInStrongCache = 0;
+
+    // Take an empty slot if there is one, otherwise evict the least recently executed entry.
+    int victim = 0;
+    for (int i = 0; i < maxStrongCacheableEntries; i++) {
+        RegExp* entry = m_strongCache[i].get();
+        if (!entry) {
+            victim = i;
+            break;
+        }
+        if (entry->m_lastMatch < m_strongCache[victim]->m_lastMatch)
+            victim = i;
+    }
+    if (RegExp* evicted = m_strongCache[victim].get())
+        evicted->m_isInStrongCache = false;
+    m_strongCache[victim].set(*m_globalData, regExp);
+    regExp->m_isInStrongCache = true;
 }
 
 void RegExpCache::invalidateCode()
 {
-    for (int i = 0; i < maxStrongCacheableEntries; i++)
+    for (int i = 0; i < maxStrongCacheableEntries; i++) {
+        if (RegExp* regExp = m_strongCache[i].get())
+            regExp->m_isInStrongCache = false;
         m_strongCache[i].clear();
-    m_nextEntryInStrongCache = 0;
+    }
     RegExpCacheMap::iterator end = m_weakCache.end();
     for (RegExpCacheMap::iterator ptr = m_weakCache.begin(); ptr != end; ++ptr)
         ptr->second->invalidateCode();
@@ -55,13 +55,24 @@ private:
     virtual void finalize(Handle<Unknown>, void* context);
 
     RegExp* lookupOrCreate(const UString& patternString, RegExpFlags);
+    void didMatch(RegExp*);
     void addToStrongCache(RegExp*);
     RegExpCacheMap m_weakCache; // Holds all regular expressions currently live.
-    int m_nextEntryInStrongCache;
-    WTF::FixedArray<Strong<RegExp>, maxStrongCacheableEntries> m_strongCache; // Holds a select few regular expressions that have compiled and executed
+    uint64_t m_matchCount; // Stamps each regular expression as it executes, so the least recently used one can be evicted.
+    WTF::FixedArray<Strong<RegExp>, maxStrongCacheableEntries> m_strongCache; // Holds the most recently executed regular expressions
     JSGlobalData* m_globalData;
 };
 
+inline void RegExpCache::didMatch(RegExp* regExp)
+{
+    // Patterns only enter the strong cache when they are matched a second time,
+    // so a burst of one-off patterns cannot push the hot ones out.
+    bool matchedBefore = regExp->m_lastMatch;
+    regExp->m_lastMatch = ++m_matchCount;
+    if (matchedBefore && !regExp->m_isInStrongCache)
+        addToStrongCache(regExp);
+}
+
 } // namespace JSC
 
 #endif // RegExpCache_h
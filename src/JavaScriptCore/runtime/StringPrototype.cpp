@@ -781,10 +781,21 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSearch(ExecState* exec)
 EncodedJSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec)
 {
     JSValue thisValue = exec->hostThisValue();
-    if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
+    int len;
+    JSString* jsString = 0;
+    UString s;
+    if (thisValue.isString()) {
+        jsString = static_cast<JSString*>(thisValue.asCell());
+        len = jsString->length();
+    } else if (thisValue.isUndefinedOrNull()) {
+        // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toString(exec);
-    int len = s.length();
+    } else {
+        s = thisValue.toString(exec);
+        if (exec->hadException())
+            return JSValue::encode(jsUndefined());
+        len = s.length();
+    }
 
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
@@ -799,6 +810,8 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec)
             from = 0;
         if (to > len)
             to = len;
+        if (jsString)
+            return JSValue::encode(jsSubstring(exec, jsString, static_cast<unsigned>(from), static_cast<unsigned>(to) - static_cast<unsigned>(from)));
         return JSValue::encode(jsSubstring(exec, s, static_cast<unsigned>(from), static_cast<unsigned>(to) - static_cast<unsigned>(from)));
     }
 
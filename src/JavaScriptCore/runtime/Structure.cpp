@@ -544,6 +544,42 @@ Structure* Structure::flattenDictionaryStructure(JSGlobalData& globalData, JSObj
     return this;
 }
 
+// Finds the structure that an object with this dictionary's properties would have had if they
+// had been added to emptyStructure in the same order, without any deletes. Objects that lost
+// the same property then end up sharing a structure again, instead of each having a flattened
+// copy of its own. Returns 0 if there is no such structure that fits in the object's storage.
+Structure* Structure::sharedStructureForDictionary(JSGlobalData& globalData, Structure* emptyStructure, Vector<size_t, 8>& oldOffsets, Vector<size_t, 8>& newOffsets)
+{
+    ASSERT(isUncacheableDictionary());
+    ASSERT(m_propertyTable);
+    ASSERT(!emptyStructure->isDictionary());
+
+    if (m_hasGetterSetterProperties || m_preventExtensions || m_propertyTable->size() > static_cast<unsigned>(s_maxTransitionLength))
+        return 0;
+
+    Structure* structure = emptyStructure;
+    PropertyTable::iterator end = m_propertyTable->end();
+    for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
+        Identifier propertyName(&globalData, iter->key);
+        size_t offset;
+        Structure* transition = addPropertyTransitionToExistingStructure(structure, propertyName, iter->attributes, 0, offset);
+        if (!transition) {
+            structure->materializePropertyMapIfNecessary(globalData);
+            transition = addPropertyTransition(globalData, structure, propertyName, iter->attributes, 0, offset);
+            if (transition->isDictionary())
+                return 0;
+        }
+        oldOffsets.append(iter->offset);
+        newOffsets.append(offset);
+        structure = transition;
+    }
+
+    if (structure->m_propertyStorageCapacity > m_propertyStorageCapacity)
+        return 0;
+
+    return structure;
+}
+
 size_t Structure::addPropertyWithoutTransition(JSGlobalData& globalData, const Identifier& propertyName, unsigned attributes, JSCell* specificValue)
 {
     ASSERT(!m_enumerationCache);
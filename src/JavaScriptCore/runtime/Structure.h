@@ -107,6 +107,7 @@ namespace JSC {
         bool didTransition() const { return m_didTransition; }
 
         Structure* flattenDictionaryStructure(JSGlobalData&, JSObject*);
+        Structure* sharedStructureForDictionary(JSGlobalData&, Structure* emptyStructure, Vector<size_t, 8>& oldOffsets, Vector<size_t, 8>& newOffsets);
 
         ~Structure();
 
@@ -32,6 +32,8 @@
 
 #include "CallFrame.h"
 #include "JSGlobalObject.h"
+#include "SamplingProfiler.h"
+#include <limits>
 
 #if OS(DARWIN)
 #include <mach/mach.h>
@@ -48,7 +50,7 @@ namespace JSC {
 // Number of ticks before the first timeout check is done.
 static const int ticksUntilFirstCheck = 1024;
 
-// Number of milliseconds between each timeout check.
+// Default number of milliseconds between each timeout check.
 static const int intervalBetweenChecks = 1000;
 
 // Returns the time the current thread has spent executing, in milliseconds.
@@ -91,6 +93,8 @@ static inline unsigned getCPUTime()
 
 TimeoutChecker::TimeoutChecker()
     : m_timeoutInterval(0)
+    , m_checkInterval(intervalBetweenChecks)
+    , m_samplingProfiler(0)
     , m_startCount(0)
 {
     reset();
@@ -114,16 +118,28 @@ bool TimeoutChecker::didTimeOut(ExecState* exec)
     }
     
     unsigned timeDiff = currentTime - m_timeAtLastCheck;
+
+    // With a sampling profiler attached the check interval can be as short as
+    // the clock's resolution. Rather than record a sample for time that was
+    // not measured, keep the last check time and check less often.
+    if (!timeDiff && m_samplingProfiler) {
+        if (m_ticksUntilNextCheck < numeric_limits<unsigned>::max() / 2)
+            m_ticksUntilNextCheck *= 2;
+        return false;
+    }
     
     if (timeDiff == 0)
         timeDiff = 1;
     
     m_timeExecuting += timeDiff;
     m_timeAtLastCheck = currentTime;
+
+    if (m_samplingProfiler)
+        m_samplingProfiler->takeSample(exec, timeDiff);
     
     // Adjust the tick threshold so we get the next checkTimeout call in the
-    // interval specified in intervalBetweenChecks.
-    m_ticksUntilNextCheck = static_cast<unsigned>((static_cast<float>(intervalBetweenChecks) / timeDiff) * m_ticksUntilNextCheck);
+    // interval specified in m_checkInterval.
+    m_ticksUntilNextCheck = static_cast<unsigned>((static_cast<float>(m_checkInterval) / timeDiff) * m_ticksUntilNextCheck);
     // If the new threshold is 0 reset it to the default threshold. This can happen if the timeDiff is higher than the
     // preferred script check time interval.
     if (m_ticksUntilNextCheck == 0)
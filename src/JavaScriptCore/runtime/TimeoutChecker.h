@@ -34,6 +34,7 @@
 namespace JSC {
 
     class ExecState;
+    class SamplingProfiler;
 
     class TimeoutChecker {
     public:
@@ -41,6 +42,14 @@ namespace JSC {
 
         void setTimeoutInterval(unsigned timeoutInterval) { m_timeoutInterval = timeoutInterval; }
         unsigned timeoutInterval() const { return m_timeoutInterval; }
+
+        // Target CPU time, in milliseconds, between two calls to didTimeOut().
+        void setCheckInterval(unsigned checkInterval) { m_checkInterval = checkInterval; }
+        unsigned checkInterval() const { return m_checkInterval; }
+
+        // While set, every check also records the current call stack.
+        void setSamplingProfiler(SamplingProfiler* samplingProfiler) { m_samplingProfiler = samplingProfiler; }
+        SamplingProfiler* samplingProfiler() const { return m_samplingProfiler; }
         
         unsigned ticksUntilNextCheck() { return m_ticksUntilNextCheck; }
         
@@ -63,6 +72,8 @@ namespace JSC {
 
     private:
         unsigned m_timeoutInterval;
+        unsigned m_checkInterval;
+        SamplingProfiler* m_samplingProfiler;
         unsigned m_timeAtLastCheck;
         unsigned m_timeExecuting;
         unsigned m_startCount;
@@ -24,6 +24,7 @@
 #include "CurrentTime.h"
 #include "InitializeThreading.h"
 #include "JSGlobalObject.h"
+#include "StrongInlines.h"
 #include "UStringBuilder.h"
 #include <errno.h>
 #include <stdio.h>
@@ -60,11 +61,13 @@ struct Options {
     Options()
         : interactive(false)
         , verbose(false)
+        , iterations(1)
     {
     }
 
     bool interactive;
     bool verbose;
+    unsigned iterations;
     Vector<UString> arguments;
     Vector<UString> files;
 };
@@ -108,6 +111,12 @@ struct RegExpTest {
     Vector<int, 32> expectVector;
 };
 
+struct RegExpTestCase {
+    Strong<RegExp> regexp;
+    RegExpTest* test;
+    unsigned lineNumber;
+};
+
 class GlobalObject : public JSGlobalObject {
 private:
     GlobalObject(JSGlobalData&, Structure*, const Vector<UString>& arguments);
@@ -399,7 +408,19 @@ static RegExpTest* parseTestLine(char* line, int lineLength)
     return result;
 }
 
-static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& files, bool verbose)
+static void runTestCases(JSGlobalData& globalData, Vector<RegExpTestCase>& testCases, unsigned iterations)
+{
+    StopWatch stopWatch;
+    stopWatch.start();
+    for (unsigned i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < testCases.size(); ++j)
+            testOneRegExp(globalData, testCases[j].regexp.get(), testCases[j].test, false, testCases[j].lineNumber);
+    }
+    stopWatch.stop();
+    printf("%u iterations of %lu tests in %ld ms\n", iterations, testCases.size(), stopWatch.getElapsedMS());
+}
+
+static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& files, bool verbose, unsigned iterations)
 {
     UString script;
     UString fileName;
@@ -407,6 +428,7 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& file
     unsigned tests = 0;
     unsigned failures = 0;
     char* lineBuffer = new char[MaxLineLength + 1];
+    Vector<RegExpTestCase> testCases;
 
     JSGlobalData& globalData = globalObject->globalData();
 
@@ -446,6 +468,14 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& file
                         failures++;
                         printf("Failure on line %u\n", lineNumber);
                     }
+                    if (iterations > 1) {
+                        RegExpTestCase testCase;
+                        testCase.regexp.set(globalData, regexp);
+                        testCase.test = regExpTest;
+                        testCase.lineNumber = lineNumber;
+                        testCases.append(testCase);
+                        continue;
+                    }
                 }
                 
                 if (regExpTest)
@@ -461,6 +491,12 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& file
     else
         printf("%u tests passed\n", tests);
 
+    if (iterations > 1) {
+        runTestCases(globalData, testCases, iterations);
+        for (size_t i = 0; i < testCases.size(); ++i)
+            delete testCases[i].test;
+    }
+
     delete[] lineBuffer;
 
     globalData.dumpSampleData(globalObject->globalExec());
@@ -477,6 +513,7 @@ static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help =
     fprintf(stderr, "Usage: regexp_test [options] file\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -v|--verbose  Verbose output\n");
+    fprintf(stderr, "  -i|--iterations <count>  Time <count> runs of all tests after checking them once\n");
 
     cleanupGlobalData(globalData);
     exit(help ? EXIT_SUCCESS : EXIT_FAILURE);
@@ -491,7 +528,11 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             printUsageStatement(globalData, true);
         if (!strcmp(arg, "-v") || !strcmp(arg, "--verbose"))
             options.verbose = true;
-        else
+        else if (!strcmp(arg, "-i") || !strcmp(arg, "--iterations")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            options.iterations = std::max(atoi(argv[i]), 1);
+        } else
             options.files.append(argv[i]);
     }
 
@@ -507,7 +548,7 @@ int realMain(int argc, char** argv, JSGlobalData* globalData)
     parseArguments(argc, argv, options, globalData);
 
     GlobalObject* globalObject = GlobalObject::create(*globalData, GlobalObject::createStructure(*globalData, jsNull()), options.arguments);
-    bool success = runFromFiles(globalObject, options.files, options.verbose);
+    bool success = runFromFiles(globalObject, options.files, options.verbose, options.iterations);
 
     return success ? 0 : 3;
 }
@@ -116,6 +116,38 @@ inline int atomicDecrement(int volatile* addend) { return __gnu_cxx::__exchange_
 
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+// Stores newValue if *location still holds expected. Returns false, without
+// writing, when another thread got there first; callers simply retry.
+inline bool weakCompareAndSwap(unsigned volatile* location, unsigned expected, unsigned newValue)
+{
+#if OS(WINDOWS)
+    return InterlockedCompareExchange(reinterpret_cast<long volatile*>(location), static_cast<long>(newValue), static_cast<long>(expected)) == static_cast<long>(expected);
+#elif OS(DARWIN)
+    return OSAtomicCompareAndSwap32Barrier(static_cast<int32_t>(expected), static_cast<int32_t>(newValue), reinterpret_cast<int32_t volatile*>(location));
+#else
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+#endif
+}
+
+// weakCompareAndSwap already orders memory on x86; these only have to keep the
+// compiler from moving accesses out of a critical section.
+#if CPU(ARM_THUMB2)
+inline void memoryBarrierAfterLock() { asm volatile("dmb" ::: "memory"); }
+inline void memoryBarrierBeforeUnlock() { asm volatile("dmb" ::: "memory"); }
+#elif COMPILER(GCC)
+inline void memoryBarrierAfterLock() { asm volatile("" ::: "memory"); }
+inline void memoryBarrierBeforeUnlock() { asm volatile("" ::: "memory"); }
+#elif COMPILER(MSVC)
+inline void memoryBarrierAfterLock() { _ReadWriteBarrier(); }
+inline void memoryBarrierBeforeUnlock() { _ReadWriteBarrier(); }
+#else
+inline void memoryBarrierAfterLock() { }
+inline void memoryBarrierBeforeUnlock() { }
+#endif
+#endif
+
+
 } // namespace WTF
 
 #if USE(LOCKFREE_THREADSAFEREFCOUNTED)
@@ -123,4 +155,8 @@ using WTF::atomicDecrement;
 using WTF::atomicIncrement;
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+using WTF::weakCompareAndSwap;
+#endif
+
 #endif // Atomics_h
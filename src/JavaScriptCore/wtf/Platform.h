@@ -163,6 +163,11 @@
 #define WTF_CPU_X86_64 1
 #endif
 
+/* CPU(X86_SSE2) - SSE2 can be used without a runtime check */
+#if CPU(X86_64) || (CPU(X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#define WTF_CPU_X86_SSE2 1
+#endif
+
 /* CPU(ARM) - ARM, any version*/
 #if   defined(arm) \
     || defined(__arm__) \
@@ -871,12 +876,12 @@
 #define ENABLE_JIT 1
 #endif
 
-/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) */
-#if !defined(ENABLE_DFG_JIT) && ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
+/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) and Linux x86-64 */
+#if !defined(ENABLE_DFG_JIT) && ENABLE(JIT) && USE(JSVALUE64) && (PLATFORM(MAC) || (OS(LINUX) && CPU(X86_64)))
 #define ENABLE_DFG_JIT 1
 #endif
 
-/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC). */
+/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) and Linux x86-64. */
 #if !defined(ENABLE_VALUE_PROFILER) && ENABLE(DFG_JIT)
 #define ENABLE_VALUE_PROFILER 1
 #endif
@@ -889,6 +894,15 @@
 #define ENABLE_SIMPLE_HEAP_PROFILING 0
 #endif
 
+/* Functions start out in the interpreter and are baseline compiled on a background
+   thread once they have been called often enough, so the interpreter is built too. */
+#if !defined(ENABLE_BACKGROUND_JIT) && ENABLE(JIT) && CPU(X86_64) && (OS(DARWIN) || OS(LINUX))
+#define ENABLE_BACKGROUND_JIT 1
+#endif
+#if ENABLE(BACKGROUND_JIT) && !defined(ENABLE_INTERPRETER)
+#define ENABLE_INTERPRETER 1
+#endif
+
 /* Ensure that either the JIT or the interpreter has been enabled. */
 #if !defined(ENABLE_INTERPRETER) && !ENABLE(JIT)
 #define ENABLE_INTERPRETER 1
@@ -1037,10 +1051,29 @@
 #define ENABLE_THREADING_OPENMP 1
 #endif
 
+/* The filter effects split large images into parallel jobs; use WTF's own thread pool unless another backend was chosen. */
+#if !defined(ENABLE_THREADING_GENERIC) && !ENABLE(THREADING_OPENMP) && !ENABLE(THREADING_LIBDISPATCH) && (OS(WINDOWS) || OS(LINUX))
+#define ENABLE_THREADING_GENERIC 1
+#endif
+
 #if !defined(ENABLE_PARALLEL_JOBS) && (ENABLE(THREADING_GENERIC) || ENABLE(THREADING_LIBDISPATCH) || ENABLE(THREADING_OPENMP))
 #define ENABLE_PARALLEL_JOBS 1
 #endif
 
+#if !defined(ENABLE_COMPARE_AND_SWAP) && (OS(WINDOWS) || OS(DARWIN) || (COMPILER(GCC) && (CPU(X86) || CPU(X86_64) || CPU(ARM_THUMB2))))
+#define ENABLE_COMPARE_AND_SWAP 1
+#endif
+
+#if !defined(ENABLE_PARALLEL_GC) && ENABLE(COMPARE_AND_SWAP) && (OS(WINDOWS) || OS(DARWIN) || OS(LINUX))
+#define ENABLE_PARALLEL_GC 1
+#endif
+
+/* Generational collection: most collections only trace the cells allocated since
+   the previous one, plus old cells whose cards the write barrier has dirtied. */
+#if !defined(ENABLE_GGC)
+#define ENABLE_GGC 1
+#endif
+
 #if ENABLE(GLIB_SUPPORT)
 #include "GTypedefs.h"
 #endif
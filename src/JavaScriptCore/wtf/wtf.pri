@@ -62,6 +62,7 @@ HEADERS += \
     wtf/NonCopyingSort.h \
     wtf/NotFound.h \
     wtf/NullPtr.h \
+    wtf/NumberOfCores.h \
     wtf/OSAllocator.h \
     wtf/OSRandomSource.h \
     wtf/OwnArrayPtr.h \
@@ -159,6 +160,7 @@ SOURCES += \
     wtf/MainThread.cpp \
     wtf/MetaAllocator.cpp \
     wtf/NullPtr.cpp \
+    wtf/NumberOfCores.cpp \
     wtf/OSRandomSource.cpp \
     wtf/qt/MainThreadQt.cpp \
     wtf/qt/StringQt.cpp \
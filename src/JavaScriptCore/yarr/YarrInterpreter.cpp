@@ -345,6 +345,9 @@ public:
 
     bool testCharacterClass(CharacterClass* characterClass, int ch)
     {
+        if (characterClass->m_latin1Table && !(ch & 0xFF00))
+            return characterClass->m_latin1Table->m_table[ch];
+
         if (ch & 0xFF80) {
             for (unsigned i = 0; i < characterClass->m_matchesUnicode.size(); ++i)
                 if (ch == characterClass->m_matchesUnicode[i])
@@ -158,6 +158,44 @@ class YarrGenerator : private MacroAssembler {
         } while (count);
     }
 
+    void matchCharacterClassWithLatin1Table(RegisterID character, JumpList& matchDest, const CharacterClass* charClass)
+    {
+        m_latin1Tables.append(charClass->m_latin1Table);
+        ExtendedAddress tableEntry(character, reinterpret_cast<intptr_t>(charClass->m_latin1Table->m_table));
+
+        // An 8-bit subject never holds anything above 0xff.
+        if (m_charSize == Char8) {
+            matchDest.append(branchTest8(NonZero, tableEntry));
+            return;
+        }
+
+        Jump aboveLatin1 = branch32(Above, character, TrustedImm32(0xff));
+        matchDest.append(branchTest8(NonZero, tableEntry));
+        Jump latin1Fail = jump();
+        aboveLatin1.link(this);
+
+        for (unsigned i = 0; i < charClass->m_matchesUnicode.size(); ++i) {
+            UChar ch = charClass->m_matchesUnicode[i];
+            if (ch > 0xff)
+                matchDest.append(branch32(Equal, character, Imm32(ch)));
+        }
+        for (unsigned i = 0; i < charClass->m_rangesUnicode.size(); ++i) {
+            UChar lo = charClass->m_rangesUnicode[i].begin;
+            UChar hi = charClass->m_rangesUnicode[i].end;
+            if (hi <= 0xff)
+                continue;
+            if (lo <= 0x100) {
+                matchDest.append(branch32(LessThanOrEqual, character, Imm32(hi)));
+                continue;
+            }
+            Jump below = branch32(LessThan, character, Imm32(lo));
+            matchDest.append(branch32(LessThanOrEqual, character, Imm32(hi)));
+            below.link(this);
+        }
+
+        latin1Fail.link(this);
+    }
+
     void matchCharacterClass(RegisterID character, JumpList& matchDest, const CharacterClass* charClass)
     {
         if (charClass->m_table) {
@@ -165,6 +203,10 @@ class YarrGenerator : private MacroAssembler {
             matchDest.append(branchTest8(charClass->m_table->m_inverted ? Zero : NonZero, tableEntry));
             return;
         }
+        if (charClass->m_latin1Table) {
+            matchCharacterClassWithLatin1Table(character, matchDest, charClass);
+            return;
+        }
         Jump unicodeFail;
         if (charClass->m_matchesUnicode.size() || charClass->m_rangesUnicode.size()) {
             Jump isAscii = branch32(LessThanOrEqual, character, TrustedImm32(0x7f));
@@ -2462,6 +2504,7 @@ public:
             jitObject.set8BitCode(linkBuffer.finalizeCode());
         else
             jitObject.set16BitCode(linkBuffer.finalizeCode());
+        jitObject.addLatin1Tables(m_latin1Tables);
         jitObject.setFallBack(m_shouldFallBack);
     }
 
@@ -2479,6 +2522,9 @@ private:
     // The regular expression expressed as a linear sequence of operations.
     Vector<YarrOp, 128> m_ops;
 
+    // Lookup tables the generated code reads; the code block keeps them alive.
+    Vector<RefPtr<Latin1CharacterTable> > m_latin1Tables;
+
     // This records the current input offset being applied due to the current
     // set of alternatives we are nested within. E.g. when matching the
     // character 'b' within the regular expression /abc/, we will know that
@@ -67,6 +67,7 @@ public:
     bool has16BitCode() { return m_ref16.size(); }
     void set8BitCode(MacroAssembler::CodeRef ref) { m_ref8 = ref; }
     void set16BitCode(MacroAssembler::CodeRef ref) { m_ref16 = ref; }
+    void addLatin1Tables(const Vector<RefPtr<Latin1CharacterTable> >& tables) { m_latin1Tables.append(tables); }
 
     int execute(const char* input, unsigned start, unsigned length, int* output)
     {
@@ -86,6 +87,7 @@ public:
 private:
     MacroAssembler::CodeRef m_ref8;
     MacroAssembler::CodeRef m_ref16;
+    Vector<RefPtr<Latin1CharacterTable> > m_latin1Tables;
     bool m_needFallBack;
 };
 
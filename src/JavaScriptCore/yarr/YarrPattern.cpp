@@ -148,6 +148,7 @@ public:
         characterClass->m_ranges.append(m_ranges);
         characterClass->m_matchesUnicode.append(m_matchesUnicode);
         characterClass->m_rangesUnicode.append(m_rangesUnicode);
+        characterClass->m_latin1Table = createLatin1Table();
 
         reset();
 
@@ -155,6 +156,38 @@ public:
     }
 
 private:
+    static const unsigned maxLatin1ComparesWithoutTable = 4;
+
+    PassRefPtr<Latin1CharacterTable> createLatin1Table()
+    {
+        unsigned compares = m_matches.size() + m_ranges.size();
+        for (unsigned i = 0; i < m_matchesUnicode.size() && m_matchesUnicode[i] <= 0xff; ++i)
+            ++compares;
+        for (unsigned i = 0; i < m_rangesUnicode.size(); ++i) {
+            if (m_rangesUnicode[i].begin <= 0xff)
+                ++compares;
+        }
+        if (compares <= maxLatin1ComparesWithoutTable)
+            return 0;
+
+        RefPtr<Latin1CharacterTable> table = Latin1CharacterTable::create();
+        for (unsigned i = 0; i < m_matches.size(); ++i)
+            table->m_table[m_matches[i]] = 1;
+        for (unsigned i = 0; i < m_ranges.size(); ++i) {
+            for (unsigned ch = m_ranges[i].begin; ch <= m_ranges[i].end; ++ch)
+                table->m_table[ch] = 1;
+        }
+        for (unsigned i = 0; i < m_matchesUnicode.size(); ++i) {
+            if (m_matchesUnicode[i] <= 0xff)
+                table->m_table[m_matchesUnicode[i]] = 1;
+        }
+        for (unsigned i = 0; i < m_rangesUnicode.size(); ++i) {
+            for (unsigned ch = m_rangesUnicode[i].begin; ch <= m_rangesUnicode[i].end && ch <= 0xff; ++ch)
+                table->m_table[ch] = 1;
+        }
+        return table.release();
+    }
+
     void addSorted(Vector<UChar>& matches, UChar ch)
     {
         unsigned pos = 0;
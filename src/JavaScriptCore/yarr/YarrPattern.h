@@ -63,6 +63,21 @@ private:
     }
 };
 
+// One byte per Latin-1 character, non-zero for the characters in a class.
+struct Latin1CharacterTable : RefCounted<Latin1CharacterTable> {
+    char m_table[256];
+    static PassRefPtr<Latin1CharacterTable> create()
+    {
+        return adoptRef(new Latin1CharacterTable);
+    }
+
+private:
+    Latin1CharacterTable()
+    {
+        memset(m_table, 0, sizeof(m_table));
+    }
+};
+
 struct CharacterClass {
     WTF_MAKE_FAST_ALLOCATED;
 public:
@@ -78,6 +93,9 @@ public:
     Vector<UChar> m_matchesUnicode;
     Vector<CharacterRange> m_rangesUnicode;
     RefPtr<CharacterClassTable> m_table;
+    // Built for classes that would otherwise take several compares to test
+    // a Latin-1 character; characters above 0xff still use the lists above.
+    RefPtr<Latin1CharacterTable> m_latin1Table;
 };
 
 enum QuantifierType {
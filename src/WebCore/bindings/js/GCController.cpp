@@ -84,4 +84,14 @@ void GCController::garbageCollectOnAlternateThreadForDebugging(bool waitUntilDon
     detachThread(threadID);
 }
 
+bool GCController::sweepIncrementally(double timeLimit)
+{
+    // Don't create the heap just to find it empty.
+    if (!JSDOMWindow::hasCommonJSGlobalData())
+        return false;
+
+    JSLock lock(SilenceAssertionsOnly);
+    return JSDOMWindow::commonJSGlobalData()->heap.sweepIncrementally(timeLimit);
+}
+
 } // namespace WebCore
@@ -40,6 +40,11 @@ namespace WebCore {
 
         void garbageCollectOnAlternateThreadForDebugging(bool waitUntilDone); // Used for stress testing.
 
+        // Runs the destructors of objects the last collection found dead, for
+        // at most timeLimit seconds. Meant to be called when the embedder is
+        // idle; returns true if there is more to do.
+        bool sweepIncrementally(double timeLimit);
+
     private:
         GCController(); // Use gcController() instead
         void gcTimerFired(Timer<GCController>*);
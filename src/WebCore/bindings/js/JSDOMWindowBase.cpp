@@ -155,21 +155,27 @@ JSDOMWindowShell* JSDOMWindowBase::shell() const
     return m_shell;
 }
 
+static JSGlobalData* s_commonJSGlobalData;
+
 JSGlobalData* JSDOMWindowBase::commonJSGlobalData()
 {
     ASSERT(isMainThread());
 
-    static JSGlobalData* globalData = 0;
-    if (!globalData) {
-        globalData = JSGlobalData::createLeaked(ThreadStackTypeLarge, LargeHeap).leakRef();
-        globalData->timeoutChecker.setTimeoutInterval(10000); // 10 seconds
+    if (!s_commonJSGlobalData) {
+        s_commonJSGlobalData = JSGlobalData::createLeaked(ThreadStackTypeLarge, LargeHeap).leakRef();
+        s_commonJSGlobalData->timeoutChecker.setTimeoutInterval(10000); // 10 seconds
 #ifndef NDEBUG
-        globalData->exclusiveThread = currentThread();
+        s_commonJSGlobalData->exclusiveThread = currentThread();
 #endif
-        initNormalWorldClientData(globalData);
+        initNormalWorldClientData(s_commonJSGlobalData);
     }
 
-    return globalData;
+    return s_commonJSGlobalData;
+}
+
+bool JSDOMWindowBase::hasCommonJSGlobalData()
+{
+    return s_commonJSGlobalData;
 }
 
 // JSDOMGlobalObject* is ignored, accessing a window in any context will
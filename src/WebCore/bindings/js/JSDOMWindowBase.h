@@ -72,6 +72,7 @@ namespace WebCore {
         JSDOMWindowShell* shell() const;
 
         static JSC::JSGlobalData* commonJSGlobalData();
+        static bool hasCommonJSGlobalData();
 
     private:
         RefPtr<DOMWindow> m_impl;
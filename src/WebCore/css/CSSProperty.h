@@ -62,6 +62,7 @@ public:
     String cssText() const;
 
     static int resolveDirectionAwareProperty(int propertyID, TextDirection, WritingMode);
+    static bool isInheritedProperty(int propertyID);
 
     friend bool operator==(const CSSProperty&, const CSSProperty&);
 
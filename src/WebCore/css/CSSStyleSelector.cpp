@@ -42,6 +42,7 @@
 #include "CSSPageRule.h"
 #include "CSSParser.h"
 #include "CSSPrimitiveValueMappings.h"
+#include "CSSProperty.h"
 #include "CSSPropertyNames.h"
 #include "CSSReflectValue.h"
 #include "CSSRegionStyleRule.h"
@@ -112,6 +113,7 @@
 #include "WebKitFontFamilyNames.h"
 #include "XMLNames.h"
 #include <wtf/StdLibExtras.h>
+#include <wtf/StringHasher.h>
 #include <wtf/Vector.h>
 
 #if ENABLE(DASHBOARD_SUPPORT)
@@ -200,20 +202,33 @@ public:
     unsigned specificity() const { return m_specificity; }
     unsigned linkMatchType() const { return m_linkMatchType; }
 
+    // Cheap tests derived from the rightmost compound selector. An element that fails them
+    // cannot match the rule, so most candidates never reach the SelectorChecker.
+    bool subjectHintsMatch(const Element*) const;
+    // The hints are the whole selector, so an HTML element that passes them matches.
+    bool isFullyCheckedBySubjectHints() const { return m_isFullyCheckedBySubjectHints; }
+
     // Try to balance between memory usage (there can be lots of RuleData objects) and good filtering performance.
     static const unsigned maximumIdentifierCount = 4;
     const unsigned* descendantSelectorIdentifierHashes() const { return m_descendantSelectorIdentifierHashes; }
 
 private:
+    void collectSubjectHints();
+
     CSSStyleRule* m_rule;
     CSSSelector* m_selector;
     unsigned m_specificity;
-    unsigned m_position : 26;
+    unsigned m_position : 25;
     bool m_hasFastCheckableSelector : 1;
     bool m_hasMultipartSelector : 1;
     bool m_hasRightmostSelectorMatchingHTMLBasedOnRuleHash : 1;
     bool m_containsUncommonAttributeSelector : 1;
+    bool m_isFullyCheckedBySubjectHints : 1;
     unsigned m_linkMatchType : 2; //  SelectorChecker::LinkMatchMask
+    AtomicStringImpl* m_subjectTagName;
+    AtomicStringImpl* m_subjectId;
+    AtomicStringImpl* m_subjectClass;
+    const QualifiedName* m_subjectAttribute;
     // Use plain array instead of a Vector to minimize memory overhead.
     unsigned m_descendantSelectorIdentifierHashes[maximumIdentifierCount];
 };
@@ -338,6 +353,7 @@ CSSStyleSelector::CSSStyleSelector(Document* document, StyleSheetList* styleShee
                                    CSSStyleSheet* pageUserSheet, const Vector<RefPtr<CSSStyleSheet> >* pageGroupUserSheets, const Vector<RefPtr<CSSStyleSheet> >* documentUserSheets,
                                    bool strictParsing, bool matchAuthorAndUserStyles)
     : m_backgroundData(BackgroundFillLayer)
+    , m_matchedDeclarationCacheAdditionsSinceLastSweep(0)
     , m_checker(document, strictParsing)
     , m_element(0)
     , m_styledElement(0)
@@ -701,6 +717,8 @@ void CSSStyleSelector::matchRulesForList(const Vector<RuleData>* rules, int& fir
     unsigned size = rules->size();
     for (unsigned i = 0; i < size; ++i) {
         const RuleData& ruleData = rules->at(i);
+        if (!ruleData.subjectHintsMatch(m_element))
+            continue;
         if (canUseFastReject && m_checker.fastRejectSelector<RuleData::maximumIdentifierCount>(ruleData.descendantSelectorIdentifierHashes()))
             continue;
         if (checkSelector(ruleData)) {
@@ -805,6 +823,8 @@ void CSSStyleSelector::matchAllRules(MatchResult& result)
             if (result.firstAuthorRule == -1)
                 result.firstAuthorRule = result.lastAuthorRule;
             addMatchedDeclaration(inlineDecl);
+            // Inline style is edited in place, so its address does not identify its contents.
+            result.isCacheable = false;
         }
     }
 }
@@ -1243,9 +1263,6 @@ PassRefPtr<RenderStyle> CSSStyleSelector::styleForElement(Element* element, Rend
     // Clean up our style object's display and text decorations (among other fixups).
     adjustRenderStyle(style(), m_parentStyle, element);
 
-    // Start loading images referenced by this style.
-    loadPendingImages();
-
     initElement(0); // Clear out for the next resolve.
 
     // Now return the style.
@@ -1392,9 +1409,6 @@ PassRefPtr<RenderStyle> CSSStyleSelector::pseudoStyleForElement(PseudoId pseudo,
     // Clean up our style object's display and text decorations (among other fixups).
     adjustRenderStyle(style(), parentStyle, 0);
 
-    // Start loading images referenced by this style.
-    loadPendingImages();
-
     // Now return the style.
     return m_style.release();
 }
@@ -1712,6 +1726,11 @@ inline bool CSSStyleSelector::checkSelector(const RuleData& ruleData)
     m_dynamicPseudo = NOPSEUDO;
     m_checker.clearHasUnknownPseudoElements();
 
+    // matchRulesForList has already tested the hints.
+    ASSERT(ruleData.subjectHintsMatch(m_element));
+    if (ruleData.isFullyCheckedBySubjectHints() && m_element->isHTMLElement())
+        return m_checker.pseudoStyle() == NOPSEUDO;
+
     // Let the slow path handle SVG as it has some additional rules regarding shadow trees.
     if (ruleData.hasFastCheckableSelector() && !m_element->isSVGElement()) {
         // We know this selector does not include any pseudo elements.
@@ -1803,9 +1822,91 @@ RuleData::RuleData(CSSStyleRule* rule, CSSSelector* selector, unsigned position)
     , m_hasMultipartSelector(selector->tagHistory())
     , m_hasRightmostSelectorMatchingHTMLBasedOnRuleHash(isSelectorMatchingHTMLBasedOnRuleHash(selector))
     , m_containsUncommonAttributeSelector(WebCore::containsUncommonAttributeSelector(selector))
+    , m_isFullyCheckedBySubjectHints(false)
     , m_linkMatchType(SelectorChecker::determineLinkMatchType(selector))
+    , m_subjectTagName(0)
+    , m_subjectId(0)
+    , m_subjectClass(0)
+    , m_subjectAttribute(0)
 {
     SelectorChecker::collectIdentifierHashes(m_selector, m_descendantSelectorIdentifierHashes, maximumIdentifierCount);
+    collectSubjectHints();
+}
+
+void RuleData::collectSubjectHints()
+{
+    bool fullyChecked = true;
+    for (const CSSSelector* selector = m_selector; selector; selector = selector->tagHistory()) {
+        if (selector->hasTag()) {
+            const QualifiedName& tag = selector->tag();
+            if (tag.localName() != starAtom)
+                m_subjectTagName = tag.localName().impl();
+            if (tag.namespaceURI() != starAtom && tag.namespaceURI() != xhtmlNamespaceURI)
+                fullyChecked = false;
+        }
+
+        switch (selector->m_match) {
+        case CSSSelector::None:
+            break;
+        case CSSSelector::Id:
+            // RuleSet::addRule hashes the rule by the first id or class, so the candidate already has it.
+            if (selector == m_selector)
+                break;
+            if (m_subjectId)
+                fullyChecked = false;
+            else
+                m_subjectId = selector->value().impl();
+            break;
+        case CSSSelector::Class:
+            if (selector == m_selector)
+                break;
+            if (m_subjectClass)
+                fullyChecked = false;
+            else
+                m_subjectClass = selector->value().impl();
+            break;
+        default:
+            if (selector->isAttributeSelector() && !m_subjectAttribute) {
+                m_subjectAttribute = &selector->attribute();
+                // A bare [attr] needs nothing beyond the attribute being present.
+                if (selector->m_match == CSSSelector::Set)
+                    break;
+            }
+            fullyChecked = false;
+            break;
+        }
+
+        if (selector->relation() != CSSSelector::SubSelector) {
+            if (selector->tagHistory())
+                fullyChecked = false;
+            break;
+        }
+    }
+    m_isFullyCheckedBySubjectHints = fullyChecked;
+}
+
+inline bool RuleData::subjectHintsMatch(const Element* element) const
+{
+    if (m_subjectTagName && m_subjectTagName != element->localName().impl())
+        return false;
+    if (m_subjectId && (!element->hasID() || m_subjectId != element->idForStyleResolution().impl()))
+        return false;
+    if (m_subjectClass && (!element->hasClass() || !static_cast<const StyledElement*>(element)->classNames().contains(m_subjectClass)))
+        return false;
+    if (m_subjectAttribute) {
+        NamedNodeMap* attributes = element->attributes(true);
+        if (!attributes)
+            return false;
+        size_t size = attributes->length();
+        size_t i = 0;
+        for (; i < size; ++i) {
+            if (SelectorChecker::attributeNameMatches(attributes->attributeItem(i), *m_subjectAttribute))
+                break;
+        }
+        if (i == size)
+            return false;
+    }
+    return true;
 }
 
 RuleSet::RuleSet()
@@ -2082,7 +2183,7 @@ static Length convertToFloatLength(CSSPrimitiveValue* primitiveValue, RenderStyl
 }
 
 template <bool applyFirst>
-void CSSStyleSelector::applyDeclaration(CSSMutableStyleDeclaration* styleDeclaration, bool isImportant)
+void CSSStyleSelector::applyDeclaration(CSSMutableStyleDeclaration* styleDeclaration, bool isImportant, bool inheritedOnly)
 {
     CSSMutableStyleDeclaration::const_iterator end = styleDeclaration->end();
     for (CSSMutableStyleDeclaration::const_iterator it = styleDeclaration->begin(); it != end; ++it) {
@@ -2093,6 +2194,13 @@ void CSSStyleSelector::applyDeclaration(CSSMutableStyleDeclaration* styleDeclara
 
         int property = current.id();
 
+        if (inheritedOnly && !CSSProperty::isInheritedProperty(property)) {
+            // Non-inherited properties that take their value from the parent
+            // keep the matched declarations out of the cache altogether.
+            ASSERT(current.value()->cssValueType() != CSSValue::CSS_INHERIT);
+            continue;
+        }
+
         if (applyFirst) {
             COMPILE_ASSERT(firstCSSProperty == CSSPropertyColor, CSS_color_is_first_property);
             COMPILE_ASSERT(CSSPropertyZoom == CSSPropertyColor + 16, CSS_zoom_is_end_of_first_prop_range);
@@ -2115,7 +2223,7 @@ void CSSStyleSelector::applyDeclaration(CSSMutableStyleDeclaration* styleDeclara
 }
 
 template <bool applyFirst>
-void CSSStyleSelector::applyDeclarations(bool isImportant, int startIndex, int endIndex)
+void CSSStyleSelector::applyDeclarations(bool isImportant, int startIndex, int endIndex, bool inheritedOnly)
 {
     if (startIndex == -1)
         return;
@@ -2128,27 +2236,145 @@ void CSSStyleSelector::applyDeclarations(bool isImportant, int startIndex, int e
             m_applyPropertyToRegularStyle = linkMatchType & SelectorChecker::MatchLink;
             m_applyPropertyToVisitedLinkStyle = linkMatchType & SelectorChecker::MatchVisited;
 
-            applyDeclaration<applyFirst>(styleDeclaration, isImportant);
+            applyDeclaration<applyFirst>(styleDeclaration, isImportant, inheritedOnly);
         }
         m_applyPropertyToRegularStyle = true;
         m_applyPropertyToVisitedLinkStyle = false;
         return;
     }
     for (int i = startIndex; i <= endIndex; ++i)
-        applyDeclaration<applyFirst>(m_matchedDecls[i].styleDeclaration, isImportant);
+        applyDeclaration<applyFirst>(m_matchedDecls[i].styleDeclaration, isImportant, inheritedOnly);
+}
+
+unsigned CSSStyleSelector::computeMatchedDeclarationHash() const
+{
+    StringHasher hasher;
+    for (unsigned i = 0; i < m_matchedDecls.size(); ++i) {
+        uintptr_t pointer = reinterpret_cast<uintptr_t>(m_matchedDecls[i].styleDeclaration);
+        for (unsigned shift = 0; shift < sizeof(pointer) * 8; shift += 32)
+            hasher.addCharacters(static_cast<UChar>(pointer >> shift), static_cast<UChar>(pointer >> (shift + 16)));
+    }
+    // StringHasher never produces 0, which HashMap reserves for empty buckets.
+    return hasher.hash();
+}
+
+const CSSStyleSelector::MatchedDeclarationCacheItem* CSSStyleSelector::findFromMatchedDeclarationCache(unsigned hash, const MatchResult& matchResult) const
+{
+    MatchedDeclarationCache::const_iterator it = m_matchedDeclarationCache.find(hash);
+    if (it == m_matchedDeclarationCache.end())
+        return 0;
+    const MatchedDeclarationCacheItem& cacheItem = it->second;
+
+    size_t size = m_matchedDecls.size();
+    if (size != cacheItem.declarations.size())
+        return 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (m_matchedDecls[i].styleDeclaration != cacheItem.declarations[i])
+            return 0;
+    }
+    if (cacheItem.matchResult.firstUARule != matchResult.firstUARule
+        || cacheItem.matchResult.lastUARule != matchResult.lastUARule
+        || cacheItem.matchResult.firstAuthorRule != matchResult.firstAuthorRule
+        || cacheItem.matchResult.lastAuthorRule != matchResult.lastAuthorRule
+        || cacheItem.matchResult.firstUserRule != matchResult.firstUserRule
+        || cacheItem.matchResult.lastUserRule != matchResult.lastUserRule)
+        return 0;
+    return &cacheItem;
+}
+
+static const unsigned matchedDeclarationCacheAdditionsBetweenSweeps = 100;
+
+void CSSStyleSelector::sweepMatchedDeclarationCache()
+{
+    // Once the cache holds the only reference to one of an entry's declarations,
+    // the attribute or table that produced it is gone and the entry can never
+    // be hit again.
+    Vector<unsigned, 16> toRemove;
+    MatchedDeclarationCache::iterator end = m_matchedDeclarationCache.end();
+    for (MatchedDeclarationCache::iterator it = m_matchedDeclarationCache.begin(); it != end; ++it) {
+        Vector<RefPtr<CSSMutableStyleDeclaration> >& declarations = it->second.declarations;
+        for (size_t i = 0; i < declarations.size(); ++i) {
+            if (declarations[i]->hasOneRef()) {
+                toRemove.append(it->first);
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < toRemove.size(); ++i)
+        m_matchedDeclarationCache.remove(toRemove[i]);
+}
+
+void CSSStyleSelector::addToMatchedDeclarationCache(unsigned hash, const MatchResult& matchResult)
+{
+    if (++m_matchedDeclarationCacheAdditionsSinceLastSweep >= matchedDeclarationCacheAdditionsBetweenSweeps) {
+        sweepMatchedDeclarationCache();
+        m_matchedDeclarationCacheAdditionsSinceLastSweep = 0;
+    }
+
+    MatchedDeclarationCacheItem cacheItem;
+    cacheItem.declarations.reserveInitialCapacity(m_matchedDecls.size());
+    for (size_t i = 0; i < m_matchedDecls.size(); ++i)
+        cacheItem.declarations.uncheckedAppend(m_matchedDecls[i].styleDeclaration);
+    cacheItem.matchResult = matchResult;
+    // m_style is adjusted further once we return, so the cache keeps a clone.
+    // Clones share their data with the original until either one is modified.
+    cacheItem.renderStyle = RenderStyle::clone(m_style.get());
+    cacheItem.parentRenderStyle = RenderStyle::clone(m_parentStyle);
+    m_matchedDeclarationCache.set(hash, cacheItem);
+}
+
+static bool isCacheableInMatchedDeclarationCache(const RenderStyle* style, const RenderStyle* parentStyle)
+{
+    // Unique styles depend on more than the declarations, for instance on an attr() in content.
+    if (style->unique() || (style->styleType() != NOPSEUDO && parentStyle->unique()))
+        return false;
+    // Themed controls are adjusted using state saved while their declarations are applied.
+    if (style->hasAppearance())
+        return false;
+    if (style->zoom() != RenderStyle::initialZoom())
+        return false;
+    // Direction-aware properties such as -webkit-margin-start are resolved into
+    // physical ones while being applied, so they depend on these inherited values.
+    if (style->direction() != RenderStyle::initialDirection() || style->writingMode() != RenderStyle::initialWritingMode())
+        return false;
+    // Cached non-inherited data must not depend on the parent.
+    if (parentStyle->hasExplicitlyInheritedProperties())
+        return false;
+    return true;
 }
 
 void CSSStyleSelector::applyMatchedDeclarations(const MatchResult& matchResult)
 {
+    // Declarations matched by a link are applied differently depending on the
+    // link's visited state, which the cache does not know about. The root
+    // element is its own parent style, so it is left out as well.
+    bool isCacheable = matchResult.isCacheable && !m_matchedDecls.isEmpty()
+        && m_style->insideLink() == NotInsideLink && m_parentStyle != m_style.get();
+    unsigned cacheHash = isCacheable ? computeMatchedDeclarationHash() : 0;
+    bool applyInheritedOnly = false;
+    const MatchedDeclarationCacheItem* cacheItem = 0;
+    if (cacheHash && (cacheItem = findFromMatchedDeclarationCache(cacheHash, matchResult))) {
+        // An earlier element matched exactly these declarations, so its non-inherited
+        // data can be shared as is. Only inherited properties can still differ, as
+        // they depend on the parent.
+        m_style->copyNonInheritedFrom(cacheItem->renderStyle.get());
+        if (m_parentStyle->inheritedDataShared(cacheItem->parentRenderStyle.get())) {
+            // Same parent data, same result. Nothing needs to be applied.
+            m_style->inheritFrom(cacheItem->renderStyle.get());
+            return;
+        }
+        applyInheritedOnly = true;
+    }
+
     // Now we have all of the matched rules in the appropriate order. Walk the rules and apply
     // high-priority properties first, i.e., those properties that other properties depend on.
     // The order is (1) high-priority not important, (2) high-priority important, (3) normal not important
     // and (4) normal important.
     m_lineHeightValue = 0;
-    applyDeclarations<true>(false, 0, m_matchedDecls.size() - 1);
-    applyDeclarations<true>(true, matchResult.firstAuthorRule, matchResult.lastAuthorRule);
-    applyDeclarations<true>(true, matchResult.firstUserRule, matchResult.lastUserRule);
-    applyDeclarations<true>(true, matchResult.firstUARule, matchResult.lastUARule);
+    applyDeclarations<true>(false, 0, m_matchedDecls.size() - 1, applyInheritedOnly);
+    applyDeclarations<true>(true, matchResult.firstAuthorRule, matchResult.lastAuthorRule, applyInheritedOnly);
+    applyDeclarations<true>(true, matchResult.firstUserRule, matchResult.lastUserRule, applyInheritedOnly);
+    applyDeclarations<true>(true, matchResult.firstUARule, matchResult.lastUARule, applyInheritedOnly);
     
     // If our font got dirtied, go ahead and update it now.
     updateFont();
@@ -2156,20 +2382,38 @@ void CSSStyleSelector::applyMatchedDeclarations(const MatchResult& matchResult)
     // Line-height is set when we are sure we decided on the font-size.
     if (m_lineHeightValue)
         applyProperty(CSSPropertyLineHeight, m_lineHeightValue);
+
+    // Lengths in em and ex units depend on the font, and direction-aware properties
+    // on the direction and writing mode. If any of them differs from the cached
+    // style's, the non-inherited properties have to be applied after all.
+    if (cacheItem && (cacheItem->renderStyle->fontDescription() != m_style->fontDescription()
+        || cacheItem->renderStyle->direction() != m_style->direction()
+        || cacheItem->renderStyle->writingMode() != m_style->writingMode()))
+        applyInheritedOnly = false;
         
     // Now do the normal priority UA properties.
-    applyDeclarations<false>(false, matchResult.firstUARule, matchResult.lastUARule);
+    applyDeclarations<false>(false, matchResult.firstUARule, matchResult.lastUARule, applyInheritedOnly);
     
     // Cache our border and background so that we can examine them later.
     cacheBorderAndBackground();
     
     // Now do the author and user normal priority properties and all the !important properties.
-    applyDeclarations<false>(false, matchResult.lastUARule + 1, m_matchedDecls.size() - 1);
-    applyDeclarations<false>(true, matchResult.firstAuthorRule, matchResult.lastAuthorRule);
-    applyDeclarations<false>(true, matchResult.firstUserRule, matchResult.lastUserRule);
-    applyDeclarations<false>(true, matchResult.firstUARule, matchResult.lastUARule);
+    applyDeclarations<false>(false, matchResult.lastUARule + 1, m_matchedDecls.size() - 1, applyInheritedOnly);
+    applyDeclarations<false>(true, matchResult.firstAuthorRule, matchResult.lastAuthorRule, applyInheritedOnly);
+    applyDeclarations<false>(true, matchResult.firstUserRule, matchResult.lastUserRule, applyInheritedOnly);
+    applyDeclarations<false>(true, matchResult.firstUARule, matchResult.lastUARule, applyInheritedOnly);
+
+    // Start loading images referenced by this style. This comes before the style
+    // goes into the cache, so that hits get loaded images rather than pending ones.
+    loadPendingImages();
     
     ASSERT(!m_fontDirty);
+
+    if (cacheItem || !cacheHash)
+        return;
+    if (!isCacheableInMatchedDeclarationCache(m_style.get(), m_parentStyle))
+        return;
+    addToMatchedDeclarationCache(cacheHash, matchResult);
 }
 
 void CSSStyleSelector::matchPageRules(RuleSet* rules, bool isLeftPage, bool isFirstPage, const String& pageName)
@@ -2354,6 +2598,9 @@ void CSSStyleSelector::applyProperty(int id, CSSValue *value)
     bool isInherit = m_parentNode && valueType == CSSValue::CSS_INHERIT;
     bool isInitial = valueType == CSSValue::CSS_INITIAL || (!m_parentNode && valueType == CSSValue::CSS_INHERIT);
 
+    if (isInherit && m_parentStyle && !m_parentStyle->hasExplicitlyInheritedProperties() && !CSSProperty::isInheritedProperty(id))
+        m_parentStyle->setHasExplicitlyInheritedProperties();
+
     if (!applyPropertyToRegularStyle() && (!applyPropertyToVisitedLinkStyle() || !isValidVisitedLinkProperty(id))) {
         // Limit the properties that can be applied to only the ones honored by :visited.
         return;
@@ -226,13 +226,14 @@ private:
     void addMatchedDeclaration(CSSMutableStyleDeclaration*, unsigned linkMatchType = SelectorChecker::MatchAll);
 
     struct MatchResult {
-        MatchResult() : firstUARule(-1), lastUARule(-1), firstAuthorRule(-1), lastAuthorRule(-1), firstUserRule(-1), lastUserRule(-1) { }
+        MatchResult() : firstUARule(-1), lastUARule(-1), firstAuthorRule(-1), lastAuthorRule(-1), firstUserRule(-1), lastUserRule(-1), isCacheable(true) { }
         int firstUARule;
         int lastUARule;
         int firstAuthorRule;
         int lastAuthorRule;
         int firstUserRule;
         int lastUserRule;
+        bool isCacheable;
     };
     void matchAllRules(MatchResult&);
     void matchUARules(MatchResult&);
@@ -245,9 +246,9 @@ private:
 
     void applyMatchedDeclarations(const MatchResult&);
     template <bool firstPass>
-    void applyDeclarations(bool important, int startIndex, int endIndex);
+    void applyDeclarations(bool important, int startIndex, int endIndex, bool inheritedOnly = false);
     template <bool firstPass>
-    void applyDeclaration(CSSMutableStyleDeclaration*, bool isImportant);
+    void applyDeclaration(CSSMutableStyleDeclaration*, bool isImportant, bool inheritedOnly);
 
     void matchPageRules(RuleSet*, bool isLeftPage, bool isFirstPage, const String& pageName);
     void matchPageRulesForList(const Vector<RuleData>*, bool isLeftPage, bool isFirstPage, const String& pageName);
@@ -336,6 +337,26 @@ private:
     };
     Vector<MatchedStyleDeclaration, 64> m_matchedDecls;
 
+    // Elements that match the same declarations end up with the same non-inherited
+    // style data, so the result of applying a set of declarations is cached,
+    // keyed by a hash of the declaration pointers. A hit only needs to apply
+    // the inherited properties, and nothing at all when the parent's inherited
+    // data is shared with the one the cache entry was built under.
+    struct MatchedDeclarationCacheItem {
+        Vector<RefPtr<CSSMutableStyleDeclaration> > declarations;
+        MatchResult matchResult;
+        RefPtr<RenderStyle> renderStyle;
+        RefPtr<RenderStyle> parentRenderStyle;
+    };
+    unsigned computeMatchedDeclarationHash() const;
+    const MatchedDeclarationCacheItem* findFromMatchedDeclarationCache(unsigned hash, const MatchResult&) const;
+    void addToMatchedDeclarationCache(unsigned hash, const MatchResult&);
+    void sweepMatchedDeclarationCache();
+
+    typedef HashMap<unsigned, MatchedDeclarationCacheItem> MatchedDeclarationCache;
+    MatchedDeclarationCache m_matchedDeclarationCache;
+    unsigned m_matchedDeclarationCacheAdditionsSinceLastSweep;
+
     // A buffer used to hold the set of matched rules for an element, and a temporary buffer used for
     // merge sorting.
     Vector<const RuleData*, 32> m_matchedRules;
@@ -334,9 +334,13 @@ void DocumentThreadableLoader::loadRequest(const ResourceRequest& request, Secur
         }
 #endif
 
+        // The networking layer schedules by the priority of the request itself.
+        ResourceRequest prioritizedRequest(request);
+        prioritizedRequest.setPriority(ResourceLoadPriorityMedium);
+
         // Clear the loader so that any callbacks from SubresourceLoader::create will not have the old loader.
         m_loader = 0;
-        m_loader = resourceLoadScheduler()->scheduleSubresourceLoad(m_document->frame(), this, request, ResourceLoadPriorityMedium, options);
+        m_loader = resourceLoadScheduler()->scheduleSubresourceLoad(m_document->frame(), this, prioritizedRequest, ResourceLoadPriorityMedium, options);
         return;
     }
     
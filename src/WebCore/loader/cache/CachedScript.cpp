@@ -35,15 +35,26 @@
 #include <wtf/Vector.h>
 
 #if USE(JSC)  
+#include "SourceProviderCacheStorage.h"
 #include <parser/SourceProvider.h>
 #endif
 
 namespace WebCore {
 
+#if USE(JSC)
+// Functions are parsed in bursts while a page starts up, so what the parser
+// learns is written out once it has been quiet for a moment.
+static const double sourceProviderCacheSaveDelay = 2;
+#endif
+
 CachedScript::CachedScript(const ResourceRequest& resourceRequest, const String& charset)
     : CachedResource(resourceRequest, Script)
     , m_decoder(TextResourceDecoder::create("application/javascript", charset))
     , m_decodedDataDeletionTimer(this, &CachedScript::decodedDataDeletionTimerFired)
+#if USE(JSC)
+    , m_sourceProviderCacheIsDirty(false)
+    , m_sourceProviderCacheSaveTimer(this, &CachedScript::sourceProviderCacheSaveTimerFired)
+#endif
 {
     // It's javascript we want.
     // But some websites think their scripts are <some wrong mimetype here>
@@ -53,6 +64,9 @@ CachedScript::CachedScript(const ResourceRequest& resourceRequest, const String&
 
 CachedScript::~CachedScript()
 {
+#if USE(JSC)
+    saveSourceProviderCache();
+#endif
 }
 
 void CachedScript::didAddClient(CachedResourceClient* c)
@@ -114,11 +128,17 @@ void CachedScript::error(CachedResource::Status status)
 
 void CachedScript::destroyDecodedData()
 {
+#if USE(JSC)
+    // The source is needed to find the stored copy again.
+    saveSourceProviderCache();
+#endif
     m_script = String();
     unsigned extraSize = 0;
 #if USE(JSC)
+    // Without clients no source provider refers to the cache any more, so it
+    // can go and be loaded again from storage the next time it is needed.
     if (m_sourceProviderCache && m_clients.isEmpty())
-        m_sourceProviderCache->clear();
+        m_sourceProviderCache.clear();
 
     extraSize = m_sourceProviderCache ? m_sourceProviderCache->byteSize() : 0;
 #endif
@@ -135,14 +155,41 @@ void CachedScript::decodedDataDeletionTimerFired(Timer<CachedScript>*)
 #if USE(JSC)
 JSC::SourceProviderCache* CachedScript::sourceProviderCache() const
 {   
-    if (!m_sourceProviderCache) 
+    if (!m_sourceProviderCache) {
         m_sourceProviderCache = adoptPtr(new JSC::SourceProviderCache); 
+
+        SourceProviderCacheStorage* storage = SourceProviderCacheStorage::sharedInstance();
+        CachedScript* self = const_cast<CachedScript*>(this);
+        if (storage->isEnabled() && storage->load(self->script(), m_sourceProviderCache.get()))
+            self->setDecodedSize(decodedSize() + m_sourceProviderCache->byteSize());
+    }
     return m_sourceProviderCache.get(); 
 }
 
 void CachedScript::sourceProviderCacheSizeChanged(int delta)
 {
     setDecodedSize(decodedSize() + delta);
+
+    if (delta > 0 && SourceProviderCacheStorage::sharedInstance()->isEnabled()) {
+        m_sourceProviderCacheIsDirty = true;
+        if (!m_sourceProviderCacheSaveTimer.isActive())
+            m_sourceProviderCacheSaveTimer.startOneShot(sourceProviderCacheSaveDelay);
+    }
+}
+
+void CachedScript::saveSourceProviderCache()
+{
+    m_sourceProviderCacheSaveTimer.stop();
+    if (!m_sourceProviderCacheIsDirty || !m_sourceProviderCache || m_script.isNull())
+        return;
+
+    m_sourceProviderCacheIsDirty = false;
+    SourceProviderCacheStorage::sharedInstance()->save(m_script, m_sourceProviderCache.get());
+}
+
+void CachedScript::sourceProviderCacheSaveTimerFired(Timer<CachedScript>*)
+{
+    saveSourceProviderCache();
 }
 #endif
 
@@ -63,6 +63,10 @@ namespace WebCore {
 #endif
     private:
         void decodedDataDeletionTimerFired(Timer<CachedScript>*);
+#if USE(JSC)
+        void saveSourceProviderCache();
+        void sourceProviderCacheSaveTimerFired(Timer<CachedScript>*);
+#endif
         virtual PurgePriority purgePriority() const { return PurgeLast; }
 
         String m_script;
@@ -70,6 +74,8 @@ namespace WebCore {
         Timer<CachedScript> m_decodedDataDeletionTimer;
 #if USE(JSC)        
         mutable OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        bool m_sourceProviderCacheIsDirty;
+        Timer<CachedScript> m_sourceProviderCacheSaveTimer;
 #endif
     };
 }
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SourceProviderCacheStorage.h"
+
+#if USE(JSC)
+
+#include "FileSystem.h"
+#include "JSDOMWindowBase.h"
+#include <algorithm>
+#include <parser/SourceProvider.h>
+#include <wtf/MD5.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+static const uint32_t fileMagic = 0x53454b57; // "WKES"
+static const uint32_t fileVersion = 1;
+static const char fileExtension[] = ".jscache";
+static const long long defaultStorageSizeLimit = 16 * 1024 * 1024;
+
+// Evicting down to a bit below the limit keeps every later save from listing
+// the directory again.
+static const double evictionTargetRatio = 0.75;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sourceLength;
+    uint32_t dataSize;
+    // Guards against files cut short by a crash or edited by hand, which the
+    // parser would otherwise trust.
+    uint8_t dataDigest[16];
+};
+
+static void computeDigest(const char* data, size_t size, uint8_t* result)
+{
+    MD5 md5;
+    md5.addBytes(reinterpret_cast<const uint8_t*>(data), size);
+    Vector<uint8_t, 16> digest;
+    md5.checksum(digest);
+    memcpy(result, digest.data(), digest.size());
+}
+
+SourceProviderCacheStorage* SourceProviderCacheStorage::sharedInstance()
+{
+    static SourceProviderCacheStorage* sharedInstance = 0;
+    if (!sharedInstance)
+        sharedInstance = new SourceProviderCacheStorage();
+    return sharedInstance;
+}
+
+SourceProviderCacheStorage::SourceProviderCacheStorage()
+    : m_storageSizeLimit(defaultStorageSizeLimit)
+    , m_usedSize(0)
+{
+}
+
+void SourceProviderCacheStorage::setDirectory(const String& directory)
+{
+    if (directory == m_directory)
+        return;
+
+    m_directory = directory;
+    m_usedSize = 0;
+    if (m_directory.isEmpty())
+        return;
+
+    makeAllDirectories(m_directory);
+    Vector<String> files = listDirectory(m_directory, String("*") + fileExtension);
+    for (size_t i = 0; i < files.size(); ++i) {
+        long long size;
+        if (getFileSize(files[i], size))
+            m_usedSize += size;
+    }
+    evictFiles();
+}
+
+void SourceProviderCacheStorage::setStorageSizeLimit(long long limit)
+{
+    m_storageSizeLimit = limit;
+    evictFiles();
+}
+
+String SourceProviderCacheStorage::filePath(const String& source) const
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    MD5 md5;
+    md5.addBytes(reinterpret_cast<const uint8_t*>(source.characters()), source.length() * sizeof(UChar));
+    Vector<uint8_t, 16> digest;
+    md5.checksum(digest);
+
+    Vector<UChar, 32> name;
+    for (size_t i = 0; i < digest.size(); ++i) {
+        name.append(hexDigits[digest[i] >> 4]);
+        name.append(hexDigits[digest[i] & 0xf]);
+    }
+    return pathByAppendingComponent(m_directory, String(name.data(), name.size()) + fileExtension);
+}
+
+bool SourceProviderCacheStorage::load(const String& source, JSC::SourceProviderCache* cache)
+{
+    ASSERT(cache->isEmpty());
+    if (!isEnabled() || source.isEmpty())
+        return false;
+
+    String path = filePath(source);
+    long long fileSize;
+    if (!getFileSize(path, fileSize) || fileSize < static_cast<long long>(sizeof(FileHeader)) || fileSize > m_storageSizeLimit)
+        return false;
+
+    PlatformFileHandle file = openFile(path, OpenForRead);
+    if (!isHandleValid(file))
+        return false;
+
+    Vector<char> buffer(static_cast<size_t>(fileSize));
+    bool isRead = readFromFile(file, buffer.data(), buffer.size()) == static_cast<int>(buffer.size());
+    closeFile(file);
+    if (!isRead)
+        return false;
+
+    FileHeader header;
+    memcpy(&header, buffer.data(), sizeof(header));
+    const char* data = buffer.data() + sizeof(header);
+    if (header.magic != fileMagic || header.version != fileVersion || header.sourceLength != source.length()
+        || header.dataSize != buffer.size() - sizeof(header))
+        return false;
+
+    uint8_t digest[16];
+    computeDigest(data, header.dataSize, digest);
+    if (memcmp(digest, header.dataDigest, sizeof(digest)))
+        return false;
+
+    return cache->decode(JSDOMWindowBase::commonJSGlobalData(), data, header.dataSize, source.characters(), source.length());
+}
+
+void SourceProviderCacheStorage::save(const String& source, const JSC::SourceProviderCache* cache)
+{
+    if (!isEnabled() || source.isEmpty() || cache->isEmpty())
+        return;
+
+    Vector<char> buffer(sizeof(FileHeader));
+    cache->encode(buffer);
+
+    FileHeader header;
+    header.magic = fileMagic;
+    header.version = fileVersion;
+    header.sourceLength = source.length();
+    header.dataSize = buffer.size() - sizeof(header);
+    computeDigest(buffer.data() + sizeof(header), header.dataSize, header.dataDigest);
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    String path = filePath(source);
+    long long oldSize;
+    if (getFileSize(path, oldSize))
+        m_usedSize -= oldSize;
+
+    PlatformFileHandle file = openFile(path, OpenForWrite);
+    if (!isHandleValid(file))
+        return;
+
+    bool isWritten = writeToFile(file, buffer.data(), buffer.size()) == static_cast<int>(buffer.size());
+    closeFile(file);
+    if (!isWritten) {
+        deleteFile(path);
+        return;
+    }
+
+    m_usedSize += buffer.size();
+    if (m_usedSize > m_storageSizeLimit)
+        evictFiles();
+}
+
+static bool isOlderFile(const std::pair<time_t, String>& a, const std::pair<time_t, String>& b)
+{
+    return a.first < b.first;
+}
+
+void SourceProviderCacheStorage::evictFiles()
+{
+    if (m_directory.isEmpty() || m_usedSize <= m_storageSizeLimit)
+        return;
+
+    Vector<std::pair<time_t, String> > files;
+    Vector<String> paths = listDirectory(m_directory, String("*") + fileExtension);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        time_t modificationTime;
+        if (getFileModificationTime(paths[i], modificationTime))
+            files.append(std::make_pair(modificationTime, paths[i]));
+    }
+    std::sort(files.begin(), files.end(), isOlderFile);
+
+    long long targetSize = static_cast<long long>(m_storageSizeLimit * evictionTargetRatio);
+    for (size_t i = 0; i < files.size() && m_usedSize > targetSize; ++i) {
+        long long size;
+        if (getFileSize(files[i].second, size) && deleteFile(files[i].second))
+            m_usedSize -= size;
+    }
+}
+
+} // namespace WebCore
+
+#endif // USE(JSC)
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SourceProviderCacheStorage_h
+#define SourceProviderCacheStorage_h
+
+#if USE(JSC)
+
+#include "PlatformString.h"
+#include <wtf/Noncopyable.h>
+
+namespace JSC {
+    class SourceProviderCache;
+}
+
+namespace WebCore {
+
+// Keeps what the JavaScript parser learned about a script, such as where each
+// function body ends and which variables it uses, in a directory on disk. A
+// script that comes back in a later run can then be parsed without looking
+// inside its functions until they are first called.
+//
+// Files are named after a digest of the script source and only apply to that
+// exact source. The directory is trimmed to the size limit whenever it is set
+// and whenever a save pushes it over.
+class SourceProviderCacheStorage {
+    WTF_MAKE_NONCOPYABLE(SourceProviderCacheStorage);
+public:
+    static SourceProviderCacheStorage* sharedInstance();
+
+    void setDirectory(const String&);
+    const String& directory() const { return m_directory; }
+
+    void setStorageSizeLimit(long long);
+    long long storageSizeLimit() const { return m_storageSizeLimit; }
+
+    bool isEnabled() const { return !m_directory.isEmpty() && m_storageSizeLimit > 0; }
+
+    // Adds the stored entries for the source to an empty cache. Returns false
+    // if nothing usable was stored.
+    bool load(const String& source, JSC::SourceProviderCache*);
+    void save(const String& source, const JSC::SourceProviderCache*);
+
+private:
+    SourceProviderCacheStorage();
+
+    String filePath(const String& source) const;
+    void evictFiles();
+
+    String m_directory;
+    long long m_storageSizeLimit;
+    long long m_usedSize;
+};
+
+} // namespace WebCore
+
+#endif // USE(JSC)
+
+#endif // SourceProviderCacheStorage_h
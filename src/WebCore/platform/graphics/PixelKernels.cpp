@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PixelKernels.h"
+
+#include <algorithm>
+
+#if CPU(X86_SSE2)
+#include "PixelKernelsX86.h"
+#endif
+
+namespace WebCore {
+
+static void boxBlurPortable(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+    int stride, int strideLine, int effectWidth, int effectHeight, bool alphaImage)
+{
+    for (int y = 0; y < effectHeight; ++y) {
+        int line = y * strideLine;
+        for (int channel = 3; channel >= 0; --channel) {
+            int sum = 0;
+            // Fill the kernel
+            int maxKernelSize = std::min(distanceRight, effectWidth);
+            for (int i = 0; i < maxKernelSize; ++i)
+                sum += source[line + i * stride + channel];
+
+            // Blurring
+            for (int x = 0; x < effectWidth; ++x) {
+                int pixelByteOffset = line + x * stride + channel;
+                destination[pixelByteOffset] = static_cast<unsigned char>(sum / kernelSize);
+                if (x >= distanceLeft)
+                    sum -= source[pixelByteOffset - distanceLeft * stride];
+                if (x + distanceRight < effectWidth)
+                    sum += source[pixelByteOffset + distanceRight * stride];
+            }
+            if (alphaImage) // Source image is black, it just has different alpha values
+                break;
+        }
+    }
+}
+
+static void shadowBlurPortable(unsigned char* pixels, int lineCount, int lineLength, int stride, int strideLine, const int lobes[3][2])
+{
+    const int channels[4] = { 3, 0, 1, 3 };
+    int dim = lineLength;
+
+    for (int j = 0; j < lineCount; ++j, pixels += strideLine) {
+        // For each step, we blur the alpha in a channel and store the result
+        // in another channel for the subsequent step.
+        // We use sliding window algorithm to accumulate the alpha values.
+        // This is much more efficient than computing the sum of each pixels
+        // covered by the box kernel size for each x.
+        for (int step = 0; step < 3; ++step) {
+            int side1 = lobes[step][0];
+            int side2 = lobes[step][1];
+            int pixelCount = side1 + 1 + side2;
+            int invCount = ((1 << shadowBlurSumShift) + pixelCount - 1) / pixelCount;
+            int ofs = 1 + side2;
+            int alpha1 = pixels[channels[step]];
+            int alpha2 = pixels[(dim - 1) * stride + channels[step]];
+
+            unsigned char* ptr = pixels + channels[step + 1];
+            unsigned char* prev = pixels + stride + channels[step];
+            unsigned char* next = pixels + ofs * stride + channels[step];
+
+            int i;
+            int sum = side1 * alpha1 + alpha1;
+            int limit = (dim < side2 + 1) ? dim : side2 + 1;
+
+            for (i = 1; i < limit; ++i, prev += stride)
+                sum += *prev;
+
+            if (limit <= side2)
+                sum += (side2 - limit + 1) * alpha2;
+
+            limit = (side1 < dim) ? side1 : dim;
+            for (i = 0; i < limit; ptr += stride, next += stride, ++i, ++ofs) {
+                *ptr = (sum * invCount) >> shadowBlurSumShift;
+                sum += ((ofs < dim) ? *next : alpha2) - alpha1;
+            }
+
+            prev = pixels + channels[step];
+            for (; ofs < dim; ptr += stride, prev += stride, next += stride, ++i, ++ofs) {
+                *ptr = (sum * invCount) >> shadowBlurSumShift;
+                sum += (*next) - (*prev);
+            }
+
+            for (; i < dim; ptr += stride, prev += stride, ++i) {
+                *ptr = (sum * invCount) >> shadowBlurSumShift;
+                sum += alpha2 - (*prev);
+            }
+        }
+    }
+}
+
+static void premultipliedARGBToUnmultipliedRGBAPortable(const unsigned* source, unsigned char* destination, unsigned pixelCount)
+{
+    for (unsigned i = 0; i < pixelCount; ++i, destination += 4) {
+        unsigned pixel = source[i];
+        unsigned alpha = pixel >> 24;
+        unsigned red = (pixel >> 16) & 0xFF;
+        unsigned green = (pixel >> 8) & 0xFF;
+        unsigned blue = pixel & 0xFF;
+        if (alpha) {
+            red = std::min(red * 255 / alpha, 255u);
+            green = std::min(green * 255 / alpha, 255u);
+            blue = std::min(blue * 255 / alpha, 255u);
+        }
+        destination[0] = red;
+        destination[1] = green;
+        destination[2] = blue;
+        destination[3] = alpha;
+    }
+}
+
+static void premultipliedARGBToPremultipliedRGBAPortable(const unsigned* source, unsigned char* destination, unsigned pixelCount)
+{
+    for (unsigned i = 0; i < pixelCount; ++i, destination += 4) {
+        unsigned pixel = source[i];
+        destination[0] = pixel >> 16;
+        destination[1] = pixel >> 8;
+        destination[2] = pixel;
+        destination[3] = pixel >> 24;
+    }
+}
+
+static void unmultipliedRGBAToPremultipliedARGBPortable(const unsigned char* source, unsigned* destination, unsigned pixelCount)
+{
+    for (unsigned i = 0; i < pixelCount; ++i, source += 4) {
+        unsigned red = source[0];
+        unsigned green = source[1];
+        unsigned blue = source[2];
+        unsigned alpha = source[3];
+        if (alpha) {
+            red = (red * alpha + 254) / 255;
+            green = (green * alpha + 254) / 255;
+            blue = (blue * alpha + 254) / 255;
+        }
+        destination[i] = alpha << 24 | red << 16 | green << 8 | blue;
+    }
+}
+
+static void premultipliedRGBAToPremultipliedARGBPortable(const unsigned char* source, unsigned* destination, unsigned pixelCount)
+{
+    for (unsigned i = 0; i < pixelCount; ++i, source += 4)
+        destination[i] = source[3] << 24 | source[0] << 16 | source[1] << 8 | source[2];
+}
+
+const PixelKernels& portablePixelKernels()
+{
+    static const PixelKernels kernels = {
+        "portable",
+        boxBlurPortable,
+        shadowBlurPortable,
+        premultipliedARGBToUnmultipliedRGBAPortable,
+        premultipliedARGBToPremultipliedRGBAPortable,
+        unmultipliedRGBAToPremultipliedARGBPortable,
+        premultipliedRGBAToPremultipliedARGBPortable
+    };
+    return kernels;
+}
+
+#if !CPU(X86_SSE2)
+const PixelKernels* sse2PixelKernels()
+{
+    return 0;
+}
+#endif
+
+#if !HAVE(AVX2_INTRINSICS)
+const PixelKernels* avx2PixelKernels()
+{
+    return 0;
+}
+#endif
+
+const PixelKernels& pixelKernels()
+{
+    // Threads racing to initialize this all store the same pointer.
+    static const PixelKernels* kernels;
+    if (!kernels) {
+        const PixelKernels* best = avx2PixelKernels();
+        if (!best)
+            best = sse2PixelKernels();
+        kernels = best ? best : &portablePixelKernels();
+    }
+    return *kernels;
+}
+
+} // namespace WebCore
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PixelKernels_h
+#define PixelKernels_h
+
+namespace WebCore {
+
+// ShadowBlur divides by the window size in 17.15 fixed point.
+static const int shadowBlurSumShift = 15;
+
+// The inner loops of blurring and of converting between cairo's premultiplied
+// ARGB32 pixels and the unmultiplied RGBA bytes of ImageData. Every
+// implementation produces exactly the same bytes as the portable one, so
+// callers can use whichever pixelKernels() picks for the running CPU.
+struct PixelKernels {
+    const char* name;
+
+    // Box blur of effectHeight lines, each effectWidth samples long. A sample is
+    // 4 bytes; stride separates two samples of a line and strideLine two lines.
+    // The window covers distanceLeft samples before and distanceRight samples
+    // starting at the current one, and kernelSize = distanceLeft + distanceRight.
+    // Alpha images only have their alpha channel written.
+    void (*boxBlur)(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+        int stride, int strideLine, int effectWidth, int effectHeight, bool alphaImage);
+
+    // The three box blur passes ShadowBlur applies to each line of an alpha mask,
+    // in place. lobes holds the left and right extent of each pass.
+    void (*shadowBlur)(unsigned char* pixels, int lineCount, int lineLength, int stride, int strideLine, const int lobes[3][2]);
+
+    void (*premultipliedARGBToUnmultipliedRGBA)(const unsigned* source, unsigned char* destination, unsigned pixelCount);
+    void (*premultipliedARGBToPremultipliedRGBA)(const unsigned* source, unsigned char* destination, unsigned pixelCount);
+    void (*unmultipliedRGBAToPremultipliedARGB)(const unsigned char* source, unsigned* destination, unsigned pixelCount);
+    void (*premultipliedRGBAToPremultipliedARGB)(const unsigned char* source, unsigned* destination, unsigned pixelCount);
+};
+
+// The fastest kernels the CPU supports, chosen on first use.
+const PixelKernels& pixelKernels();
+
+// Individual implementations, for comparing them against each other. The
+// SIMD ones return 0 when the CPU or the build lacks the instructions.
+const PixelKernels& portablePixelKernels();
+const PixelKernels* sse2PixelKernels();
+const PixelKernels* avx2PixelKernels();
+
+} // namespace WebCore
+
+#endif // PixelKernels_h
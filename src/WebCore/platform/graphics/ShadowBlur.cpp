@@ -33,6 +33,7 @@
 #include "FloatQuad.h"
 #include "GraphicsContext.h"
 #include "ImageBuffer.h"
+#include "PixelKernels.h"
 #include "Timer.h"
 #include <wtf/MathExtras.h>
 #include <wtf/Noncopyable.h>
@@ -216,9 +217,6 @@ void ShadowBlur::updateShadowBlurValues()
         m_type = SolidShadow;
 }
 
-// Instead of integer division, we use 17.15 for fixed-point division.
-static const int blurSumShift = 15;
-
 // Takes a two dimensional array with three rows and two columns for the lobes.
 static void calculateLobes(int lobes[][2], float blurRadius, bool shadowsIgnoreTransforms)
 {
@@ -270,84 +268,23 @@ void ShadowBlur::clear()
 
 void ShadowBlur::blurLayerImage(unsigned char* imageData, const IntSize& size, int rowStride)
 {
-    const int channels[4] = { 3, 0, 1, 3 };
-
     int lobes[3][2]; // indexed by pass, and left/right lobe
     calculateLobes(lobes, m_blurRadius.width(), m_shadowsIgnoreTransforms);
 
-    // First pass is horizontal.
-    int stride = 4;
-    int delta = rowStride;
-    int final = size.height();
-    int dim = size.width();
+    const PixelKernels& kernels = pixelKernels();
 
-    // Two stages: horizontal and vertical
-    for (int pass = 0; pass < 2; ++pass) {
-        unsigned char* pixels = imageData;
-        
-        if (!pass && !m_blurRadius.width())
-            final = 0; // Do no work if horizonal blur is zero.
-
-        for (int j = 0; j < final; ++j, pixels += delta) {
-            // For each step, we blur the alpha in a channel and store the result
-            // in another channel for the subsequent step.
-            // We use sliding window algorithm to accumulate the alpha values.
-            // This is much more efficient than computing the sum of each pixels
-            // covered by the box kernel size for each x.
-            for (int step = 0; step < 3; ++step) {
-                int side1 = lobes[step][leftLobe];
-                int side2 = lobes[step][rightLobe];
-                int pixelCount = side1 + 1 + side2;
-                int invCount = ((1 << blurSumShift) + pixelCount - 1) / pixelCount;
-                int ofs = 1 + side2;
-                int alpha1 = pixels[channels[step]];
-                int alpha2 = pixels[(dim - 1) * stride + channels[step]];
-
-                unsigned char* ptr = pixels + channels[step + 1];
-                unsigned char* prev = pixels + stride + channels[step];
-                unsigned char* next = pixels + ofs * stride + channels[step];
-
-                int i;
-                int sum = side1 * alpha1 + alpha1;
-                int limit = (dim < side2 + 1) ? dim : side2 + 1;
-
-                for (i = 1; i < limit; ++i, prev += stride)
-                    sum += *prev;
-
-                if (limit <= side2)
-                    sum += (side2 - limit + 1) * alpha2;
-
-                limit = (side1 < dim) ? side1 : dim;
-                for (i = 0; i < limit; ptr += stride, next += stride, ++i, ++ofs) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += ((ofs < dim) ? *next : alpha2) - alpha1;
-                }
-                
-                prev = pixels + channels[step];
-                for (; ofs < dim; ptr += stride, prev += stride, next += stride, ++i, ++ofs) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += (*next) - (*prev);
-                }
-                
-                for (; i < dim; ptr += stride, prev += stride, ++i) {
-                    *ptr = (sum * invCount) >> blurSumShift;
-                    sum += alpha2 - (*prev);
-                }
-            }
-        }
+    // First pass is horizontal. Do no work if horizonal blur is zero.
+    if (m_blurRadius.width())
+        kernels.shadowBlur(imageData, size.height(), size.width(), 4, rowStride, lobes);
 
-        // Last pass is vertical.
-        stride = rowStride;
-        delta = 4;
-        final = size.width();
-        dim = size.height();
+    // Last pass is vertical.
+    if (!m_blurRadius.height())
+        return;
 
-        if (!m_blurRadius.height())
-            break;
+    if (m_blurRadius.width() != m_blurRadius.height())
+        calculateLobes(lobes, m_blurRadius.height(), m_shadowsIgnoreTransforms);
 
-        if (m_blurRadius.width() != m_blurRadius.height())
-            calculateLobes(lobes, m_blurRadius.height(), m_shadowsIgnoreTransforms);
-    }
+    kernels.shadowBlur(imageData, size.width(), size.height(), rowStride, 4, lobes);
 }
 
 void ShadowBlur::adjustBlurRadius(GraphicsContext* context)
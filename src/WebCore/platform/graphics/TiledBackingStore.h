@@ -45,6 +45,8 @@ public:
     ~TiledBackingStore();
 
     void adjustVisibleRect();
+    // Creates the tiles that a grown contents size now needs around the unchanged visible rect.
+    void contentsSizeChanged() { startTileCreationTimer(); }
     
     TiledBackingStoreClient* client() { return m_client; }
     float contentsScale() { return m_contentsScale; }
@@ -77,6 +79,7 @@ public:
 
     IntRect tileRectForCoordinate(const Tile::Coordinate&) const;
     Tile::Coordinate tileCoordinateForPoint(const IntPoint&) const;
+    PassRefPtr<Tile> tileAt(const Tile::Coordinate&) const;
     double tileDistance(const IntRect& viewport, const Tile::Coordinate&) const;
     float coverageRatio(const WebCore::IntRect& contentsRect);
 
@@ -98,7 +101,6 @@ private:
     bool resizeEdgeTiles();
     void dropTilesOutsideRect(const IntRect&);
     
-    PassRefPtr<Tile> tileAt(const Tile::Coordinate&) const;
     void setTile(const Tile::Coordinate& coordinate, PassRefPtr<Tile> tile);
     void removeTile(const Tile::Coordinate& coordinate);
 
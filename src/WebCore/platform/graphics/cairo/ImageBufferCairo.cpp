@@ -38,6 +38,7 @@
 #include "MIMETypeRegistry.h"
 #include "NotImplemented.h"
 #include "Pattern.h"
+#include "PixelKernels.h"
 #include "PlatformContextCairo.h"
 #include "PlatformString.h"
 #include "RefPtrCairo.h"
@@ -172,22 +173,14 @@ PassRefPtr<ByteArray> getImageData(const IntRect& rect, const ImageBufferData& d
     int stride = cairo_image_surface_get_stride(data.m_surface);
     unsigned destBytesPerRow = 4 * rect.width();
 
+    const PixelKernels& kernels = pixelKernels();
     unsigned char* destRows = dataDst + desty * destBytesPerRow + destx * 4;
     for (int y = 0; y < numRows; ++y) {
         unsigned* row = reinterpret_cast<unsigned*>(dataSrc + stride * (y + originy));
-        for (int x = 0; x < numColumns; x++) {
-            int basex = x * 4;
-            unsigned* pixel = row + x + originx;
-            Color pixelColor;
-            if (multiplied == Unmultiplied)
-                pixelColor = colorFromPremultipliedARGB(*pixel);
-            else
-                pixelColor = Color(*pixel);
-            destRows[basex]     = pixelColor.red();
-            destRows[basex + 1] = pixelColor.green();
-            destRows[basex + 2] = pixelColor.blue();
-            destRows[basex + 3] = pixelColor.alpha();
-        }
+        if (multiplied == Unmultiplied)
+            kernels.premultipliedARGBToUnmultipliedRGBA(row + originx, destRows, numColumns);
+        else
+            kernels.premultipliedARGBToPremultipliedRGBA(row + originx, destRows, numColumns);
         destRows += destBytesPerRow;
     }
 
@@ -240,21 +233,14 @@ void putImageData(ByteArray*& source, const IntSize& sourceSize, const IntRect&
     unsigned srcBytesPerRow = 4 * sourceSize.width();
     int stride = cairo_image_surface_get_stride(data.m_surface);
 
+    const PixelKernels& kernels = pixelKernels();
     unsigned char* srcRows = source->data() + originy * srcBytesPerRow + originx * 4;
     for (int y = 0; y < numRows; ++y) {
         unsigned* row = reinterpret_cast<unsigned*>(dataDst + stride * (y + desty));
-        for (int x = 0; x < numColumns; x++) {
-            int basex = x * 4;
-            unsigned* pixel = row + x + destx;
-            Color pixelColor(srcRows[basex],
-                    srcRows[basex + 1],
-                    srcRows[basex + 2],
-                    srcRows[basex + 3]);
-            if (multiplied == Unmultiplied)
-                *pixel = premultipliedARGBFromColor(pixelColor);
-            else
-                *pixel = pixelColor.rgb();
-        }
+        if (multiplied == Unmultiplied)
+            kernels.unmultipliedRGBAToPremultipliedARGB(srcRows, row + destx, numColumns);
+        else
+            kernels.premultipliedRGBAToPremultipliedARGB(srcRows, row + destx, numColumns);
         srcRows += srcBytesPerRow;
     }
     cairo_surface_mark_dirty_rectangle (data.m_surface,
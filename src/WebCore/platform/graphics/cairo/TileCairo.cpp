@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "TileCairo.h"
+
+#if USE(TILED_BACKING_STORE)
+
+#include "CairoUtilities.h"
+#include "Color.h"
+#include "GraphicsContext.h"
+#include "PlatformContextCairo.h"
+#include "TiledBackingStore.h"
+#include "TiledBackingStoreClient.h"
+#include <cairo.h>
+
+namespace WebCore {
+
+static const int checkerSize = 16;
+static const unsigned checkerColor1 = 0xff555555;
+static const unsigned checkerColor2 = 0xffaaaaaa;
+
+static cairo_pattern_t* checkerPattern()
+{
+    static cairo_pattern_t* pattern;
+    if (!pattern) {
+        RefPtr<cairo_surface_t> surface = adoptRef(cairo_image_surface_create(CAIRO_FORMAT_RGB24, checkerSize, checkerSize));
+        RefPtr<cairo_t> cr = adoptRef(cairo_create(surface.get()));
+        for (int y = 0; y < checkerSize; y += checkerSize / 2) {
+            bool alternate = y % checkerSize;
+            for (int x = 0; x < checkerSize; x += checkerSize / 2) {
+                setSourceRGBAFromColor(cr.get(), Color(alternate ? checkerColor1 : checkerColor2));
+                cairo_rectangle(cr.get(), x, y, checkerSize / 2, checkerSize / 2);
+                cairo_fill(cr.get());
+                alternate = !alternate;
+            }
+        }
+        pattern = cairo_pattern_create_for_surface(surface.get());
+        cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+    }
+    return pattern;
+}
+
+TileCairo::TileCairo(TiledBackingStore* backingStore, const Coordinate& tileCoordinate)
+    : m_backingStore(backingStore)
+    , m_coordinate(tileCoordinate)
+    , m_rect(m_backingStore->tileRectForCoordinate(tileCoordinate))
+    , m_dirtyRegion(m_rect)
+{
+}
+
+TileCairo::~TileCairo()
+{
+}
+
+bool TileCairo::isDirty() const
+{
+    return !m_dirtyRegion.isEmpty();
+}
+
+bool TileCairo::isReadyToPaint() const
+{
+    return m_buffer;
+}
+
+void TileCairo::invalidate(const IntRect& dirtyRect)
+{
+    IntRect tileDirtyRect = intersection(dirtyRect, m_rect);
+    if (tileDirtyRect.isEmpty())
+        return;
+
+    m_dirtyRegion.unite(tileDirtyRect);
+}
+
+Vector<IntRect> TileCairo::updateBackBuffer()
+{
+    if (m_buffer && !isDirty())
+        return Vector<IntRect>();
+
+    if (!m_backBuffer) {
+        if (!m_buffer) {
+            IntSize size = m_backingStore->tileSize();
+            m_backBuffer = adoptRef(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size.width(), size.height()));
+            RefPtr<cairo_t> cr = adoptRef(cairo_create(m_backBuffer.get()));
+            cairo_set_operator(cr.get(), CAIRO_OPERATOR_SOURCE);
+            setSourceRGBAFromColor(cr.get(), m_backingStore->client()->tiledBackingStoreBackgroundColor());
+            cairo_paint(cr.get());
+        } else {
+            // Currently all buffers are updated synchronously at the same time so there is no real need
+            // to have separate back and front buffers. Just use the existing buffer.
+            m_backBuffer = m_buffer.release();
+        }
+    }
+
+    Vector<IntRect> dirtyRects = m_dirtyRegion.rects();
+    m_dirtyRegion = Region();
+
+    RefPtr<cairo_t> cr = adoptRef(cairo_create(m_backBuffer.get()));
+    GraphicsContext context(cr.get());
+    context.translate(-m_rect.x(), -m_rect.y());
+
+    Vector<IntRect> updatedRects;
+    size_t size = dirtyRects.size();
+    for (size_t n = 0; n < size; ++n) {
+        context.save();
+        IntRect rect = dirtyRects[n];
+        updatedRects.append(rect);
+        context.clip(FloatRect(rect));
+        // Transparent views must not keep what was painted here before.
+        context.clearRect(FloatRect(rect));
+        context.scale(FloatSize(m_backingStore->contentsScale(), m_backingStore->contentsScale()));
+        m_backingStore->client()->tiledBackingStorePaint(&context, m_backingStore->mapToContents(rect));
+        context.restore();
+    }
+    cairo_surface_flush(m_backBuffer.get());
+
+    return updatedRects;
+}
+
+void TileCairo::swapBackBufferToFront()
+{
+    if (!m_backBuffer)
+        return;
+    m_buffer = m_backBuffer.release();
+}
+
+void TileCairo::paint(GraphicsContext* context, const IntRect& rect)
+{
+    if (!m_buffer)
+        return;
+
+    IntRect target = intersection(rect, m_rect);
+    if (target.isEmpty())
+        return;
+
+    cairo_t* cr = context->platformContext()->cr();
+    cairo_save(cr);
+    cairo_set_source_surface(cr, m_buffer.get(), m_rect.x(), m_rect.y());
+    cairo_rectangle(cr, target.x(), target.y(), target.width(), target.height());
+    cairo_fill(cr);
+    cairo_restore(cr);
+}
+
+void TileCairo::resize(const IntSize& newSize)
+{
+    IntRect oldRect = m_rect;
+    m_rect = IntRect(m_rect.location(), newSize);
+    if (m_rect.maxX() > oldRect.maxX())
+        invalidate(IntRect(oldRect.maxX(), oldRect.y(), m_rect.maxX() - oldRect.maxX(), m_rect.height()));
+    if (m_rect.maxY() > oldRect.maxY())
+        invalidate(IntRect(oldRect.x(), oldRect.maxY(), m_rect.width(), m_rect.maxY() - oldRect.maxY()));
+}
+
+void TiledBackingStoreBackend::paintCheckerPattern(GraphicsContext* context, const FloatRect& target)
+{
+    cairo_t* cr = context->platformContext()->cr();
+    cairo_save(cr);
+    cairo_set_source(cr, checkerPattern());
+    cairo_rectangle(cr, target.x(), target.y(), target.width(), target.height());
+    cairo_fill(cr);
+    cairo_restore(cr);
+}
+
+PassRefPtr<Tile> TiledBackingStoreBackend::createTile(TiledBackingStore* backingStore, const Tile::Coordinate& tileCoordinate)
+{
+    return TileCairo::create(backingStore, tileCoordinate);
+}
+
+}
+
+#endif
@@ -86,27 +86,16 @@ static inline unsigned char lighten(unsigned char colorA, unsigned char colorB,
     return ((std::max((255 - alphaA) * colorB + colorA * 255, (255 - alphaB) * colorA + colorB * 255)) / 255);
 }
 
-void FEBlend::platformApplySoftware()
+void FEBlend::platformApplyWorker(PlatformApplyParameters* parameters)
 {
-    FilterEffect* in = inputEffect(0);
-    FilterEffect* in2 = inputEffect(1);
-
-    ASSERT(m_mode > FEBLEND_MODE_UNKNOWN);
-    ASSERT(m_mode <= FEBLEND_MODE_LIGHTEN);
-
-    ByteArray* dstPixelArray = createPremultipliedImageResult();
-    if (!dstPixelArray)
-        return;
-
-    IntRect effectADrawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
-    RefPtr<ByteArray> srcPixelArrayA = in->asPremultipliedImage(effectADrawingRect);
-
-    IntRect effectBDrawingRect = requestedRegionOfInputImageData(in2->absolutePaintRect());
-    RefPtr<ByteArray> srcPixelArrayB = in2->asPremultipliedImage(effectBDrawingRect);
-
-    unsigned pixelArrayLength = srcPixelArrayA->length();
-    ASSERT(pixelArrayLength == srcPixelArrayB->length());
-    for (unsigned pixelOffset = 0; pixelOffset < pixelArrayLength; pixelOffset += 4) {
+    ByteArray* srcPixelArrayA = parameters->srcPixelArrayA;
+    ByteArray* srcPixelArrayB = parameters->srcPixelArrayB;
+    ByteArray* dstPixelArray = parameters->dstPixelArray;
+    BlendModeType mode = parameters->mode;
+    unsigned startOffset = parameters->startY * parameters->width * 4;
+    unsigned endOffset = parameters->endY * parameters->width * 4;
+
+    for (unsigned pixelOffset = startOffset; pixelOffset < endOffset; pixelOffset += 4) {
         unsigned char alphaA = srcPixelArrayA->get(pixelOffset + 3);
         unsigned char alphaB = srcPixelArrayB->get(pixelOffset + 3);
         for (unsigned channel = 0; channel < 3; ++channel) {
@@ -114,7 +103,7 @@ void FEBlend::platformApplySoftware()
             unsigned char colorB = srcPixelArrayB->get(pixelOffset + channel);
             unsigned char result;
 
-            switch (m_mode) {
+            switch (mode) {
             case FEBLEND_MODE_NORMAL:
                 result = normal(colorA, colorB, alphaA, alphaB);
                 break;
@@ -143,6 +132,35 @@ void FEBlend::platformApplySoftware()
     }
 }
 
+void FEBlend::platformApplySoftware()
+{
+    FilterEffect* in = inputEffect(0);
+    FilterEffect* in2 = inputEffect(1);
+
+    ASSERT(m_mode > FEBLEND_MODE_UNKNOWN);
+    ASSERT(m_mode <= FEBLEND_MODE_LIGHTEN);
+
+    ByteArray* dstPixelArray = createPremultipliedImageResult();
+    if (!dstPixelArray)
+        return;
+
+    IntRect effectADrawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
+    RefPtr<ByteArray> srcPixelArrayA = in->asPremultipliedImage(effectADrawingRect);
+
+    IntRect effectBDrawingRect = requestedRegionOfInputImageData(in2->absolutePaintRect());
+    RefPtr<ByteArray> srcPixelArrayB = in2->asPremultipliedImage(effectBDrawingRect);
+
+    ASSERT(srcPixelArrayA->length() == srcPixelArrayB->length());
+    IntSize paintSize = absolutePaintRect().size();
+    PlatformApplyParameters parameters;
+    parameters.srcPixelArrayA = srcPixelArrayA.get();
+    parameters.srcPixelArrayB = srcPixelArrayB.get();
+    parameters.dstPixelArray = dstPixelArray;
+    parameters.mode = m_mode;
+    parameters.width = paintSize.width();
+    applyInRowBands(&platformApplyWorker, parameters, paintSize.width(), paintSize.height());
+}
+
 void FEBlend::dump()
 {
 }
@@ -53,6 +53,18 @@ public:
 private:
     FEBlend(Filter*, BlendModeType);
 
+    struct PlatformApplyParameters {
+        ByteArray* srcPixelArrayA;
+        ByteArray* srcPixelArrayB;
+        ByteArray* dstPixelArray;
+        BlendModeType mode;
+        int width;
+        int startY;
+        int endY;
+    };
+
+    static void platformApplyWorker(PlatformApplyParameters*);
+
     BlendModeType m_mode;
 };
 
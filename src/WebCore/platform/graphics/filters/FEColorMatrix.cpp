@@ -125,10 +125,9 @@ inline void luminance(double& red, double& green, double& blue, double& alpha)
 }
 
 template<ColorMatrixType filterType>
-void effectType(ByteArray* pixelArray, const Vector<float>& values)
+void effectType(ByteArray* pixelArray, const Vector<float>& values, unsigned startOffset, unsigned endOffset)
 {
-    unsigned pixelArrayLength = pixelArray->length();
-    for (unsigned pixelByteOffset = 0; pixelByteOffset < pixelArrayLength; pixelByteOffset += 4) {
+    for (unsigned pixelByteOffset = startOffset; pixelByteOffset < endOffset; pixelByteOffset += 4) {
         double red = pixelArray->get(pixelByteOffset);
         double green = pixelArray->get(pixelByteOffset + 1);
         double blue = pixelArray->get(pixelByteOffset + 2);
@@ -156,6 +155,29 @@ void effectType(ByteArray* pixelArray, const Vector<float>& values)
     }
 }
 
+void FEColorMatrix::platformApplyWorker(PlatformApplyParameters* parameters)
+{
+    unsigned startOffset = parameters->startY * parameters->width * 4;
+    unsigned endOffset = parameters->endY * parameters->width * 4;
+
+    switch (parameters->type) {
+    case FECOLORMATRIX_TYPE_UNKNOWN:
+        break;
+    case FECOLORMATRIX_TYPE_MATRIX:
+        effectType<FECOLORMATRIX_TYPE_MATRIX>(parameters->pixelArray, *parameters->values, startOffset, endOffset);
+        break;
+    case FECOLORMATRIX_TYPE_SATURATE:
+        effectType<FECOLORMATRIX_TYPE_SATURATE>(parameters->pixelArray, *parameters->values, startOffset, endOffset);
+        break;
+    case FECOLORMATRIX_TYPE_HUEROTATE:
+        effectType<FECOLORMATRIX_TYPE_HUEROTATE>(parameters->pixelArray, *parameters->values, startOffset, endOffset);
+        break;
+    case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
+        effectType<FECOLORMATRIX_TYPE_LUMINANCETOALPHA>(parameters->pixelArray, *parameters->values, startOffset, endOffset);
+        break;
+    }
+}
+
 void FEColorMatrix::platformApplySoftware()
 {
     FilterEffect* in = inputEffect(0);
@@ -169,23 +191,15 @@ void FEColorMatrix::platformApplySoftware()
     IntRect imageRect(IntPoint(), absolutePaintRect().size());
     RefPtr<ByteArray> pixelArray = resultImage->getUnmultipliedImageData(imageRect);
 
-    switch (m_type) {
-    case FECOLORMATRIX_TYPE_UNKNOWN:
-        break;
-    case FECOLORMATRIX_TYPE_MATRIX:
-        effectType<FECOLORMATRIX_TYPE_MATRIX>(pixelArray.get(), m_values);
-        break;
-    case FECOLORMATRIX_TYPE_SATURATE: 
-        effectType<FECOLORMATRIX_TYPE_SATURATE>(pixelArray.get(), m_values);
-        break;
-    case FECOLORMATRIX_TYPE_HUEROTATE:
-        effectType<FECOLORMATRIX_TYPE_HUEROTATE>(pixelArray.get(), m_values);
-        break;
-    case FECOLORMATRIX_TYPE_LUMINANCETOALPHA:
-        effectType<FECOLORMATRIX_TYPE_LUMINANCETOALPHA>(pixelArray.get(), m_values);
+    PlatformApplyParameters parameters;
+    parameters.pixelArray = pixelArray.get();
+    parameters.type = m_type;
+    parameters.values = &m_values;
+    parameters.width = imageRect.width();
+    applyInRowBands(&platformApplyWorker, parameters, imageRect.width(), imageRect.height());
+
+    if (m_type == FECOLORMATRIX_TYPE_LUMINANCETOALPHA)
         setIsAlphaImage(true);
-        break;
-    }
 
     resultImage->putUnmultipliedImageData(pixelArray.get(), imageRect.size(), imageRect, IntPoint());
 }
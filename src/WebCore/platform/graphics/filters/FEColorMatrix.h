@@ -56,6 +56,17 @@ public:
 private:
     FEColorMatrix(Filter*, ColorMatrixType, const Vector<float>&);
 
+    struct PlatformApplyParameters {
+        ByteArray* pixelArray;
+        ColorMatrixType type;
+        const Vector<float>* values;
+        int width;
+        int startY;
+        int endY;
+    };
+
+    static void platformApplyWorker(PlatformApplyParameters*);
+
     ColorMatrixType m_type;
     Vector<float> m_values;
 };
@@ -150,6 +150,21 @@ static void gamma(unsigned char* values, const ComponentTransferFunction& transf
     }
 }
 
+void FEComponentTransfer::platformApplyWorker(PlatformApplyParameters* parameters)
+{
+    ByteArray* pixelArray = parameters->pixelArray;
+    unsigned char** tables = parameters->tables;
+    unsigned startOffset = parameters->startY * parameters->width * 4;
+    unsigned endOffset = parameters->endY * parameters->width * 4;
+
+    for (unsigned pixelOffset = startOffset; pixelOffset < endOffset; pixelOffset += 4) {
+        for (unsigned channel = 0; channel < 4; ++channel) {
+            unsigned char c = pixelArray->get(pixelOffset + channel);
+            pixelArray->set(pixelOffset + channel, tables[channel][c]);
+        }
+    }
+}
+
 void FEComponentTransfer::platformApplySoftware()
 {
     FilterEffect* in = inputEffect(0);
@@ -173,13 +188,12 @@ void FEComponentTransfer::platformApplySoftware()
     IntRect drawingRect = requestedRegionOfInputImageData(in->absolutePaintRect());
     in->copyUnmultipliedImage(pixelArray, drawingRect);
 
-    unsigned pixelArrayLength = pixelArray->length();
-    for (unsigned pixelOffset = 0; pixelOffset < pixelArrayLength; pixelOffset += 4) {
-        for (unsigned channel = 0; channel < 4; ++channel) {
-            unsigned char c = pixelArray->get(pixelOffset + channel);
-            pixelArray->set(pixelOffset + channel, tables[channel][c]);
-        }
-    }
+    IntSize paintSize = absolutePaintRect().size();
+    PlatformApplyParameters parameters;
+    parameters.pixelArray = pixelArray;
+    parameters.tables = tables;
+    parameters.width = paintSize.width();
+    applyInRowBands(&platformApplyWorker, parameters, paintSize.width(), paintSize.height());
 }
 
 void FEComponentTransfer::dump()
@@ -87,6 +87,16 @@ private:
     FEComponentTransfer(Filter*, const ComponentTransferFunction& redFunc, const ComponentTransferFunction& greenFunc,
                         const ComponentTransferFunction& blueFunc, const ComponentTransferFunction& alphaFunc);
 
+    struct PlatformApplyParameters {
+        ByteArray* pixelArray;
+        unsigned char** tables;
+        int width;
+        int startY;
+        int endY;
+    };
+
+    static void platformApplyWorker(PlatformApplyParameters*);
+
     ComponentTransferFunction m_redFunc;
     ComponentTransferFunction m_greenFunc;
     ComponentTransferFunction m_blueFunc;
@@ -150,14 +150,9 @@ inline void computeArithmeticPixels(unsigned char* source, unsigned char* destin
     }
 }
 
-inline void arithmetic(ByteArray* srcPixelArrayA, ByteArray* srcPixelArrayB,
+inline void arithmetic(unsigned char* source, unsigned char* destination, int pixelArrayLength,
                        float k1, float k2, float k3, float k4)
 {
-    int pixelArrayLength = srcPixelArrayA->length();
-    ASSERT(pixelArrayLength == static_cast<int>(srcPixelArrayB->length()));
-    unsigned char* source = srcPixelArrayA->data();
-    unsigned char* destination = srcPixelArrayB->data();
-
     if (!k4) {
         if (!k1) {
             computeArithmeticPixels<0, 1, 1, 0>(source, destination, pixelArrayLength, k1, k2, k3, k4);
@@ -175,6 +170,14 @@ inline void arithmetic(ByteArray* srcPixelArrayA, ByteArray* srcPixelArrayB,
     computeArithmeticPixels<1, 1, 1, 1>(source, destination, pixelArrayLength, k1, k2, k3, k4);
 }
 
+void FEComposite::arithmeticWorker(ArithmeticParameters* parameters)
+{
+    int startOffset = parameters->startY * parameters->width * 4;
+    int length = (parameters->endY - parameters->startY) * parameters->width * 4;
+    arithmetic(parameters->srcPixelArray->data() + startOffset, parameters->dstPixelArray->data() + startOffset, length,
+               parameters->k1, parameters->k2, parameters->k3, parameters->k4);
+}
+
 void FEComposite::determineAbsolutePaintRect()
 {
     switch (m_type) {
@@ -212,7 +215,17 @@ void FEComposite::platformApplySoftware()
         IntRect effectBDrawingRect = requestedRegionOfInputImageData(in2->absolutePaintRect());
         in2->copyPremultipliedImage(dstPixelArray, effectBDrawingRect);
 
-        arithmetic(srcPixelArray.get(), dstPixelArray, m_k1, m_k2, m_k3, m_k4);
+        ASSERT(srcPixelArray->length() == dstPixelArray->length());
+        IntSize paintSize = absolutePaintRect().size();
+        ArithmeticParameters parameters;
+        parameters.srcPixelArray = srcPixelArray.get();
+        parameters.dstPixelArray = dstPixelArray;
+        parameters.k1 = m_k1;
+        parameters.k2 = m_k2;
+        parameters.k3 = m_k3;
+        parameters.k4 = m_k4;
+        parameters.width = paintSize.width();
+        applyInRowBands(&arithmeticWorker, parameters, paintSize.width(), paintSize.height());
         return;
     }
 
@@ -69,6 +69,20 @@ public:
 private:
     FEComposite(Filter*, const CompositeOperationType&, float, float, float, float);
 
+    struct ArithmeticParameters {
+        ByteArray* srcPixelArray;
+        ByteArray* dstPixelArray;
+        float k1;
+        float k2;
+        float k3;
+        float k4;
+        int width;
+        int startY;
+        int endY;
+    };
+
+    static void arithmeticWorker(ArithmeticParameters*);
+
     CompositeOperationType m_type;
     float m_k1;
     float m_k2;
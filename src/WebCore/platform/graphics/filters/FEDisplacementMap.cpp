@@ -88,6 +88,32 @@ bool FEDisplacementMap::setScale(float scale)
     return true;
 }
 
+void FEDisplacementMap::platformApplyWorker(PlatformApplyParameters* parameters)
+{
+    ByteArray* srcPixelArrayA = parameters->srcPixelArrayA;
+    ByteArray* srcPixelArrayB = parameters->srcPixelArrayB;
+    ByteArray* dstPixelArray = parameters->dstPixelArray;
+    int width = parameters->width;
+    int height = parameters->height;
+    int stride = width * 4;
+    for (int y = parameters->startY; y < parameters->endY; ++y) {
+        int line = y * stride;
+        for (int x = 0; x < width; ++x) {
+            int dstIndex = line + x * 4;
+            int srcX = x + static_cast<int>(parameters->scaleX * srcPixelArrayB->get(dstIndex + parameters->xChannelSelector - 1) + parameters->scaleAdjustmentX);
+            int srcY = y + static_cast<int>(parameters->scaleY * srcPixelArrayB->get(dstIndex + parameters->yChannelSelector - 1) + parameters->scaleAdjustmentY);
+            for (unsigned channel = 0; channel < 4; ++channel) {
+                if (srcX < 0 || srcX >= width || srcY < 0 || srcY >= height)
+                    dstPixelArray->set(dstIndex + channel, static_cast<unsigned char>(0));
+                else {
+                    unsigned char pixelValue = srcPixelArrayA->get(srcY * stride + srcX * 4 + channel);
+                    dstPixelArray->set(dstIndex + channel, pixelValue);
+                }
+            }
+        }
+    }
+}
+
 void FEDisplacementMap::platformApplySoftware()
 {
     FilterEffect* in = inputEffect(0);
@@ -110,27 +136,19 @@ void FEDisplacementMap::platformApplySoftware()
 
     Filter* filter = this->filter();
     IntSize paintSize = absolutePaintRect().size();
-    float scaleX = filter->applyHorizontalScale(m_scale / 255);
-    float scaleY = filter->applyVerticalScale(m_scale / 255);
-    float scaleAdjustmentX = filter->applyHorizontalScale(0.5f - 0.5f * m_scale);
-    float scaleAdjustmentY = filter->applyVerticalScale(0.5f - 0.5f * m_scale);
-    int stride = paintSize.width() * 4;
-    for (int y = 0; y < paintSize.height(); ++y) {
-        int line = y * stride;
-        for (int x = 0; x < paintSize.width(); ++x) {
-            int dstIndex = line + x * 4;
-            int srcX = x + static_cast<int>(scaleX * srcPixelArrayB->get(dstIndex + m_xChannelSelector - 1) + scaleAdjustmentX);
-            int srcY = y + static_cast<int>(scaleY * srcPixelArrayB->get(dstIndex + m_yChannelSelector - 1) + scaleAdjustmentY);
-            for (unsigned channel = 0; channel < 4; ++channel) {
-                if (srcX < 0 || srcX >= paintSize.width() || srcY < 0 || srcY >= paintSize.height())
-                    dstPixelArray->set(dstIndex + channel, static_cast<unsigned char>(0));
-                else {
-                    unsigned char pixelValue = srcPixelArrayA->get(srcY * stride + srcX * 4 + channel);
-                    dstPixelArray->set(dstIndex + channel, pixelValue);
-                }
-            }
-        }
-    }
+    PlatformApplyParameters parameters;
+    parameters.srcPixelArrayA = srcPixelArrayA.get();
+    parameters.srcPixelArrayB = srcPixelArrayB.get();
+    parameters.dstPixelArray = dstPixelArray;
+    parameters.xChannelSelector = m_xChannelSelector;
+    parameters.yChannelSelector = m_yChannelSelector;
+    parameters.scaleX = filter->applyHorizontalScale(m_scale / 255);
+    parameters.scaleY = filter->applyVerticalScale(m_scale / 255);
+    parameters.scaleAdjustmentX = filter->applyHorizontalScale(0.5f - 0.5f * m_scale);
+    parameters.scaleAdjustmentY = filter->applyVerticalScale(0.5f - 0.5f * m_scale);
+    parameters.width = paintSize.width();
+    parameters.height = paintSize.height();
+    applyInRowBands(&platformApplyWorker, parameters, paintSize.width(), paintSize.height());
 }
 
 void FEDisplacementMap::dump()
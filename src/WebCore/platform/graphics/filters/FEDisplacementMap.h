@@ -60,6 +60,24 @@ public:
 private:
     FEDisplacementMap(Filter*, ChannelSelectorType xChannelSelector, ChannelSelectorType yChannelSelector, float);
 
+    struct PlatformApplyParameters {
+        ByteArray* srcPixelArrayA;
+        ByteArray* srcPixelArrayB;
+        ByteArray* dstPixelArray;
+        ChannelSelectorType xChannelSelector;
+        ChannelSelectorType yChannelSelector;
+        float scaleX;
+        float scaleY;
+        float scaleAdjustmentX;
+        float scaleAdjustmentY;
+        int width;
+        int height;
+        int startY;
+        int endY;
+    };
+
+    static void platformApplyWorker(PlatformApplyParameters*);
+
     ChannelSelectorType m_xChannelSelector;
     ChannelSelectorType m_yChannelSelector;
     float m_scale;
@@ -27,6 +27,7 @@
 #include "IntRect.h"
 
 #include <wtf/ByteArray.h>
+#include <wtf/ParallelJobs.h>
 #include <wtf/PassOwnPtr.h>
 #include <wtf/RefCounted.h>
 #include <wtf/RefPtr.h>
@@ -125,6 +126,16 @@ protected:
     ByteArray* createUnmultipliedImageResult();
     ByteArray* createPremultipliedImageResult();
 
+    // Runs a per-pixel operation over rows [0, height) of the result. Parameters needs
+    // int startY and endY members; they are set for each band of rows before the worker
+    // is called. Large images are split across the shared ParallelJobs thread pool.
+    template<typename Parameters>
+    static void applyInRowBands(void (*worker)(Parameters*), Parameters&, int width, int height);
+
+#if ENABLE(PARALLEL_JOBS)
+    static const int s_minimalRowBandArea = 100 * 100; // Empirical data limit for parallel jobs
+#endif
+
 private:
     OwnPtr<ImageBuffer> m_imageBufferResult;
     RefPtr<ByteArray> m_unmultipliedImageResult;
@@ -159,6 +170,37 @@ private:
     bool m_hasHeight;
 };
 
+template<typename Parameters>
+inline void FilterEffect::applyInRowBands(void (*worker)(Parameters*), Parameters& parameters, int width, int height)
+{
+#if ENABLE(PARALLEL_JOBS)
+    int optimalThreadNumber = (width * height) / s_minimalRowBandArea;
+    if (optimalThreadNumber > 1) {
+        ParallelJobs<Parameters> parallelJobs(worker, optimalThreadNumber);
+        int jobs = parallelJobs.numberOfJobs();
+        if (jobs > 1) {
+            int startY = 0;
+            for (int job = 0; job < jobs; ++job) {
+                Parameters& params = parallelJobs.parameter(job);
+                params = parameters;
+                params.startY = startY;
+                startY += height / jobs + (job < height % jobs ? 1 : 0);
+                params.endY = startY;
+            }
+            ASSERT(startY == height);
+            parallelJobs.execute();
+            return;
+        }
+    }
+#else
+    UNUSED_PARAM(width);
+#endif
+
+    parameters.startY = 0;
+    parameters.endY = height;
+    worker(&parameters);
+}
+
 } // namespace WebCore
 
 #endif // ENABLE(FILTERS)
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PixelKernelsX86.h"
+
+#if HAVE(AVX2_INTRINSICS)
+
+#include <algorithm>
+#include <immintrin.h>
+
+#if COMPILER(MSVC)
+#include <intrin.h>
+// MSVC accepts AVX2 intrinsics anywhere.
+#define AVX2_FUNCTION
+#else
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+namespace WebCore {
+
+static bool cpuSupportsAVX2()
+{
+#if COMPILER(MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // The OS has to save the AVX registers on context switches as well.
+    const int osxsaveAndAVX = (1 << 27) | (1 << 28);
+    if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+struct ColumnSums {
+    __m256i sums[4];
+};
+
+static inline AVX2_FUNCTION void addColumnPixels(ColumnSums& columnSums, const unsigned char* pixels)
+{
+    for (int i = 0; i < 4; ++i) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + i * 8));
+        columnSums.sums[i] = _mm256_add_epi32(columnSums.sums[i], _mm256_cvtepu8_epi32(bytes));
+    }
+}
+
+static inline AVX2_FUNCTION void subtractColumnPixels(ColumnSums& columnSums, const unsigned char* pixels)
+{
+    for (int i = 0; i < 4; ++i) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + i * 8));
+        columnSums.sums[i] = _mm256_sub_epi32(columnSums.sums[i], _mm256_cvtepu8_epi32(bytes));
+    }
+}
+
+static inline AVX2_FUNCTION __m256i boxBlurAverage(__m256i sum, __m256 reciprocal)
+{
+    return _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(sum), reciprocal));
+}
+
+// Eight neighbouring columns of a vertical pass at a time, see boxBlurColumnsSSE2.
+static AVX2_FUNCTION void boxBlurColumnsAVX2(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+    int stride, int effectWidth, int effectHeight, bool alphaImage)
+{
+    const __m256 reciprocal = _mm256_set1_ps(boxBlurReciprocal(kernelSize));
+    const __m256i alphaMask = _mm256_set1_epi32(alphaImage ? 0xFF000000 : 0xFFFFFFFF);
+    // Packing works within 128 bit halves; this puts the four byte groups back in order.
+    const __m256i packedOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int maxKernelSize = std::min(distanceRight, effectWidth);
+
+    int column = 0;
+    for (; column + 8 <= effectHeight; column += 8) {
+        const unsigned char* sourceColumns = source + column * 4;
+        unsigned char* destinationColumns = destination + column * 4;
+
+        ColumnSums columnSums;
+        for (int i = 0; i < 4; ++i)
+            columnSums.sums[i] = _mm256_setzero_si256();
+        for (int i = 0; i < maxKernelSize; ++i)
+            addColumnPixels(columnSums, sourceColumns + i * stride);
+
+        for (int x = 0; x < effectWidth; ++x) {
+            __m256i low = _mm256_packs_epi32(boxBlurAverage(columnSums.sums[0], reciprocal), boxBlurAverage(columnSums.sums[1], reciprocal));
+            __m256i high = _mm256_packs_epi32(boxBlurAverage(columnSums.sums[2], reciprocal), boxBlurAverage(columnSums.sums[3], reciprocal));
+            __m256i pixels = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), packedOrder);
+            __m256i* destinationPixels = reinterpret_cast<__m256i*>(destinationColumns + x * stride);
+            pixels = _mm256_or_si256(_mm256_and_si256(alphaMask, pixels), _mm256_andnot_si256(alphaMask, _mm256_loadu_si256(destinationPixels)));
+            _mm256_storeu_si256(destinationPixels, pixels);
+
+            if (x >= distanceLeft)
+                subtractColumnPixels(columnSums, sourceColumns + (x - distanceLeft) * stride);
+            if (x + distanceRight < effectWidth)
+                addColumnPixels(columnSums, sourceColumns + (x + distanceRight) * stride);
+        }
+    }
+
+    if (column < effectHeight)
+        boxBlurSSE2(source + column * 4, destination + column * 4, kernelSize, distanceLeft, distanceRight, stride, 4, effectWidth, effectHeight - column, alphaImage);
+}
+
+static void boxBlurAVX2(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+    int stride, int strideLine, int effectWidth, int effectHeight, bool alphaImage)
+{
+    // A horizontal pass only has the four channels of a pixel to work on in parallel.
+    if (strideLine == 4 && stride != 4 && kernelSize <= boxBlurMaximumSIMDKernelSize)
+        boxBlurColumnsAVX2(source, destination, kernelSize, distanceLeft, distanceRight, stride, effectWidth, effectHeight, alphaImage);
+    else
+        boxBlurSSE2(source, destination, kernelSize, distanceLeft, distanceRight, stride, strideLine, effectWidth, effectHeight, alphaImage);
+}
+
+static inline AVX2_FUNCTION __m256i clampTo255(__m256i values)
+{
+    return _mm256_min_epi32(values, _mm256_set1_epi32(255));
+}
+
+static AVX2_FUNCTION void premultipliedARGBToUnmultipliedRGBAAVX2(const unsigned* source, unsigned char* destination, unsigned pixelCount)
+{
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256 scaledMaximum = _mm256_set1_ps(static_cast<float>(255 * (1 + 1.0 / (1 << 20))));
+    const __m256 one = _mm256_set1_ps(1);
+
+    unsigned i = 0;
+    for (; i + 8 <= pixelCount; i += 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        __m256i alpha = _mm256_srli_epi32(pixels, 24);
+        __m256 alphaFloat = _mm256_cvtepi32_ps(alpha);
+        __m256 transparent = _mm256_cmp_ps(alphaFloat, _mm256_setzero_ps(), _CMP_EQ_OQ);
+        __m256 scale = _mm256_blendv_ps(_mm256_div_ps(scaledMaximum, alphaFloat), one, transparent);
+
+        __m256i red = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), byteMask);
+        __m256i green = _mm256_and_si256(_mm256_srli_epi32(pixels, 8), byteMask);
+        __m256i blue = _mm256_and_si256(pixels, byteMask);
+        red = clampTo255(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(red), scale)));
+        green = clampTo255(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(green), scale)));
+        blue = clampTo255(_mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(blue), scale)));
+
+        __m256i result = _mm256_or_si256(_mm256_or_si256(red, _mm256_slli_epi32(green, 8)), _mm256_or_si256(_mm256_slli_epi32(blue, 16), _mm256_slli_epi32(alpha, 24)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4), result);
+    }
+
+    sse2PixelKernels()->premultipliedARGBToUnmultipliedRGBA(source + i, destination + i * 4, pixelCount - i);
+}
+
+static inline AVX2_FUNCTION __m256i premultiplyFourPixels(__m256i pixels)
+{
+    // See premultiplyTwoPixels.
+    const __m256i colorMask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+    const __m256i alphaMultiplier = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i multiplier = _mm256_or_si256(_mm256_and_si256(alpha, colorMask), alphaMultiplier);
+
+    __m256i product = _mm256_add_epi16(_mm256_mullo_epi16(pixels, multiplier), _mm256_set1_epi16(254));
+    __m256i quotient = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(product, _mm256_set1_epi16(1)), _mm256_srli_epi16(product, 8)), 8);
+
+    __m256i transparent = _mm256_cmpeq_epi16(alpha, _mm256_setzero_si256());
+    quotient = _mm256_blendv_epi8(quotient, pixels, transparent);
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(quotient, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+static AVX2_FUNCTION void unmultipliedRGBAToPremultipliedARGBAVX2(const unsigned char* source, unsigned* destination, unsigned pixelCount)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    unsigned i = 0;
+    for (; i + 8 <= pixelCount; i += 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+        // Unpacking and packing both work within 128 bit halves, so the pixel order is kept.
+        __m256i low = premultiplyFourPixels(_mm256_unpacklo_epi8(pixels, zero));
+        __m256i high = premultiplyFourPixels(_mm256_unpackhi_epi8(pixels, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_packus_epi16(low, high));
+    }
+
+    sse2PixelKernels()->unmultipliedRGBAToPremultipliedARGB(source + i * 4, destination + i, pixelCount - i);
+}
+
+static inline AVX2_FUNCTION unsigned swapRedAndBlueAVX2(const void* source, void* destination, unsigned pixelCount)
+{
+    const __m256i order = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    const __m256i* sourcePixels = static_cast<const __m256i*>(source);
+    __m256i* destinationPixels = static_cast<__m256i*>(destination);
+    unsigned vectorCount = pixelCount / 8;
+    for (unsigned i = 0; i < vectorCount; ++i)
+        _mm256_storeu_si256(destinationPixels + i, _mm256_shuffle_epi8(_mm256_loadu_si256(sourcePixels + i), order));
+    return vectorCount * 8;
+}
+
+static void premultipliedARGBToPremultipliedRGBAAVX2(const unsigned* source, unsigned char* destination, unsigned pixelCount)
+{
+    unsigned done = swapRedAndBlueAVX2(source, destination, pixelCount);
+    sse2PixelKernels()->premultipliedARGBToPremultipliedRGBA(source + done, destination + done * 4, pixelCount - done);
+}
+
+static void premultipliedRGBAToPremultipliedARGBAVX2(const unsigned char* source, unsigned* destination, unsigned pixelCount)
+{
+    unsigned done = swapRedAndBlueAVX2(source, destination, pixelCount);
+    sse2PixelKernels()->premultipliedRGBAToPremultipliedARGB(source + done * 4, destination + done, pixelCount - done);
+}
+
+const PixelKernels* avx2PixelKernels()
+{
+    static const PixelKernels kernels = {
+        "AVX2",
+        boxBlurAVX2,
+        // Only the vertical pass of ShadowBlur is vectorized, and it is dominated by the loads.
+        shadowBlurSSE2,
+        premultipliedARGBToUnmultipliedRGBAAVX2,
+        premultipliedARGBToPremultipliedRGBAAVX2,
+        unmultipliedRGBAToPremultipliedARGBAVX2,
+        premultipliedRGBAToPremultipliedARGBAVX2
+    };
+    return cpuSupportsAVX2() ? &kernels : 0;
+}
+
+} // namespace WebCore
+
+#endif // HAVE(AVX2_INTRINSICS)
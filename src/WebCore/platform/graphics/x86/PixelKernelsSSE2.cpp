@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "PixelKernelsX86.h"
+
+#if CPU(X86_SSE2)
+
+#include <algorithm>
+#include <emmintrin.h>
+
+namespace WebCore {
+
+static inline __m128i loadPixel(const unsigned char* pixel)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(pixel));
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+}
+
+static inline __m128i boxBlurAverage(__m128i sum, __m128 reciprocal)
+{
+    return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), reciprocal));
+}
+
+// Every channel of one pixel is blurred at once, which is four times less
+// work than blurring the channels one after the other.
+static void boxBlurRowsSSE2(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+    int strideLine, int effectWidth, int effectHeight, bool alphaImage)
+{
+    const __m128 reciprocal = _mm_set1_ps(boxBlurReciprocal(kernelSize));
+    const unsigned alphaMask = alphaImage ? 0xFF000000 : 0xFFFFFFFF;
+    int maxKernelSize = std::min(distanceRight, effectWidth);
+
+    for (int y = 0; y < effectHeight; ++y) {
+        const unsigned char* line = source + y * strideLine;
+        unsigned* destinationLine = reinterpret_cast<unsigned*>(destination + y * strideLine);
+
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < maxKernelSize; ++i)
+            sum = _mm_add_epi32(sum, loadPixel(line + i * 4));
+
+        for (int x = 0; x < effectWidth; ++x) {
+            __m128i average = boxBlurAverage(sum, reciprocal);
+            average = _mm_packs_epi32(average, average);
+            average = _mm_packus_epi16(average, average);
+            unsigned pixel = _mm_cvtsi128_si32(average);
+            destinationLine[x] = (pixel & alphaMask) | (destinationLine[x] & ~alphaMask);
+
+            if (x >= distanceLeft)
+                sum = _mm_sub_epi32(sum, loadPixel(line + (x - distanceLeft) * 4));
+            if (x + distanceRight < effectWidth)
+                sum = _mm_add_epi32(sum, loadPixel(line + (x + distanceRight) * 4));
+        }
+    }
+}
+
+struct ColumnSums {
+    __m128i sums[4];
+};
+
+static inline void addColumnPixels(ColumnSums& columnSums, const unsigned char* pixels)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    __m128i low = _mm_unpacklo_epi8(bytes, zero);
+    __m128i high = _mm_unpackhi_epi8(bytes, zero);
+    columnSums.sums[0] = _mm_add_epi32(columnSums.sums[0], _mm_unpacklo_epi16(low, zero));
+    columnSums.sums[1] = _mm_add_epi32(columnSums.sums[1], _mm_unpackhi_epi16(low, zero));
+    columnSums.sums[2] = _mm_add_epi32(columnSums.sums[2], _mm_unpacklo_epi16(high, zero));
+    columnSums.sums[3] = _mm_add_epi32(columnSums.sums[3], _mm_unpackhi_epi16(high, zero));
+}
+
+static inline void subtractColumnPixels(ColumnSums& columnSums, const unsigned char* pixels)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    __m128i low = _mm_unpacklo_epi8(bytes, zero);
+    __m128i high = _mm_unpackhi_epi8(bytes, zero);
+    columnSums.sums[0] = _mm_sub_epi32(columnSums.sums[0], _mm_unpacklo_epi16(low, zero));
+    columnSums.sums[1] = _mm_sub_epi32(columnSums.sums[1], _mm_unpackhi_epi16(low, zero));
+    columnSums.sums[2] = _mm_sub_epi32(columnSums.sums[2], _mm_unpacklo_epi16(high, zero));
+    columnSums.sums[3] = _mm_sub_epi32(columnSums.sums[3], _mm_unpackhi_epi16(high, zero));
+}
+
+// A vertical pass walks down the image one row at a time, so four neighbouring
+// columns are blurred together from a single 16 byte load per row.
+static void boxBlurColumnsSSE2(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+    int stride, int effectWidth, int effectHeight, bool alphaImage)
+{
+    const __m128 reciprocal = _mm_set1_ps(boxBlurReciprocal(kernelSize));
+    const __m128i alphaMask = _mm_set1_epi32(alphaImage ? 0xFF000000 : 0xFFFFFFFF);
+    int maxKernelSize = std::min(distanceRight, effectWidth);
+
+    int column = 0;
+    for (; column + 4 <= effectHeight; column += 4) {
+        const unsigned char* sourceColumns = source + column * 4;
+        unsigned char* destinationColumns = destination + column * 4;
+
+        ColumnSums columnSums;
+        for (int i = 0; i < 4; ++i)
+            columnSums.sums[i] = _mm_setzero_si128();
+        for (int i = 0; i < maxKernelSize; ++i)
+            addColumnPixels(columnSums, sourceColumns + i * stride);
+
+        for (int x = 0; x < effectWidth; ++x) {
+            __m128i low = _mm_packs_epi32(boxBlurAverage(columnSums.sums[0], reciprocal), boxBlurAverage(columnSums.sums[1], reciprocal));
+            __m128i high = _mm_packs_epi32(boxBlurAverage(columnSums.sums[2], reciprocal), boxBlurAverage(columnSums.sums[3], reciprocal));
+            __m128i pixels = _mm_packus_epi16(low, high);
+            __m128i* destinationPixels = reinterpret_cast<__m128i*>(destinationColumns + x * stride);
+            pixels = _mm_or_si128(_mm_and_si128(alphaMask, pixels), _mm_andnot_si128(alphaMask, _mm_loadu_si128(destinationPixels)));
+            _mm_storeu_si128(destinationPixels, pixels);
+
+            if (x >= distanceLeft)
+                subtractColumnPixels(columnSums, sourceColumns + (x - distanceLeft) * stride);
+            if (x + distanceRight < effectWidth)
+                addColumnPixels(columnSums, sourceColumns + (x + distanceRight) * stride);
+        }
+    }
+
+    if (column < effectHeight)
+        portablePixelKernels().boxBlur(source + column * 4, destination + column * 4, kernelSize, distanceLeft, distanceRight, stride, 4, effectWidth, effectHeight - column, alphaImage);
+}
+
+void boxBlurSSE2(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+    int stride, int strideLine, int effectWidth, int effectHeight, bool alphaImage)
+{
+    if (kernelSize > boxBlurMaximumSIMDKernelSize)
+        portablePixelKernels().boxBlur(source, destination, kernelSize, distanceLeft, distanceRight, stride, strideLine, effectWidth, effectHeight, alphaImage);
+    else if (stride == 4)
+        boxBlurRowsSSE2(source, destination, kernelSize, distanceLeft, distanceRight, strideLine, effectWidth, effectHeight, alphaImage);
+    else if (strideLine == 4)
+        boxBlurColumnsSSE2(source, destination, kernelSize, distanceLeft, distanceRight, stride, effectWidth, effectHeight, alphaImage);
+    else
+        portablePixelKernels().boxBlur(source, destination, kernelSize, distanceLeft, distanceRight, stride, strideLine, effectWidth, effectHeight, alphaImage);
+}
+
+class ShadowBlurColumns {
+public:
+    ShadowBlurColumns(unsigned char* pixels, int stride, int readChannel, int writeChannel)
+        : m_pixels(pixels)
+        , m_stride(stride)
+        , m_readShift(_mm_cvtsi32_si128(readChannel * 8))
+        , m_writeShift(_mm_cvtsi32_si128(writeChannel * 8))
+        , m_writeMask(_mm_sll_epi32(_mm_set1_epi32(0xFF), m_writeShift))
+    {
+    }
+
+    __m128i read(int index) const
+    {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_pixels + index * m_stride));
+        return _mm_and_si128(_mm_srl_epi32(pixels, m_readShift), _mm_set1_epi32(0xFF));
+    }
+
+    void write(int index, __m128i values) const
+    {
+        __m128i* address = reinterpret_cast<__m128i*>(m_pixels + index * m_stride);
+        __m128i pixels = _mm_andnot_si128(m_writeMask, _mm_loadu_si128(address));
+        _mm_storeu_si128(address, _mm_or_si128(pixels, _mm_and_si128(_mm_sll_epi32(values, m_writeShift), m_writeMask)));
+    }
+
+private:
+    unsigned char* m_pixels;
+    int m_stride;
+    __m128i m_readShift;
+    __m128i m_writeShift;
+    __m128i m_writeMask;
+};
+
+static inline __m128i multiplyByteLanes(__m128i bytes, int factor)
+{
+    // Each 32 bit lane holds a byte, so its upper 16 bits are zero.
+    return _mm_madd_epi16(bytes, _mm_set1_epi32(factor));
+}
+
+// Same algorithm as shadowBlurPortable, applied to four adjacent lines at once.
+// The lines of a vertical pass are the columns, which are adjacent in memory.
+static void shadowBlurColumnsSSE2(unsigned char* pixels, int lineCount, int lineLength, int stride, const int lobes[3][2])
+{
+    const int channels[4] = { 3, 0, 1, 3 };
+    int dim = lineLength;
+
+    int line = 0;
+    for (; line + 4 <= lineCount; line += 4) {
+        for (int step = 0; step < 3; ++step) {
+            ShadowBlurColumns columns(pixels + line * 4, stride, channels[step], channels[step + 1]);
+            int side1 = lobes[step][0];
+            int side2 = lobes[step][1];
+            int pixelCount = side1 + 1 + side2;
+            int invCount = ((1 << shadowBlurSumShift) + pixelCount - 1) / pixelCount;
+            // The products stay below 2^24, so the float multiplication is exact.
+            const __m128 inverse = _mm_set1_ps(static_cast<float>(invCount));
+            const __m128i byteMask = _mm_set1_epi32(0xFF);
+            int ofs = 1 + side2;
+            __m128i alpha1 = columns.read(0);
+            __m128i alpha2 = columns.read(dim - 1);
+
+            int i;
+            __m128i sum = multiplyByteLanes(alpha1, side1 + 1);
+            int limit = (dim < side2 + 1) ? dim : side2 + 1;
+
+            for (i = 1; i < limit; ++i)
+                sum = _mm_add_epi32(sum, columns.read(i));
+
+            if (limit <= side2)
+                sum = _mm_add_epi32(sum, multiplyByteLanes(alpha2, side2 - limit + 1));
+
+#define SHADOW_BLUR_RESULT(sum) _mm_and_si128(_mm_srli_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), inverse)), shadowBlurSumShift), byteMask)
+
+            limit = (side1 < dim) ? side1 : dim;
+            for (i = 0; i < limit; ++i, ++ofs) {
+                columns.write(i, SHADOW_BLUR_RESULT(sum));
+                sum = _mm_add_epi32(sum, _mm_sub_epi32((ofs < dim) ? columns.read(ofs) : alpha2, alpha1));
+            }
+
+            int prev = 0;
+            for (; ofs < dim; ++i, ++ofs, ++prev) {
+                columns.write(i, SHADOW_BLUR_RESULT(sum));
+                sum = _mm_add_epi32(sum, _mm_sub_epi32(columns.read(ofs), columns.read(prev)));
+            }
+
+            for (; i < dim; ++i, ++prev) {
+                columns.write(i, SHADOW_BLUR_RESULT(sum));
+                sum = _mm_add_epi32(sum, _mm_sub_epi32(alpha2, columns.read(prev)));
+            }
+
+#undef SHADOW_BLUR_RESULT
+        }
+    }
+
+    if (line < lineCount)
+        portablePixelKernels().shadowBlur(pixels + line * 4, lineCount - line, lineLength, stride, 4, lobes);
+}
+
+void shadowBlurSSE2(unsigned char* pixels, int lineCount, int lineLength, int stride, int strideLine, const int lobes[3][2])
+{
+    bool productsFitInFloat = true;
+    for (int step = 0; step < 3; ++step) {
+        int pixelCount = lobes[step][0] + 1 + lobes[step][1];
+        int invCount = ((1 << shadowBlurSumShift) + pixelCount - 1) / pixelCount;
+        if (static_cast<double>(255 * pixelCount) * invCount >= (1 << 24))
+            productsFitInFloat = false;
+    }
+
+    // Lines of a horizontal pass are a row apart, and gathering them costs
+    // more than the vector arithmetic saves.
+    if (strideLine == 4 && productsFitInFloat)
+        shadowBlurColumnsSSE2(pixels, lineCount, lineLength, stride, lobes);
+    else
+        portablePixelKernels().shadowBlur(pixels, lineCount, lineLength, stride, strideLine, lobes);
+}
+
+static inline __m128i clampTo255(__m128i values)
+{
+    const __m128i maximum = _mm_set1_epi32(255);
+    __m128i tooLarge = _mm_cmpgt_epi32(values, maximum);
+    return _mm_or_si128(_mm_and_si128(tooLarge, maximum), _mm_andnot_si128(tooLarge, values));
+}
+
+static void premultipliedARGBToUnmultipliedRGBASSE2(const unsigned* source, unsigned char* destination, unsigned pixelCount)
+{
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    // 255 with the same enlargement as boxBlurReciprocal, so that truncating
+    // color * 255 / alpha gives the integer quotient.
+    const __m128 scaledMaximum = _mm_set1_ps(static_cast<float>(255 * (1 + 1.0 / (1 << 20))));
+    const __m128 one = _mm_set1_ps(1);
+
+    unsigned i = 0;
+    for (; i + 4 <= pixelCount; i += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        __m128i alpha = _mm_srli_epi32(pixels, 24);
+        __m128 alphaFloat = _mm_cvtepi32_ps(alpha);
+        // Pixels without alpha keep their color channels as they are.
+        __m128 transparent = _mm_cmpeq_ps(alphaFloat, _mm_setzero_ps());
+        __m128 scale = _mm_div_ps(scaledMaximum, alphaFloat);
+        scale = _mm_or_ps(_mm_and_ps(transparent, one), _mm_andnot_ps(transparent, scale));
+
+        __m128i red = _mm_and_si128(_mm_srli_epi32(pixels, 16), byteMask);
+        __m128i green = _mm_and_si128(_mm_srli_epi32(pixels, 8), byteMask);
+        __m128i blue = _mm_and_si128(pixels, byteMask);
+        red = clampTo255(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(red), scale)));
+        green = clampTo255(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(green), scale)));
+        blue = clampTo255(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(blue), scale)));
+
+        __m128i result = _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 8)), _mm_or_si128(_mm_slli_epi32(blue, 16), _mm_slli_epi32(alpha, 24)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), result);
+    }
+
+    portablePixelKernels().premultipliedARGBToUnmultipliedRGBA(source + i, destination + i * 4, pixelCount - i);
+}
+
+static inline __m128i premultiplyTwoPixels(__m128i pixels)
+{
+    // pixels holds R, G, B and A of two pixels in 16 bit lanes.
+    const __m128i colorMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alphaMultiplier = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i multiplier = _mm_or_si128(_mm_and_si128(alpha, colorMask), alphaMultiplier);
+
+    // (x + 1 + (x >> 8)) >> 8 is x / 255 for every x that can occur here.
+    __m128i product = _mm_add_epi16(_mm_mullo_epi16(pixels, multiplier), _mm_set1_epi16(254));
+    __m128i quotient = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(product, _mm_set1_epi16(1)), _mm_srli_epi16(product, 8)), 8);
+
+    __m128i transparent = _mm_cmpeq_epi16(alpha, _mm_setzero_si128());
+    quotient = _mm_or_si128(_mm_and_si128(transparent, pixels), _mm_andnot_si128(transparent, quotient));
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(quotient, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+static void unmultipliedRGBAToPremultipliedARGBSSE2(const unsigned char* source, unsigned* destination, unsigned pixelCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    unsigned i = 0;
+    for (; i + 4 <= pixelCount; i += 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+        __m128i low = premultiplyTwoPixels(_mm_unpacklo_epi8(pixels, zero));
+        __m128i high = premultiplyTwoPixels(_mm_unpackhi_epi8(pixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(low, high));
+    }
+
+    portablePixelKernels().unmultipliedRGBAToPremultipliedARGB(source + i * 4, destination + i, pixelCount - i);
+}
+
+static inline void swapRedAndBlueSSE2(const void* source, void* destination, unsigned pixelCount)
+{
+    const __m128i alphaAndGreen = _mm_set1_epi32(0xFF00FF00);
+    const __m128i redAndBlue = _mm_set1_epi32(0x00FF00FF);
+
+    const __m128i* sourcePixels = static_cast<const __m128i*>(source);
+    __m128i* destinationPixels = static_cast<__m128i*>(destination);
+    for (unsigned i = 0; i < pixelCount / 4; ++i) {
+        __m128i pixels = _mm_loadu_si128(sourcePixels + i);
+        __m128i swapped = _mm_and_si128(pixels, redAndBlue);
+        swapped = _mm_or_si128(_mm_slli_epi32(swapped, 16), _mm_srli_epi32(swapped, 16));
+        _mm_storeu_si128(destinationPixels + i, _mm_or_si128(_mm_and_si128(pixels, alphaAndGreen), swapped));
+    }
+}
+
+static void premultipliedARGBToPremultipliedRGBASSE2(const unsigned* source, unsigned char* destination, unsigned pixelCount)
+{
+    swapRedAndBlueSSE2(source, destination, pixelCount);
+    unsigned done = pixelCount & ~3;
+    portablePixelKernels().premultipliedARGBToPremultipliedRGBA(source + done, destination + done * 4, pixelCount - done);
+}
+
+static void premultipliedRGBAToPremultipliedARGBSSE2(const unsigned char* source, unsigned* destination, unsigned pixelCount)
+{
+    swapRedAndBlueSSE2(source, destination, pixelCount);
+    unsigned done = pixelCount & ~3;
+    portablePixelKernels().premultipliedRGBAToPremultipliedARGB(source + done * 4, destination + done, pixelCount - done);
+}
+
+const PixelKernels* sse2PixelKernels()
+{
+    static const PixelKernels kernels = {
+        "SSE2",
+        boxBlurSSE2,
+        shadowBlurSSE2,
+        premultipliedARGBToUnmultipliedRGBASSE2,
+        premultipliedARGBToPremultipliedRGBASSE2,
+        unmultipliedRGBAToPremultipliedARGBSSE2,
+        premultipliedRGBAToPremultipliedARGBSSE2
+    };
+    return &kernels;
+}
+
+} // namespace WebCore
+
+#endif // CPU(X86_SSE2)
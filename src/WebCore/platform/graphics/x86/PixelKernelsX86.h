@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PixelKernelsX86_h
+#define PixelKernelsX86_h
+
+#include "PixelKernels.h"
+
+#if CPU(X86_SSE2)
+
+// AVX2 code is compiled into every x86 build and only run after checking the
+// CPU, so the compiler has to accept AVX2 intrinsics without global flags.
+#if COMPILER(GCC) || (COMPILER(MSVC) && _MSC_VER >= 1800)
+#define HAVE_AVX2_INTRINSICS 1
+#endif
+
+namespace WebCore {
+
+void boxBlurSSE2(const unsigned char* source, unsigned char* destination, unsigned kernelSize, int distanceLeft, int distanceRight,
+    int stride, int strideLine, int effectWidth, int effectHeight, bool alphaImage);
+void shadowBlurSSE2(unsigned char* pixels, int lineCount, int lineLength, int stride, int strideLine, const int lobes[3][2]);
+
+// Multiplying by 1 / kernelSize in float and truncating can land just below an
+// integer. Enlarging the reciprocal by 2^-20 gives exactly sum / kernelSize for
+// every sum of up to 255 * kernelSize, which was checked exhaustively for kernel
+// sizes up to 3793. Larger kernels are left to the portable code.
+static const unsigned boxBlurMaximumSIMDKernelSize = 2048;
+
+inline float boxBlurReciprocal(unsigned kernelSize)
+{
+    return static_cast<float>((1 + 1.0 / (1 << 20)) / kernelSize);
+}
+
+} // namespace WebCore
+
+#endif // CPU(X86_SSE2)
+
+#endif // PixelKernelsX86_h
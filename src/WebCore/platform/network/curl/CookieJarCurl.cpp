@@ -29,6 +29,7 @@
 #include "DocumentLoader.h"
 #include "MainResourceLoader.h"
 #include "ResourceHandleInternal.h"
+#include "ResourceHandleManager.h"
 CookieJar cookieJar;
 //wke++++++
 
@@ -65,6 +66,15 @@ CURL* curlHandle(const Document* document)
 void setCookies(Document* document, const KURL& url, const String& value)
 {
     //wke++++++
+    ResourceHandleManager* manager = ResourceHandleManager::sharedInstance();
+    if (manager->usesNetworkThread()) {
+        // Easy handles belong to the network thread, so the shared curl
+        // cookie store is updated there and the local jar is parsed here.
+        manager->setCookie(url, value);
+        cookieJar.set(0, url, value);
+        return;
+    }
+
     CURL* handle = curlHandle(document);
     cookieJar.set(handle, url, value);
     //wke++++++
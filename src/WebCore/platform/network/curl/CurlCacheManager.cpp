@@ -0,0 +1,795 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CurlCacheManager.h"
+
+#include "HTTPParsers.h"
+#include "KURL.h"
+#include "ResourceHandle.h"
+#include "ResourceHandleClient.h"
+#include "ResourceHandleInternal.h"
+#include "ResourceResponse.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/HashSet.h>
+#include <wtf/MD5.h>
+#include <wtf/MathExtras.h>
+#include <wtf/OwnPtr.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/text/CString.h>
+
+#if OS(WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace WebCore {
+
+static const uint32_t indexMagic = 0x43454b57; // "WKEC"
+static const uint32_t indexVersion = 1;
+static const char indexFileName[] = "index.dat";
+static const char temporaryIndexFileName[] = "index.dat.tmp";
+static const char bodyFileExtension[] = ".body";
+static const long long defaultStorageSizeLimit = 64 * 1024 * 1024;
+static const double saveIndexDelay = 1;
+static const size_t bodyChunkSize = 64 * 1024;
+
+// Responses that only carry Last-Modified stay fresh for a tenth of their
+// age, as suggested by RFC 2616 section 13.2.4.
+static const double heuristicFreshnessFactor = 0.1;
+
+// A read only view of a whole file, used both for the index and for bodies so
+// that they are paged in by the OS instead of being copied through a buffer.
+class MappedCacheFile {
+    WTF_MAKE_NONCOPYABLE(MappedCacheFile);
+public:
+    explicit MappedCacheFile(const String& path);
+    ~MappedCacheFile();
+
+    bool isValid() const { return m_isValid; }
+    const char* data() const { return static_cast<const char*>(m_data); }
+    size_t size() const { return m_size; }
+
+private:
+    bool m_isValid;
+    void* m_data;
+    size_t m_size;
+#if OS(WINDOWS)
+    HANDLE m_file;
+    HANDLE m_mapping;
+#endif
+};
+
+#if OS(WINDOWS)
+MappedCacheFile::MappedCacheFile(const String& path)
+    : m_isValid(false)
+    , m_data(0)
+    , m_size(0)
+    , m_mapping(0)
+{
+    String fileName = path;
+    m_file = CreateFile((LPCTSTR)fileName.charactersWithNullTermination(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (m_file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.HighPart)
+        return;
+
+    m_size = fileSize.LowPart;
+    if (!m_size) {
+        // Empty files cannot be mapped.
+        m_isValid = true;
+        return;
+    }
+
+    m_mapping = CreateFileMapping(m_file, 0, PAGE_READONLY, 0, 0, 0);
+    if (!m_mapping)
+        return;
+
+    m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    m_isValid = !!m_data;
+}
+
+MappedCacheFile::~MappedCacheFile()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+}
+#else
+MappedCacheFile::MappedCacheFile(const String& path)
+    : m_isValid(false)
+    , m_data(0)
+    , m_size(0)
+{
+    CString fileName = fileSystemRepresentation(path);
+    if (fileName.isNull())
+        return;
+
+    int fd = open(fileName.data(), O_RDONLY);
+    if (fd == -1)
+        return;
+
+    struct stat fileStat;
+    if (!fstat(fd, &fileStat)) {
+        m_size = fileStat.st_size;
+        if (!m_size)
+            m_isValid = true;
+        else {
+            void* data = mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_data = data;
+                m_isValid = true;
+            }
+        }
+    }
+    close(fd);
+}
+
+MappedCacheFile::~MappedCacheFile()
+{
+    if (m_data)
+        munmap(m_data, m_size);
+}
+#endif
+
+// Moves source over destination in a single step, so that readers see either
+// the old or the new file but never a partially written one.
+static bool replaceFile(const String& source, const String& destination)
+{
+#if OS(WINDOWS)
+    String sourcePath = source;
+    String destinationPath = destination;
+    return MoveFileEx((LPCTSTR)sourcePath.charactersWithNullTermination(), (LPCTSTR)destinationPath.charactersWithNullTermination(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    CString sourcePath = fileSystemRepresentation(source);
+    CString destinationPath = fileSystemRepresentation(destination);
+    if (sourcePath.isNull() || destinationPath.isNull())
+        return false;
+    return !rename(sourcePath.data(), destinationPath.data());
+#endif
+}
+
+struct CurlCacheManager::Job {
+    explicit Job(const String& key)
+        : key(key)
+        , file(invalidPlatformFileHandle)
+        , entry(0)
+    {
+    }
+
+    String key;
+
+    // A copy of the entry whose validators were sent, and its body. They are
+    // held until the response arrives so that a 304 can be answered even if
+    // the entry is evicted or replaced in the meantime.
+    OwnPtr<CurlCacheEntry> revalidatedEntry;
+    OwnPtr<MappedCacheFile> revalidatedBody;
+
+    // Set when a 304 answer has been replaced by the stored response.
+    OwnPtr<MappedCacheFile> storedBody;
+
+    // A response being written to the cache. It only becomes visible in the
+    // index once the transfer has finished successfully.
+    PlatformFileHandle file;
+    CurlCacheEntry* entry;
+};
+
+static void appendBytes(Vector<char>& buffer, const void* data, size_t size)
+{
+    buffer.append(static_cast<const char*>(data), size);
+}
+
+static void appendString(Vector<char>& buffer, const String& string)
+{
+    CString utf8 = string.utf8();
+    uint32_t length = utf8.length();
+    appendBytes(buffer, &length, sizeof(length));
+    appendBytes(buffer, utf8.data(), length);
+}
+
+class IndexReader {
+public:
+    IndexReader(const char* data, size_t size)
+        : m_position(data)
+        , m_end(data + size)
+    {
+    }
+
+    bool read(void* value, size_t size)
+    {
+        if (static_cast<size_t>(m_end - m_position) < size)
+            return false;
+        memcpy(value, m_position, size);
+        m_position += size;
+        return true;
+    }
+
+    bool readString(String& string)
+    {
+        uint32_t length;
+        if (!read(&length, sizeof(length)) || static_cast<size_t>(m_end - m_position) < length)
+            return false;
+        string = String::fromUTF8(m_position, length);
+        m_position += length;
+        return true;
+    }
+
+    bool atEnd() const { return m_position == m_end; }
+
+private:
+    const char* m_position;
+    const char* m_end;
+};
+
+static String cacheKey(const KURL& url)
+{
+    KURL key = url;
+    key.removeFragmentIdentifier();
+    return key.string();
+}
+
+static double computeExpiration(const ResourceResponse& response, double responseTime)
+{
+    if (response.cacheControlContainsNoCache())
+        return responseTime;
+
+    double age = response.age();
+    if (!isfinite(age))
+        age = 0;
+
+    double maxAge = response.cacheControlMaxAge();
+    if (isfinite(maxAge))
+        return responseTime + maxAge - age;
+
+    double date = response.date();
+    if (!isfinite(date))
+        date = responseTime;
+
+    double expires = response.expires();
+    if (isfinite(expires))
+        return responseTime + std::max(0.0, expires - date) - age;
+
+    double lastModified = response.lastModified();
+    if (isfinite(lastModified))
+        return responseTime + std::max(0.0, date - lastModified) * heuristicFreshnessFactor - age;
+
+    return responseTime;
+}
+
+static bool isStorable(const ResourceResponse& response, double expiration)
+{
+    if (response.cacheControlContainsNoStore())
+        return false;
+
+    // curl decodes the body, so varying on the encoding does not matter.
+    String vary = response.httpHeaderField("Vary").stripWhiteSpace();
+    if (!vary.isEmpty() && !equalIgnoringCase(vary, "Accept-Encoding"))
+        return false;
+
+    return response.hasCacheValidatorFields() || expiration > currentTime();
+}
+
+static bool requestForbidsStoredResponse(const ResourceRequest& request)
+{
+    String cacheControl = request.httpHeaderField("Cache-Control").lower();
+    if (cacheControl.contains("no-cache") || cacheControl.contains("max-age=0"))
+        return true;
+    return request.httpHeaderField("Pragma").lower().contains("no-cache");
+}
+
+static void fillResponse(ResourceResponse& response, const CurlCacheEntry* entry)
+{
+    response = ResourceResponse();
+    response.setURL(KURL(ParsedURLString, entry->url));
+    response.setHTTPStatusCode(entry->httpCode);
+
+    HTTPHeaderMap::const_iterator end = entry->headers.end();
+    for (HTTPHeaderMap::const_iterator it = entry->headers.begin(); it != end; ++it)
+        response.setHTTPHeaderField(it->first, it->second);
+
+    response.setExpectedContentLength(entry->bodySize);
+    response.setMimeType(extractMIMETypeFromMediaType(response.httpHeaderField("Content-Type")));
+    response.setTextEncodingName(extractCharsetFromMediaType(response.httpHeaderField("Content-Type")));
+    response.setSuggestedFilename(filenameFromHTTPContentDisposition(response.httpHeaderField("Content-Disposition")));
+}
+
+CurlCacheManager* CurlCacheManager::sharedInstance()
+{
+    static CurlCacheManager* sharedInstance = 0;
+    if (!sharedInstance)
+        sharedInstance = new CurlCacheManager();
+    return sharedInstance;
+}
+
+CurlCacheManager::CurlCacheManager()
+    : m_storageSizeLimit(defaultStorageSizeLimit)
+    , m_usedSize(0)
+    , m_indexIsDirty(false)
+    , m_saveIndexTimer(this, &CurlCacheManager::saveIndexTimerFired)
+{
+}
+
+CurlCacheManager::~CurlCacheManager()
+{
+    saveIndex();
+    clear();
+    deleteAllValues(m_jobs);
+}
+
+void CurlCacheManager::setCacheDirectory(const String& directory)
+{
+    if (directory == m_cacheDirectory)
+        return;
+
+    // Bodies being written belong to the old directory.
+    HashMap<ResourceHandle*, Job*>::iterator end = m_jobs.end();
+    for (HashMap<ResourceHandle*, Job*>::iterator it = m_jobs.begin(); it != end; ++it)
+        abortWrite(it->second);
+
+    saveIndex();
+    clear();
+
+    m_cacheDirectory = directory;
+    if (m_cacheDirectory.isEmpty())
+        return;
+
+    makeAllDirectories(m_cacheDirectory);
+    loadIndex();
+    evictEntries();
+}
+
+void CurlCacheManager::setStorageSizeLimit(long long limit)
+{
+    m_storageSizeLimit = limit;
+    evictEntries();
+}
+
+bool CurlCacheManager::canUseCache(ResourceHandle* job) const
+{
+    if (!isEnabled())
+        return false;
+
+    const ResourceRequest& request = job->firstRequest();
+    if (request.httpMethod() != "GET" || request.httpBody() || !request.url().protocolInHTTPFamily())
+        return false;
+
+    if (request.cachePolicy() == ReloadIgnoringCacheData)
+        return false;
+
+    // Conditional and partial requests made by the page are left alone.
+    return request.httpHeaderField("If-None-Match").isEmpty()
+        && request.httpHeaderField("If-Modified-Since").isEmpty()
+        && request.httpHeaderField("Range").isEmpty();
+}
+
+bool CurlCacheManager::loadFreshResponse(ResourceHandle* job)
+{
+    if (!canUseCache(job))
+        return false;
+
+    const ResourceRequest& request = job->firstRequest();
+    String key = cacheKey(request.url());
+    CurlCacheEntry* entry = lookup(key);
+    if (!entry)
+        return false;
+
+    bool allowsStaleData = request.cachePolicy() == ReturnCacheDataElseLoad || request.cachePolicy() == ReturnCacheDataDontLoad;
+    if (!allowsStaleData && (currentTime() >= entry->expiration || requestForbidsStoredResponse(request)))
+        return false;
+
+    MappedCacheFile body(bodyPath(key));
+    if (!body.isValid() || static_cast<long long>(body.size()) != entry->bodySize) {
+        removeEntry(key);
+        return false;
+    }
+
+    m_lruList.remove(key);
+    m_lruList.add(key);
+    scheduleSaveIndex();
+
+    ResourceHandleInternal* d = job->getInternal();
+    fillResponse(d->m_response, entry);
+    if (d->client())
+        d->client()->didReceiveResponse(job, d->m_response);
+    d->m_response.setResponseFired(true);
+
+    for (size_t offset = 0; offset < body.size() && !d->m_cancelled; offset += bodyChunkSize) {
+        if (d->client())
+            d->client()->didReceiveData(job, body.data() + offset, std::min(bodyChunkSize, body.size() - offset), 0);
+    }
+
+    if (!d->m_cancelled && d->client())
+        d->client()->didFinishLoading(job, 0);
+    return true;
+}
+
+void CurlCacheManager::willStartJob(ResourceHandle* job)
+{
+    if (!canUseCache(job) || m_jobs.contains(job))
+        return;
+
+    Job* cacheJob = new Job(cacheKey(job->firstRequest().url()));
+    m_jobs.set(job, cacheJob);
+
+    CurlCacheEntry* entry = lookup(cacheJob->key);
+    if (!entry)
+        return;
+
+    String etag = entry->headers.get("ETag");
+    String lastModified = entry->headers.get("Last-Modified");
+    if (etag.isEmpty() && lastModified.isEmpty())
+        return;
+
+    OwnPtr<MappedCacheFile> body = adoptPtr(new MappedCacheFile(bodyPath(cacheJob->key)));
+    if (!body->isValid() || static_cast<long long>(body->size()) != entry->bodySize) {
+        removeEntry(cacheJob->key);
+        return;
+    }
+
+    ResourceHandleInternal* d = job->getInternal();
+    if (!etag.isEmpty())
+        d->m_customHeaders = curl_slist_append(d->m_customHeaders, String("If-None-Match: " + etag).latin1().data());
+    if (!lastModified.isEmpty())
+        d->m_customHeaders = curl_slist_append(d->m_customHeaders, String("If-Modified-Since: " + lastModified).latin1().data());
+    curl_easy_setopt(d->m_handle, CURLOPT_HTTPHEADER, d->m_customHeaders);
+    cacheJob->revalidatedEntry = adoptPtr(new CurlCacheEntry(*entry));
+    cacheJob->revalidatedBody = body.release();
+}
+
+bool CurlCacheManager::didReceiveResponse(ResourceHandle* job, ResourceResponse& response)
+{
+    Job* cacheJob = m_jobs.get(job);
+    if (!cacheJob)
+        return true;
+
+    OwnPtr<CurlCacheEntry> revalidatedEntry = cacheJob->revalidatedEntry.release();
+    OwnPtr<MappedCacheFile> revalidatedBody = cacheJob->revalidatedBody.release();
+
+    const String& key = cacheJob->key;
+    int httpCode = response.httpStatusCode();
+    if (response.url().string() != key) {
+        // curl sends our validators along when it follows a redirect, but
+        // they say nothing about the resource at the new location.
+        return httpCode != 304 || !revalidatedEntry;
+    }
+
+    double now = currentTime();
+
+    if (httpCode == 304 && revalidatedEntry) {
+        // The 304 carries updated caching headers for the stored response.
+        HTTPHeaderMap::const_iterator end = response.httpHeaderFields().end();
+        for (HTTPHeaderMap::const_iterator it = response.httpHeaderFields().begin(); it != end; ++it) {
+            if (!equalIgnoringCase(it->first, "Content-Length"))
+                revalidatedEntry->headers.set(it->first, it->second);
+        }
+        revalidatedEntry->expiration = computeExpiration(response, now);
+        fillResponse(response, revalidatedEntry.get());
+
+        // Only refresh the index if it still holds the entry that was revalidated.
+        if (CurlCacheEntry* entry = lookup(key)) {
+            if (entry->bodySize == revalidatedEntry->bodySize && entry->headers.get("ETag") == revalidatedEntry->headers.get("ETag")) {
+                entry->headers = revalidatedEntry->headers;
+                entry->expiration = revalidatedEntry->expiration;
+                m_lruList.remove(key);
+                m_lruList.add(key);
+                scheduleSaveIndex();
+            }
+        }
+
+        cacheJob->storedBody = revalidatedBody.release();
+        return true;
+    }
+
+    if (httpCode != 200)
+        return true;
+
+    // Whatever is stored is outdated now. The old body has to be closed
+    // before its file can be replaced.
+    revalidatedBody.clear();
+    removeEntry(key);
+
+    double expiration = computeExpiration(response, now);
+    if (!isStorable(response, expiration) || response.expectedContentLength() > m_storageSizeLimit)
+        return true;
+
+    HashMap<ResourceHandle*, Job*>::iterator end = m_jobs.end();
+    for (HashMap<ResourceHandle*, Job*>::iterator it = m_jobs.begin(); it != end; ++it) {
+        if (it->second->entry && it->second->key == key)
+            return true;
+    }
+
+    cacheJob->file = openFile(bodyPath(key), OpenForWrite);
+    if (!isHandleValid(cacheJob->file))
+        return true;
+
+    CurlCacheEntry* entry = new CurlCacheEntry;
+    entry->url = key;
+    entry->httpCode = httpCode;
+    entry->expiration = expiration;
+    entry->headers = response.httpHeaderFields();
+    // The stored body is already decoded.
+    entry->headers.remove("Content-Encoding");
+    entry->headers.remove("Content-Length");
+    entry->headers.remove("Transfer-Encoding");
+    cacheJob->entry = entry;
+    return true;
+}
+
+void CurlCacheManager::didReceiveData(ResourceHandle* job, const char* data, size_t size)
+{
+    Job* cacheJob = m_jobs.get(job);
+    if (!cacheJob || !cacheJob->entry)
+        return;
+
+    if (cacheJob->entry->bodySize + static_cast<long long>(size) > m_storageSizeLimit
+        || writeToFile(cacheJob->file, data, size) != static_cast<int>(size)) {
+        abortWrite(cacheJob);
+        return;
+    }
+    cacheJob->entry->bodySize += size;
+}
+
+bool CurlCacheManager::didFinishLoading(ResourceHandle* job)
+{
+    Job* cacheJob = m_jobs.get(job);
+    if (!cacheJob)
+        return true;
+
+    if (MappedCacheFile* body = cacheJob->storedBody.get()) {
+        ResourceHandleInternal* d = job->getInternal();
+        for (size_t offset = 0; offset < body->size(); offset += bodyChunkSize) {
+            if (d->client())
+                d->client()->didReceiveData(job, body->data() + offset, std::min(bodyChunkSize, body->size() - offset), 0);
+            if (d->m_cancelled)
+                return false;
+        }
+        cacheJob->storedBody.clear();
+        return true;
+    }
+
+    if (CurlCacheEntry* entry = cacheJob->entry) {
+        closeFile(cacheJob->file);
+        cacheJob->entry = 0;
+        addEntry(entry);
+        evictEntries();
+    }
+    return true;
+}
+
+void CurlCacheManager::didRemoveJob(ResourceHandle* job)
+{
+    Job* cacheJob = m_jobs.take(job);
+    if (!cacheJob)
+        return;
+
+    abortWrite(cacheJob);
+    delete cacheJob;
+}
+
+void CurlCacheManager::abortWrite(Job* cacheJob)
+{
+    if (!cacheJob->entry)
+        return;
+
+    closeFile(cacheJob->file);
+    deleteFile(bodyPath(cacheJob->key));
+    delete cacheJob->entry;
+    cacheJob->entry = 0;
+}
+
+String CurlCacheManager::bodyPath(const String& url) const
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    CString utf8 = url.utf8();
+    MD5 md5;
+    md5.addBytes(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length());
+    Vector<uint8_t, 16> digest;
+    md5.checksum(digest);
+
+    Vector<UChar, 32> name;
+    for (size_t i = 0; i < digest.size(); ++i) {
+        name.append(hexDigits[digest[i] >> 4]);
+        name.append(hexDigits[digest[i] & 0xf]);
+    }
+    return pathByAppendingComponent(m_cacheDirectory, String(name.data(), name.size()) + bodyFileExtension);
+}
+
+CurlCacheEntry* CurlCacheManager::lookup(const String& url)
+{
+    return m_entries.get(url);
+}
+
+void CurlCacheManager::addEntry(CurlCacheEntry* entry)
+{
+    ASSERT(!m_entries.contains(entry->url));
+    m_entries.set(entry->url, entry);
+    m_lruList.add(entry->url);
+    m_usedSize += entry->bodySize;
+    scheduleSaveIndex();
+}
+
+void CurlCacheManager::removeEntry(const String& url)
+{
+    CurlCacheEntry* entry = m_entries.take(url);
+    if (!entry)
+        return;
+
+    m_lruList.remove(url);
+    m_usedSize -= entry->bodySize;
+    deleteFile(bodyPath(url));
+    delete entry;
+    scheduleSaveIndex();
+}
+
+void CurlCacheManager::evictEntries()
+{
+    while (m_usedSize > m_storageSizeLimit && !m_lruList.isEmpty()) {
+        String url = m_lruList.first();
+        removeEntry(url);
+    }
+}
+
+void CurlCacheManager::clear()
+{
+    deleteAllValues(m_entries);
+    m_entries.clear();
+    m_lruList.clear();
+    m_usedSize = 0;
+    m_indexIsDirty = false;
+    m_saveIndexTimer.stop();
+}
+
+void CurlCacheManager::loadIndex()
+{
+    HashSet<String> bodyFiles;
+
+    MappedCacheFile index(pathByAppendingComponent(m_cacheDirectory, indexFileName));
+    if (index.isValid() && index.data()) {
+        IndexReader reader(index.data(), index.size());
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint32_t count = 0;
+        if (reader.read(&magic, sizeof(magic)) && magic == indexMagic
+            && reader.read(&version, sizeof(version)) && version == indexVersion
+            && reader.read(&count, sizeof(count))) {
+            for (uint32_t i = 0; i < count; ++i) {
+                OwnPtr<CurlCacheEntry> entry = adoptPtr(new CurlCacheEntry);
+                int32_t httpCode;
+                uint32_t headerCount;
+                if (!reader.readString(entry->url)
+                    || !reader.read(&httpCode, sizeof(httpCode))
+                    || !reader.read(&entry->expiration, sizeof(entry->expiration))
+                    || !reader.read(&entry->bodySize, sizeof(entry->bodySize))
+                    || !reader.read(&headerCount, sizeof(headerCount)))
+                    break;
+                entry->httpCode = httpCode;
+
+                bool headersAreValid = true;
+                for (uint32_t j = 0; j < headerCount && headersAreValid; ++j) {
+                    String name;
+                    String value;
+                    headersAreValid = reader.readString(name) && reader.readString(value);
+                    if (headersAreValid)
+                        entry->headers.set(name, value);
+                }
+                if (!headersAreValid)
+                    break;
+
+                if (m_entries.contains(entry->url))
+                    continue;
+
+                long long bodySize;
+                String path = bodyPath(entry->url);
+                if (!getFileSize(path, bodySize) || bodySize != entry->bodySize)
+                    continue;
+
+                bodyFiles.add(pathGetFileName(path));
+                addEntry(entry.leakPtr());
+            }
+        }
+    }
+
+    // Drop bodies the index does not know about, such as those of transfers
+    // that were interrupted by a crash.
+    Vector<String> files = listDirectory(m_cacheDirectory, String("*") + bodyFileExtension);
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!bodyFiles.contains(pathGetFileName(files[i])))
+            deleteFile(files[i]);
+    }
+
+    m_indexIsDirty = false;
+    m_saveIndexTimer.stop();
+}
+
+void CurlCacheManager::saveIndex()
+{
+    m_saveIndexTimer.stop();
+    if (!m_indexIsDirty || m_cacheDirectory.isEmpty())
+        return;
+
+    Vector<char> buffer;
+    uint32_t count = m_entries.size();
+    appendBytes(buffer, &indexMagic, sizeof(indexMagic));
+    appendBytes(buffer, &indexVersion, sizeof(indexVersion));
+    appendBytes(buffer, &count, sizeof(count));
+
+    ListHashSet<String>::const_iterator end = m_lruList.end();
+    for (ListHashSet<String>::const_iterator it = m_lruList.begin(); it != end; ++it) {
+        const CurlCacheEntry* entry = m_entries.get(*it);
+        int32_t httpCode = entry->httpCode;
+        uint32_t headerCount = entry->headers.size();
+
+        appendString(buffer, entry->url);
+        appendBytes(buffer, &httpCode, sizeof(httpCode));
+        appendBytes(buffer, &entry->expiration, sizeof(entry->expiration));
+        appendBytes(buffer, &entry->bodySize, sizeof(entry->bodySize));
+        appendBytes(buffer, &headerCount, sizeof(headerCount));
+
+        HTTPHeaderMap::const_iterator headersEnd = entry->headers.end();
+        for (HTTPHeaderMap::const_iterator header = entry->headers.begin(); header != headersEnd; ++header) {
+            appendString(buffer, header->first);
+            appendString(buffer, header->second);
+        }
+    }
+
+    // The index is written next to the old one and then swapped in, so a
+    // crash while saving leaves the previous index intact.
+    String temporaryPath = pathByAppendingComponent(m_cacheDirectory, temporaryIndexFileName);
+    PlatformFileHandle file = openFile(temporaryPath, OpenForWrite);
+    if (!isHandleValid(file))
+        return;
+
+    bool written = writeToFile(file, buffer.data(), buffer.size()) == static_cast<int>(buffer.size());
+    closeFile(file);
+    if (written && replaceFile(temporaryPath, pathByAppendingComponent(m_cacheDirectory, indexFileName)))
+        m_indexIsDirty = false;
+    else
+        deleteFile(temporaryPath);
+}
+
+void CurlCacheManager::scheduleSaveIndex()
+{
+    m_indexIsDirty = true;
+    if (!m_saveIndexTimer.isActive())
+        m_saveIndexTimer.startOneShot(saveIndexDelay);
+}
+
+void CurlCacheManager::saveIndexTimerFired(Timer<CurlCacheManager>*)
+{
+    saveIndex();
+}
+
+} // namespace WebCore
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CurlCacheManager_h
+#define CurlCacheManager_h
+
+#include "FileSystem.h"
+#include "HTTPHeaderMap.h"
+#include "PlatformString.h"
+#include "Timer.h"
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/text/StringHash.h>
+
+namespace WebCore {
+
+class ResourceHandle;
+class ResourceResponse;
+
+struct CurlCacheEntry {
+    CurlCacheEntry()
+        : httpCode(0)
+        , expiration(0)
+        , bodySize(0)
+    {
+    }
+
+    String url;
+    int httpCode;
+    // Seconds since the epoch after which the entry has to be revalidated.
+    double expiration;
+    long long bodySize;
+    HTTPHeaderMap headers;
+};
+
+// A persistent HTTP cache for the curl backend. Entries are listed in a
+// compact binary index in the cache directory, in least recently used order,
+// and each body lives in its own file that is memory mapped when served.
+//
+// Fresh entries are answered without touching the network. Stale entries with
+// an ETag or Last-Modified validator are revalidated with a conditional request,
+// and a 304 answer is turned back into the stored response.
+//
+// Everything here runs on the main thread.
+class CurlCacheManager {
+    WTF_MAKE_NONCOPYABLE(CurlCacheManager);
+public:
+    static CurlCacheManager* sharedInstance();
+
+    void setCacheDirectory(const String&);
+    const String& cacheDirectory() const { return m_cacheDirectory; }
+
+    void setStorageSizeLimit(long long);
+    long long storageSizeLimit() const { return m_storageSizeLimit; }
+
+    bool isEnabled() const { return !m_cacheDirectory.isEmpty() && m_storageSizeLimit > 0; }
+
+    // Answers the job from the cache if a fresh entry exists. Returns false if
+    // the job still has to go to the network.
+    bool loadFreshResponse(ResourceHandle*);
+
+    // Registers a job whose curl handle has been initialized and adds the
+    // validators of a stale entry to its request headers.
+    void willStartJob(ResourceHandle*);
+
+    // Called once the headers of the final response are known. A 304 answer
+    // to a conditional request is replaced by the stored response. Returns
+    // false if the response is a 304 that the cache cannot answer, in which
+    // case the job has to fail instead of passing it on.
+    bool didReceiveResponse(ResourceHandle*, ResourceResponse&);
+    void didReceiveData(ResourceHandle*, const char*, size_t);
+
+    // Called right before the client is told that the job finished. Returns
+    // false if the job got cancelled while the stored body was delivered.
+    bool didFinishLoading(ResourceHandle*);
+    void didRemoveJob(ResourceHandle*);
+
+    void saveIndex();
+
+private:
+    struct Job;
+
+    CurlCacheManager();
+    ~CurlCacheManager();
+
+    void loadIndex();
+    void clear();
+    void saveIndexTimerFired(Timer<CurlCacheManager>*);
+    void scheduleSaveIndex();
+
+    bool canUseCache(ResourceHandle*) const;
+    String bodyPath(const String& url) const;
+    CurlCacheEntry* lookup(const String& url);
+    void addEntry(CurlCacheEntry*);
+    void removeEntry(const String& url);
+    void evictEntries();
+    bool deliverBody(ResourceHandle*, CurlCacheEntry*);
+    void abortWrite(Job*);
+
+    String m_cacheDirectory;
+    long long m_storageSizeLimit;
+    long long m_usedSize;
+    bool m_indexIsDirty;
+    Timer<CurlCacheManager> m_saveIndexTimer;
+
+    HashMap<String, CurlCacheEntry*> m_entries;
+    ListHashSet<String> m_lruList;
+    HashMap<ResourceHandle*, Job*> m_jobs;
+};
+
+} // namespace WebCore
+
+#endif // CurlCacheManager_h
@@ -0,0 +1,600 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CurlNetworkThread.h"
+
+#include "FormDataStreamCurl.h"
+#include "KURL.h"
+#include "PlatformString.h"
+#include <errno.h>
+#include <stdio.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MathExtras.h>
+#include <wtf/OwnPtr.h>
+
+#if OS(LINUX)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+//wke++++++
+#include "wkeCookieJar.h"
+//wke++++++
+
+namespace WebCore {
+
+#if OS(LINUX)
+const int maxEventsPerWait = 64;
+#else
+const int maxPollTimeoutMS = 60 * 1000;
+#endif
+
+// Idle keep-alive connections kept open across all hosts.
+const long maxCachedConnections = 64;
+
+struct CurlNetworkThread::Transfer {
+    Transfer(CurlNetworkThread* thread, CURL* handle, ResourceHandle* job, PassOwnPtr<FormDataStream> uploadStream)
+        : thread(thread)
+        , handle(handle)
+        , job(job)
+        , uploadStream(uploadStream)
+        , receivedHeaders(false)
+    {
+    }
+
+    CurlNetworkThread* thread;
+    CURL* handle;
+    ResourceHandle* job;
+    OwnPtr<FormDataStream> uploadStream;
+    bool receivedHeaders;
+};
+
+void collectCurlTransferInfo(CURL* handle, CurlTransferInfo& info)
+{
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &info.httpCode);
+    curl_easy_getinfo(handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &info.contentLength);
+
+    const char* url = 0;
+    if (curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &url) == CURLE_OK && url)
+        info.effectiveURL = url;
+
+    //wke++++++
+    for (void* cookie = curl_first_cookie(handle); cookie; cookie = curl_next_cookie(cookie)) {
+        CurlCookieData data;
+        data.name = curl_cookie_name(cookie);
+        data.value = curl_cookie_value(cookie);
+        data.domain = curl_cookie_domain(cookie);
+        data.path = curl_cookie_path(cookie);
+        info.cookies.append(data);
+    }
+    //wke++++++
+}
+
+void configureCurlMultiHandle(CURLM* multiHandle)
+{
+#if LIBCURL_VERSION_NUM >= 0x071003
+    curl_multi_setopt(multiHandle, CURLMOPT_MAXCONNECTS, maxCachedConnections);
+#endif
+#ifdef CURLPIPE_MULTIPLEX
+    // HTTP/1.1 pipelining is gone from libcurl; HTTP/2 servers get all
+    // requests multiplexed over one connection instead.
+    curl_multi_setopt(multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+}
+
+static bool isHeaderTerminator(const char* ptr, size_t size)
+{
+    return (size == 2 && ptr[0] == '\r' && ptr[1] == '\n') || (size == 1 && ptr[0] == '\n');
+}
+
+CurlNetworkThread::CurlNetworkThread(CURLSH* shareHandle, WTF::MainThreadFunction* eventsAvailable, void* context)
+    : m_multiHandle(0)
+    , m_shareHandle(shareHandle)
+    , m_cookieHandle(0)
+    , m_threadID(0)
+    , m_quit(false)
+    , m_eventsAvailable(eventsAvailable)
+    , m_context(context)
+#if OS(LINUX)
+    , m_epollFD(-1)
+    , m_wakeupFD(-1)
+    , m_timerDeadline(0)
+#endif
+{
+}
+
+CurlNetworkThread::~CurlNetworkThread()
+{
+    stop();
+}
+
+void CurlNetworkThread::start()
+{
+    ASSERT(isMainThread());
+    if (m_threadID)
+        return;
+
+    m_multiHandle = curl_multi_init();
+    configureCurlMultiHandle(m_multiHandle);
+    // Handles that are never performed; cookies set from script are pushed
+    // into the shared jar through it so that the network thread stays the
+    // only user of curl's cookie list.
+    m_cookieHandle = curl_easy_init();
+    curl_easy_setopt(m_cookieHandle, CURLOPT_SHARE, m_shareHandle);
+
+#if OS(LINUX)
+    curl_multi_setopt(m_multiHandle, CURLMOPT_SOCKETFUNCTION, socketCallback);
+    curl_multi_setopt(m_multiHandle, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(m_multiHandle, CURLMOPT_TIMERFUNCTION, timerCallback);
+    curl_multi_setopt(m_multiHandle, CURLMOPT_TIMERDATA, this);
+#endif
+
+    if (!initializeWakeup())
+        return;
+
+    m_quit = false;
+    m_threadID = createThread(threadEntryPoint, this, "WebCore: Network");
+}
+
+void CurlNetworkThread::stop()
+{
+    if (m_threadID) {
+        m_quit = true;
+        wakeUp();
+        void* result;
+        waitForThreadCompletion(m_threadID, &result);
+        m_threadID = 0;
+    }
+
+    HashMap<CURL*, Transfer*>::iterator end = m_transfers.end();
+    for (HashMap<CURL*, Transfer*>::iterator it = m_transfers.begin(); it != end; ++it)
+        curl_multi_remove_handle(m_multiHandle, it->first);
+    deleteAllValues(m_transfers);
+    m_transfers.clear();
+
+    for (size_t i = 0; i < m_commands.size(); ++i)
+        delete m_commands[i].transfer;
+    m_commands.clear();
+
+#if OS(LINUX)
+    if (m_epollFD != -1)
+        close(m_epollFD);
+    if (m_wakeupFD != -1)
+        close(m_wakeupFD);
+    m_epollFD = -1;
+    m_wakeupFD = -1;
+#endif
+
+    if (m_cookieHandle)
+        curl_easy_cleanup(m_cookieHandle);
+    m_cookieHandle = 0;
+    if (m_multiHandle)
+        curl_multi_cleanup(m_multiHandle);
+    m_multiHandle = 0;
+}
+
+void CurlNetworkThread::addHandle(CURL* handle, ResourceHandle* job, PassOwnPtr<FormDataStream> uploadStream)
+{
+    ASSERT(isMainThread());
+    Transfer* transfer = new Transfer(this, handle, job, uploadStream);
+
+    // The handle is not shared yet, so it is safe to retarget its callbacks
+    // from here. From now on they run on the network thread.
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, transfer);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, headerCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEHEADER, transfer);
+    if (transfer->uploadStream) {
+        curl_easy_setopt(handle, CURLOPT_READFUNCTION, readCallback);
+        curl_easy_setopt(handle, CURLOPT_READDATA, transfer);
+    }
+    // The error buffer of the manager is shared by every handle; the network
+    // thread reports errors through CURLcode instead.
+    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, 0);
+
+    Command command(Command::Add, handle);
+    command.transfer = transfer;
+    postCommand(command);
+}
+
+void CurlNetworkThread::removeHandle(CURL* handle)
+{
+    postCommand(Command(Command::Remove, handle));
+}
+
+void CurlNetworkThread::pauseHandle(CURL* handle, bool pause)
+{
+    postCommand(Command(pause ? Command::Pause : Command::Resume, handle));
+}
+
+void CurlNetworkThread::addCookie(const CString& value, const CString& domain, const CString& path)
+{
+    Command command(Command::AddCookie, 0);
+    command.cookie.value = value;
+    command.cookie.domain = domain;
+    command.cookie.path = path;
+    postCommand(command);
+}
+
+void CurlNetworkThread::takeEvents(Vector<CurlNetworkEvent>& events)
+{
+    MutexLocker locker(m_eventMutex);
+    if (events.isEmpty())
+        events.swap(m_events);
+    else {
+        events.append(m_events);
+        m_events.clear();
+    }
+}
+
+void CurlNetworkThread::postCommand(const Command& command)
+{
+    {
+        MutexLocker locker(m_commandMutex);
+        m_commands.append(command);
+    }
+    wakeUp();
+}
+
+void* CurlNetworkThread::threadEntryPoint(void* context)
+{
+    static_cast<CurlNetworkThread*>(context)->runLoop();
+    return 0;
+}
+
+void CurlNetworkThread::runLoop()
+{
+    while (!m_quit) {
+        processCommands();
+        // Removing a transfer releases it right away; report that before
+        // going back to sleep, which might not end until the next command.
+        flushEvents();
+        waitForActivity();
+        processCompletedTransfers();
+        flushEvents();
+    }
+}
+
+void CurlNetworkThread::processCommands()
+{
+    Vector<Command> commands;
+    {
+        MutexLocker locker(m_commandMutex);
+        commands.swap(m_commands);
+    }
+
+    for (size_t i = 0; i < commands.size(); ++i) {
+        Command& command = commands[i];
+        switch (command.type) {
+        case Command::Add: {
+            m_transfers.set(command.handle, command.transfer);
+            CURLMcode ret = curl_multi_add_handle(m_multiHandle, command.handle);
+            if (ret != CURLM_OK && ret != CURLM_CALL_MULTI_PERFORM)
+                finishTransfer(command.handle, CURLE_FAILED_INIT);
+            break;
+        }
+        case Command::Remove:
+            releaseTransfer(command.handle);
+            break;
+        case Command::Pause:
+        case Command::Resume:
+            if (m_transfers.contains(command.handle))
+                curl_easy_pause(command.handle, command.type == Command::Pause ? CURLPAUSE_ALL : CURLPAUSE_CONT);
+            break;
+        case Command::AddCookie:
+            //wke++++++
+            curl_cookie_add(m_cookieHandle, command.cookie.value.data(), true, true, command.cookie.domain.data(), command.cookie.path.data(), true);
+            //wke++++++
+            break;
+        }
+    }
+}
+
+void CurlNetworkThread::finishTransfer(CURL* handle, CURLcode result)
+{
+    HashMap<CURL*, Transfer*>::iterator it = m_transfers.find(handle);
+    if (it == m_transfers.end())
+        return;
+
+    CurlNetworkEvent event(CurlNetworkEvent::Finished, it->second->job);
+    event.result = result;
+    const char* url = 0;
+    if (curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &url) == CURLE_OK && url)
+        event.info.effectiveURL = url;
+    queueEvent(event);
+
+    releaseTransfer(handle);
+}
+
+void CurlNetworkThread::releaseTransfer(CURL* handle)
+{
+    HashMap<CURL*, Transfer*>::iterator it = m_transfers.find(handle);
+    if (it == m_transfers.end())
+        return;
+
+    Transfer* transfer = it->second;
+    m_transfers.remove(it);
+    curl_multi_remove_handle(m_multiHandle, handle);
+
+    queueEvent(CurlNetworkEvent(CurlNetworkEvent::Released, transfer->job));
+    delete transfer;
+}
+
+void CurlNetworkThread::processCompletedTransfers()
+{
+    while (true) {
+        int messagesInQueue;
+        CURLMsg* msg = curl_multi_info_read(m_multiHandle, &messagesInQueue);
+        if (!msg)
+            break;
+
+        if (CURLMSG_DONE != msg->msg)
+            continue;
+
+        finishTransfer(msg->easy_handle, msg->data.result);
+    }
+}
+
+void CurlNetworkThread::queueEvent(const CurlNetworkEvent& event)
+{
+    m_pendingEvents.append(event);
+}
+
+void CurlNetworkThread::queueData(Transfer* transfer, const char* data, size_t size, long httpCode)
+{
+    // Chunks that arrive for the same transfer within one wake-up are handed
+    // to the loader as a single didReceiveData.
+    if (!m_pendingEvents.isEmpty()) {
+        CurlNetworkEvent& last = m_pendingEvents.last();
+        if (last.type == CurlNetworkEvent::Data && last.job == transfer->job) {
+            last.data.append(data, size);
+            return;
+        }
+    }
+
+    CurlNetworkEvent event(CurlNetworkEvent::Data, transfer->job);
+    event.info.httpCode = httpCode;
+    // Local files never run the header callback; the main thread needs the
+    // URL to synthesize their response.
+    if (!transfer->receivedHeaders) {
+        const char* url = 0;
+        if (curl_easy_getinfo(transfer->handle, CURLINFO_EFFECTIVE_URL, &url) == CURLE_OK && url)
+            event.info.effectiveURL = url;
+    }
+    m_pendingEvents.append(event);
+    m_pendingEvents.last().data.append(data, size);
+}
+
+void CurlNetworkThread::flushEvents()
+{
+    if (m_pendingEvents.isEmpty())
+        return;
+
+    bool needsDispatch;
+    {
+        MutexLocker locker(m_eventMutex);
+        needsDispatch = m_events.isEmpty();
+        if (needsDispatch)
+            m_events.swap(m_pendingEvents);
+        else
+            m_events.append(m_pendingEvents);
+    }
+    m_pendingEvents.clear();
+
+    if (needsDispatch)
+        callOnMainThread(m_eventsAvailable, m_context);
+}
+
+size_t CurlNetworkThread::writeCallback(void* ptr, size_t size, size_t nmemb, void* data)
+{
+    Transfer* transfer = static_cast<Transfer*>(data);
+    size_t totalSize = size * nmemb;
+
+    // curl hands us the body of redirects it follows internally; the main
+    // thread never wants to see those.
+    long httpCode = 0;
+    CURLcode err = curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &httpCode);
+    if (CURLE_OK == err && httpCode >= 300 && httpCode < 400)
+        return totalSize;
+
+    transfer->thread->queueData(transfer, static_cast<const char*>(ptr), totalSize, httpCode);
+    return totalSize;
+}
+
+// Cancelling has to go through the main thread, so a failed read aborts the
+// transfer and the job learns about it from the Finished event.
+size_t CurlNetworkThread::readCallback(void* ptr, size_t size, size_t nmemb, void* data)
+{
+    Transfer* transfer = static_cast<Transfer*>(data);
+
+    if (!size || !nmemb || !transfer->uploadStream->hasMoreElements())
+        return 0;
+
+    size_t sent = transfer->uploadStream->read(ptr, size, nmemb);
+    if (!sent)
+        return CURL_READFUNC_ABORT;
+
+    return sent;
+}
+
+size_t CurlNetworkThread::headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
+{
+    Transfer* transfer = static_cast<Transfer*>(data);
+    size_t totalSize = size * nmemb;
+
+    CurlNetworkEvent event(CurlNetworkEvent::HeaderLine, transfer->job);
+    event.data.append(ptr, totalSize);
+    if (isHeaderTerminator(ptr, totalSize)) {
+        transfer->receivedHeaders = true;
+        collectCurlTransferInfo(transfer->handle, event.info);
+    }
+    transfer->thread->queueEvent(event);
+    return totalSize;
+}
+
+#if OS(LINUX)
+
+bool CurlNetworkThread::initializeWakeup()
+{
+    m_epollFD = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeupFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFD == -1 || m_wakeupFD == -1)
+        return false;
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeupFD;
+    return !epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_wakeupFD, &event);
+}
+
+void CurlNetworkThread::wakeUp()
+{
+    uint64_t value = 1;
+    ssize_t result = write(m_wakeupFD, &value, sizeof(value));
+    UNUSED_PARAM(result);
+}
+
+void CurlNetworkThread::waitForActivity()
+{
+    int timeout = -1;
+    if (m_timerDeadline) {
+        double remaining = m_timerDeadline - monotonicallyIncreasingTime();
+        timeout = remaining > 0 ? static_cast<int>(ceil(remaining * 1000)) : 0;
+    }
+
+    struct epoll_event events[maxEventsPerWait];
+    int count = epoll_wait(m_epollFD, events, maxEventsPerWait, timeout);
+    if (count == -1) {
+#ifndef NDEBUG
+        if (errno != EINTR)
+            perror("bad: epoll_wait() returned -1: ");
+#endif
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == m_wakeupFD) {
+            uint64_t value;
+            while (read(m_wakeupFD, &value, sizeof(value)) > 0) { }
+            continue;
+        }
+
+        int action = 0;
+        if (events[i].events & EPOLLIN)
+            action |= CURL_CSELECT_IN;
+        if (events[i].events & EPOLLOUT)
+            action |= CURL_CSELECT_OUT;
+        if (events[i].events & (EPOLLERR | EPOLLHUP))
+            action |= CURL_CSELECT_ERR;
+        socketAction(fd, action);
+    }
+
+    if (m_timerDeadline && m_timerDeadline <= monotonicallyIncreasingTime()) {
+        m_timerDeadline = 0;
+        socketAction(CURL_SOCKET_TIMEOUT, 0);
+    }
+}
+
+void CurlNetworkThread::socketAction(curl_socket_t socket, int action)
+{
+    int runningHandles = 0;
+    curl_multi_socket_action(m_multiHandle, socket, action, &runningHandles);
+}
+
+int CurlNetworkThread::socketCallback(CURL*, curl_socket_t socket, int what, void* userp, void* socketp)
+{
+    CurlNetworkThread* thread = static_cast<CurlNetworkThread*>(userp);
+
+    if (what == CURL_POLL_REMOVE) {
+        // curl may already have closed the socket, in which case the kernel
+        // dropped it from the epoll set on its own.
+        epoll_ctl(thread->m_epollFD, EPOLL_CTL_DEL, socket, 0);
+        curl_multi_assign(thread->m_multiHandle, socket, 0);
+        return 0;
+    }
+
+    struct epoll_event event;
+    event.events = 0;
+    if (what & CURL_POLL_IN)
+        event.events |= EPOLLIN;
+    if (what & CURL_POLL_OUT)
+        event.events |= EPOLLOUT;
+    event.data.fd = socket;
+
+    if (socketp)
+        epoll_ctl(thread->m_epollFD, EPOLL_CTL_MOD, socket, &event);
+    else {
+        epoll_ctl(thread->m_epollFD, EPOLL_CTL_ADD, socket, &event);
+        // Any non-null pointer marks the socket as registered.
+        curl_multi_assign(thread->m_multiHandle, socket, thread);
+    }
+    return 0;
+}
+
+int CurlNetworkThread::timerCallback(CURLM*, long timeoutMS, void* userp)
+{
+    CurlNetworkThread* thread = static_cast<CurlNetworkThread*>(userp);
+    if (timeoutMS < 0)
+        thread->m_timerDeadline = 0;
+    else
+        thread->m_timerDeadline = monotonicallyIncreasingTime() + timeoutMS / 1000.0;
+    return 0;
+}
+
+#else
+
+bool CurlNetworkThread::initializeWakeup()
+{
+    return true;
+}
+
+void CurlNetworkThread::wakeUp()
+{
+    if (m_multiHandle)
+        curl_multi_wakeup(m_multiHandle);
+}
+
+void CurlNetworkThread::waitForActivity()
+{
+    // curl_multi_poll caps the timeout to curl's own next timer, so this only
+    // blocks for the full duration when nothing is happening at all.
+    CURLMcode ret = curl_multi_poll(m_multiHandle, 0, 0, maxPollTimeoutMS, 0);
+    if (ret != CURLM_OK) {
+#ifndef NDEBUG
+        fprintf(stderr, "bad: curl_multi_poll() returned %d\n", ret);
+#endif
+        return;
+    }
+
+    int runningHandles = 0;
+    curl_multi_perform(m_multiHandle, &runningHandles);
+}
+
+#endif
+
+} // namespace WebCore
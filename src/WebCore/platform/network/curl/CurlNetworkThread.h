@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CurlNetworkThread_h
+#define CurlNetworkThread_h
+
+#if PLATFORM(WIN)
+#include <winsock2.h>
+#include <windows.h>
+#endif
+
+#include <curl/curl.h>
+#include <wtf/HashMap.h>
+#include <wtf/MainThread.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PassOwnPtr.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace WebCore {
+
+class FormDataStream;
+class ResourceHandle;
+
+struct CurlCookieData {
+    CString name;
+    CString value;
+    CString domain;
+    CString path;
+};
+
+// What the header callback needs to know about a transfer once its headers
+// are complete. Collected on whichever thread drives the easy handle.
+struct CurlTransferInfo {
+    CurlTransferInfo()
+        : httpCode(0)
+        , contentLength(0)
+    {
+    }
+
+    long httpCode;
+    double contentLength;
+    CString effectiveURL;
+    Vector<CurlCookieData> cookies;
+};
+
+void collectCurlTransferInfo(CURL*, CurlTransferInfo&);
+
+// Connection reuse settings shared by every multi handle that runs jobs.
+void configureCurlMultiHandle(CURLM*);
+
+// A notification produced on the network thread and handed to the main
+// thread in batches. Only plain bytes cross the thread boundary; every
+// WebCore object is built from them on the main thread.
+struct CurlNetworkEvent {
+    enum Type {
+        HeaderLine,
+        Data,
+        Finished,
+        Released
+    };
+
+    CurlNetworkEvent(Type type, ResourceHandle* job)
+        : type(type)
+        , job(job)
+        , result(CURLE_OK)
+    {
+    }
+
+    Type type;
+    ResourceHandle* job;
+    Vector<char> data;
+    CurlTransferInfo info;
+    CURLcode result;
+};
+
+// Drives a curl multi handle from a dedicated thread that only wakes up
+// when a socket becomes ready, when a curl timer expires or when the main
+// thread posts a command. On Linux readiness comes from epoll through
+// curl_multi_socket_action; elsewhere curl_multi_poll is used, which is
+// equally event driven and can be woken from another thread.
+//
+// Every transfer added to the thread produces exactly one Released event,
+// after which the main thread owns the easy handle again and may clean it up.
+class CurlNetworkThread {
+    WTF_MAKE_NONCOPYABLE(CurlNetworkThread);
+public:
+    CurlNetworkThread(CURLSH*, WTF::MainThreadFunction* eventsAvailable, void* context);
+    ~CurlNetworkThread();
+
+    void start();
+    void stop();
+
+    // These are called on the main thread.
+    // The upload stream, if any, is owned and read by the network thread.
+    void addHandle(CURL*, ResourceHandle*, PassOwnPtr<FormDataStream> uploadStream);
+    void removeHandle(CURL*);
+    void pauseHandle(CURL*, bool pause);
+    void addCookie(const CString& value, const CString& domain, const CString& path);
+    void takeEvents(Vector<CurlNetworkEvent>&);
+
+private:
+    struct Transfer;
+
+    struct Command {
+        enum Type {
+            Add,
+            Remove,
+            Pause,
+            Resume,
+            AddCookie
+        };
+
+        Command(Type type, CURL* handle)
+            : type(type)
+            , handle(handle)
+            , transfer(0)
+        {
+        }
+
+        Type type;
+        CURL* handle;
+        Transfer* transfer;
+        CurlCookieData cookie;
+    };
+
+    static void* threadEntryPoint(void*);
+    void runLoop();
+
+    void postCommand(const Command&);
+    void processCommands();
+    void finishTransfer(CURL*, CURLcode);
+    void releaseTransfer(CURL*);
+    void processCompletedTransfers();
+    void queueEvent(const CurlNetworkEvent&);
+    void queueData(Transfer*, const char*, size_t, long httpCode);
+    void flushEvents();
+
+    bool initializeWakeup();
+    void wakeUp();
+    void waitForActivity();
+
+    static size_t writeCallback(void*, size_t, size_t, void*);
+    static size_t headerCallback(char*, size_t, size_t, void*);
+    static size_t readCallback(void*, size_t, size_t, void*);
+#if OS(LINUX)
+    static int socketCallback(CURL*, curl_socket_t, int, void*, void*);
+    static int timerCallback(CURLM*, long, void*);
+    void socketAction(curl_socket_t, int);
+#endif
+
+    CURLM* m_multiHandle;
+    CURLSH* m_shareHandle;
+    CURL* m_cookieHandle;
+    ThreadIdentifier m_threadID;
+    volatile bool m_quit;
+
+    WTF::MainThreadFunction* m_eventsAvailable;
+    void* m_context;
+
+    Mutex m_commandMutex;
+    Vector<Command> m_commands;
+
+    Mutex m_eventMutex;
+    Vector<CurlNetworkEvent> m_events;
+
+    // Only touched on the network thread.
+    HashMap<CURL*, Transfer*> m_transfers;
+    Vector<CurlNetworkEvent> m_pendingEvents;
+
+#if OS(LINUX)
+    int m_epollFD;
+    int m_wakeupFD;
+    double m_timerDeadline;
+#endif
+};
+
+} // namespace WebCore
+
+#endif // CurlNetworkThread_h
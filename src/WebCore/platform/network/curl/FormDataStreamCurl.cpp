@@ -50,8 +50,7 @@ size_t FormDataStream::read(void* ptr, size_t blockSize, size_t numberOfBlocks)
         return 0;
 
     Vector<FormDataElement> elements;
-    if (m_resourceHandle->firstRequest().httpBody())
-        elements = m_resourceHandle->firstRequest().httpBody()->elements();
+    this->elements(elements);
 
     if (m_formDataElementIndex >= elements.size())
         return 0;
@@ -104,10 +103,17 @@ size_t FormDataStream::read(void* ptr, size_t blockSize, size_t numberOfBlocks)
 bool FormDataStream::hasMoreElements() const
 {
     Vector<FormDataElement> elements;
-    if (m_resourceHandle->firstRequest().httpBody())
-        elements = m_resourceHandle->firstRequest().httpBody()->elements();
+    this->elements(elements);
 
     return m_formDataElementIndex < elements.size();
 }
 
+void FormDataStream::elements(Vector<FormDataElement>& elements) const
+{
+    if (m_formData)
+        elements = m_formData->elements();
+    else if (m_resourceHandle->firstRequest().httpBody())
+        elements = m_resourceHandle->firstRequest().httpBody()->elements();
+}
+
 } // namespace WebCore
@@ -28,6 +28,7 @@
 #include "config.h"
 
 #include "FileSystem.h"
+#include "FormData.h"
 #include "ResourceHandle.h"
 #include <stdio.h>
 
@@ -43,16 +44,31 @@ public:
     {
     }
 
+    // Reads from a body that is not shared with anything else, such as a
+    // deep copy handed to the network thread.
+    explicit FormDataStream(PassRefPtr<FormData> formData)
+        : m_resourceHandle(0)
+        , m_formData(formData)
+        , m_file(0)
+        , m_formDataElementIndex(0)
+        , m_formDataElementDataOffset(0)
+    {
+    }
+
     ~FormDataStream();
 
     size_t read(void* ptr, size_t blockSize, size_t numberOfBlocks);
     bool hasMoreElements() const;
 
 private:
+    void elements(Vector<FormDataElement>&) const;
+
     // We can hold a weak reference to our ResourceHandle as it holds a strong reference
     // to us through its ResourceHandleInternal.
     ResourceHandle* m_resourceHandle;
 
+    RefPtr<FormData> m_formData;
+
     FILE* m_file;
     size_t m_formDataElementIndex;
     size_t m_formDataElementDataOffset;
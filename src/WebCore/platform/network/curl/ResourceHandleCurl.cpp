@@ -149,6 +149,12 @@ void ResourceHandle::platformSetDefersLoading(bool defers)
     if (!d->m_handle)
         return;
 
+    ResourceHandleManager* manager = ResourceHandleManager::sharedInstance();
+    if (manager->usesNetworkThread()) {
+        manager->setDefersLoading(this, defers);
+        return;
+    }
+
     if (defers) {
         CURLcode error = curl_easy_pause(d->m_handle, CURLPAUSE_ALL);
         // If we could not defer the handle, so don't do it.
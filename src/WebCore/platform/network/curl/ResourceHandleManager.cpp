@@ -34,6 +34,7 @@
 #include "config.h"
 #include "ResourceHandleManager.h"
 
+#include "CurlCacheManager.h"
 #include "DataURL.h"
 #include "HTTPParsers.h"
 #include "MIMETypeRegistry.h"
@@ -47,6 +48,7 @@
 #if USE(CF)
 #include <wtf/RetainPtr.h>
 #endif
+#include <wtf/OwnPtr.h>
 #include <wtf/Threading.h>
 #include <wtf/Vector.h>
 #include <wtf/text/CString.h>
@@ -65,9 +67,26 @@ namespace WebCore {
 //wke++++++
 const int selectTimeoutMS = 1;
 const double pollTimeSeconds = 0.01;
-const int maxRunningJobs = 5;
 //wke++++++
 
+// Connections opened to a single server. Jobs below medium priority leave
+// some of them to requests that block parsing or rendering.
+const int defaultMaxConnectionsPerHost = 6;
+
+// The global caps leave room for more than one busy server; were they below
+// the per-host limit, that limit and the priorities behind it would never
+// come into play.
+const int defaultMaxRunningJobs = 2 * defaultMaxConnectionsPerHost;
+
+// The network thread keeps socket work off the main thread, which then only
+// pays for batched delivery, so many more transfers can run at once.
+const int defaultMaxRunningNetworkThreadJobs = 16;
+
+// Finished easy handles are reset and kept around: besides saving the
+// allocation, each one keeps its DNS and TLS session caches and, for
+// synchronous jobs, its live connections.
+const size_t maxIdleHandles = 16;
+
 static const bool ignoreSSLErrors = getenv("WEBKIT_IGNORE_SSL_ERRORS");
 
 static CString certificatePath()
@@ -93,6 +112,7 @@ static CString certificatePath()
 static Mutex* sharedResourceMutex(curl_lock_data data) {
     DEFINE_STATIC_LOCAL(Mutex, cookieMutex, ());
     DEFINE_STATIC_LOCAL(Mutex, dnsMutex, ());
+    DEFINE_STATIC_LOCAL(Mutex, sslSessionMutex, ());
     DEFINE_STATIC_LOCAL(Mutex, shareMutex, ());
 
     switch (data) {
@@ -100,6 +120,8 @@ static Mutex* sharedResourceMutex(curl_lock_data data) {
             return &cookieMutex;
         case CURL_LOCK_DATA_DNS:
             return &dnsMutex;
+        case CURL_LOCK_DATA_SSL_SESSION:
+            return &sslSessionMutex;
         case CURL_LOCK_DATA_SHARE:
             return &shareMutex;
         default:
@@ -109,8 +131,8 @@ static Mutex* sharedResourceMutex(curl_lock_data data) {
 }
 
 // libcurl does not implement its own thread synchronization primitives.
-// these two functions provide mutexes for cookies, and for the global DNS
-// cache.
+// these two functions provide mutexes for cookies, the global DNS cache and
+// the TLS sessions that let new connections skip the full handshake.
 static void curl_lock_callback(CURL* handle, curl_lock_data data, curl_lock_access access, void* userPtr)
 {
     if (Mutex* mutex = sharedResourceMutex(data))
@@ -128,19 +150,25 @@ ResourceHandleManager::ResourceHandleManager()
     , m_cookieJarFileName(0)
     , m_certificatePath (certificatePath())
     , m_runningJobs(0)
-
+    , m_maxRunningJobs(defaultMaxRunningJobs)
+    , m_maxConnectionsPerHost(defaultMaxConnectionsPerHost)
 {
     curl_global_init(CURL_GLOBAL_ALL);
     m_curlMultiHandle = curl_multi_init();
+    configureCurlMultiHandle(m_curlMultiHandle);
     m_curlShareHandle = curl_share_init();
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_curlShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_LOCKFUNC, curl_lock_callback);
     curl_share_setopt(m_curlShareHandle, CURLSHOPT_UNLOCKFUNC, curl_unlock_callback);
 }
 
 ResourceHandleManager::~ResourceHandleManager()
 {
+    m_networkThread.clear();
+    for (size_t i = 0; i < m_idleHandles.size(); ++i)
+        curl_easy_cleanup(m_idleHandles[i]);
     curl_multi_cleanup(m_curlMultiHandle);
     curl_share_cleanup(m_curlShareHandle);
     if (m_cookieJarFileName)
@@ -153,6 +181,36 @@ void ResourceHandleManager::setCookieJarFileName(const char* cookieJarFileName)
     m_cookieJarFileName = fastStrDup(cookieJarFileName);
 }
 
+void ResourceHandleManager::setUsesNetworkThread(bool usesNetworkThread)
+{
+    ASSERT(!m_runningJobs);
+    if (usesNetworkThread == !!m_networkThread)
+        return;
+
+    if (usesNetworkThread) {
+        m_networkThread = adoptPtr(new CurlNetworkThread(m_curlShareHandle, networkEventsAvailable, this));
+        m_networkThread->start();
+        if (m_maxRunningJobs == defaultMaxRunningJobs)
+            m_maxRunningJobs = defaultMaxRunningNetworkThreadJobs;
+    } else {
+        m_networkThread.clear();
+        if (m_maxRunningJobs == defaultMaxRunningNetworkThreadJobs)
+            m_maxRunningJobs = defaultMaxRunningJobs;
+    }
+}
+
+void ResourceHandleManager::setMaxRunningJobs(int maxRunningJobs)
+{
+    m_maxRunningJobs = std::max(1, maxRunningJobs);
+    scheduleJobs();
+}
+
+void ResourceHandleManager::setMaxConnectionsPerHost(int maxConnectionsPerHost)
+{
+    m_maxConnectionsPerHost = std::max(1, maxConnectionsPerHost);
+    scheduleJobs();
+}
+
 ResourceHandleManager* ResourceHandleManager::sharedInstance()
 {
     static ResourceHandleManager* sharedInstance = 0;
@@ -161,22 +219,45 @@ ResourceHandleManager* ResourceHandleManager::sharedInstance()
     return sharedInstance;
 }
 
-static void handleLocalReceiveResponse (CURL* handle, ResourceHandle* job, ResourceHandleInternal* d)
+static void handleLocalReceiveResponse(const char* effectiveURL, ResourceHandle* job, ResourceHandleInternal* d)
 {
     // since the code in headerCallback will not have run for local files
     // the code to set the URL and fire didReceiveResponse is never run,
     // which means the ResourceLoader's response does not contain the URL.
     // Run the code here for local files to resolve the issue.
     // TODO: See if there is a better approach for handling this.
-     const char* hdr;
-     CURLcode err = curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &hdr);
-     ASSERT_UNUSED(err, CURLE_OK == err);
-     d->m_response.setURL(KURL(ParsedURLString, hdr));
+     d->m_response.setURL(KURL(ParsedURLString, effectiveURL));
      if (d->client())
          d->client()->didReceiveResponse(job, d->m_response);
      d->m_response.setResponseFired(true);
 }
 
+static void handleLocalReceiveResponse(CURL* handle, ResourceHandle* job, ResourceHandleInternal* d)
+{
+     const char* hdr;
+     CURLcode err = curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &hdr);
+     ASSERT_UNUSED(err, CURLE_OK == err);
+     handleLocalReceiveResponse(hdr, job, d);
+}
+
+// Delivers a chunk of the body to the client. Returns false if the job got
+// cancelled along the way.
+static bool didReceiveBody(ResourceHandle* job, const char* data, size_t size, const char* effectiveURL)
+{
+    ResourceHandleInternal* d = job->getInternal();
+
+    if (!d->m_response.responseFired()) {
+        handleLocalReceiveResponse(effectiveURL, job, d);
+        if (d->m_cancelled)
+            return false;
+    }
+
+    CurlCacheManager::sharedInstance()->didReceiveData(job, data, size);
+    if (d->client())
+        d->client()->didReceiveData(job, data, size, 0);
+    return true;
+}
+
 
 // called with data after all headers have been processed via headerCallback
 static size_t writeCallback(void* ptr, size_t size, size_t nmemb, void* data)
@@ -202,43 +283,34 @@ static size_t writeCallback(void* ptr, size_t size, size_t nmemb, void* data)
     if (CURLE_OK == err && httpCode >= 300 && httpCode < 400)
         return totalSize;
 
-    if (!d->m_response.responseFired()) {
-        handleLocalReceiveResponse(h, job, d);
-        if (d->m_cancelled)
-            return 0;
-    }
+    const char* effectiveURL = 0;
+    if (!d->m_response.responseFired())
+        curl_easy_getinfo(h, CURLINFO_EFFECTIVE_URL, &effectiveURL);
 
-    if (d->client())
-        d->client()->didReceiveData(job, static_cast<char*>(ptr), totalSize, 0);
+    if (!didReceiveBody(job, static_cast<char*>(ptr), totalSize, effectiveURL))
+        return 0;
     return totalSize;
 }
 
-/*
- * This is being called for each HTTP header in the response. This includes '\r\n'
- * for the last line of the header.
- *
- * We will add each HTTP Header to the ResourceResponse and on the termination
- * of the header (\r\n) we will parse Content-Type and Content-Disposition and
- * update the ResourceResponse and then send it away.
- *
- */
-static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
+//wke++++++
+static void storeCookies(const Vector<CurlCookieData>& cookies)
 {
-    ResourceHandle* job = static_cast<ResourceHandle*>(data);
-    ResourceHandleInternal* d = job->getInternal();
-    if (d->m_cancelled)
-        return 0;
-
-#if LIBCURL_VERSION_NUM > 0x071200
-    // We should never be called when deferred loading is activated.
-    ASSERT(!d->m_defersLoading);
-#endif
+    for (size_t i = 0; i < cookies.size(); ++i) {
+        HttpCookie c;
+        c.setName(cookies[i].name.data());
+        c.setValue(cookies[i].value.data());
+        c.setDomain(cookies[i].domain.data());
+        c.setPath(cookies[i].path.data());
+        cookieJar.add(c);
+    }
+}
+//wke++++++
 
-    size_t totalSize = size * nmemb;
+static void didReceiveHeader(ResourceHandle* job, const String& header, const CurlTransferInfo& info)
+{
+    ResourceHandleInternal* d = job->getInternal();
     ResourceHandleClient* client = d->client();
 
-    String header(static_cast<const char*>(ptr), totalSize);
-
     /*
      * a) We can finish and send the ResourceResponse
      * b) We will add the current header to the HTTPHeaderMap of the ResourceResponse
@@ -247,29 +319,18 @@ static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
      * accept also \n.
      */
     if (header == String("\r\n") || header == String("\n")) {
-        CURL* h = d->m_handle;
-        CURLcode err;
-
-        double contentLength = 0;
-        err = curl_easy_getinfo(h, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &contentLength);
-        d->m_response.setExpectedContentLength(static_cast<long long int>(contentLength));
-
-        const char* hdr;
-        err = curl_easy_getinfo(h, CURLINFO_EFFECTIVE_URL, &hdr);
+        d->m_response.setExpectedContentLength(static_cast<long long int>(info.contentLength));
         //wke++++++
-        d->m_response.setURL(KURL(KURL(), hdr));
+        d->m_response.setURL(KURL(KURL(), info.effectiveURL.data()));
         //wke++++++
-
-        long httpCode = 0;
-        err = curl_easy_getinfo(h, CURLINFO_RESPONSE_CODE, &httpCode);
-        d->m_response.setHTTPStatusCode(httpCode);
+        d->m_response.setHTTPStatusCode(info.httpCode);
 
         d->m_response.setMimeType(extractMIMETypeFromMediaType(d->m_response.httpHeaderField("Content-Type")));
         d->m_response.setTextEncodingName(extractCharsetFromMediaType(d->m_response.httpHeaderField("Content-Type")));
         d->m_response.setSuggestedFilename(filenameFromHTTPContentDisposition(d->m_response.httpHeaderField("Content-Disposition")));
 
         // HTTP redirection
-        if (httpCode >= 300 && httpCode < 400) {
+        if (info.httpCode >= 300 && info.httpCode < 400) {
             String location = d->m_response.httpHeaderField("location");
             if (!location.isEmpty()) {
                 KURL newURL = KURL(job->firstRequest().url(), location);
@@ -281,15 +342,24 @@ static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
 
                 d->m_firstRequest.setURL(newURL);
 
-                return totalSize;
+                return;
             }
         }
 
+        if (!CurlCacheManager::sharedInstance()->didReceiveResponse(job, d->m_response)) {
+            // A 304 means nothing to the client, which never asked for it.
+            String url = d->m_response.url().string();
+            job->cancel();
+            if (client)
+                client->didFail(job, ResourceError(String(), CURLE_HTTP_RETURNED_ERROR, url, String(curl_easy_strerror(CURLE_HTTP_RETURNED_ERROR))));
+            return;
+        }
+
         if (client)
             client->didReceiveResponse(job, d->m_response);
         d->m_response.setResponseFired(true);
         //wke++++++
-        cookieJar.set(d->m_handle);
+        storeCookies(info.cookies);
         //wke++++++
 
     } else {
@@ -297,7 +367,38 @@ static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
         if (splitPos != -1)
             d->m_response.setHTTPHeaderField(header.left(splitPos), header.substring(splitPos+1).stripWhiteSpace());
     }
+}
 
+/*
+ * This is being called for each HTTP header in the response. This includes '\r\n'
+ * for the last line of the header.
+ *
+ * We will add each HTTP Header to the ResourceResponse and on the termination
+ * of the header (\r\n) we will parse Content-Type and Content-Disposition and
+ * update the ResourceResponse and then send it away.
+ *
+ */
+static size_t headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
+{
+    ResourceHandle* job = static_cast<ResourceHandle*>(data);
+    ResourceHandleInternal* d = job->getInternal();
+    if (d->m_cancelled)
+        return 0;
+
+#if LIBCURL_VERSION_NUM > 0x071200
+    // We should never be called when deferred loading is activated.
+    ASSERT(!d->m_defersLoading);
+#endif
+
+    size_t totalSize = size * nmemb;
+
+    String header(static_cast<const char*>(ptr), totalSize);
+
+    CurlTransferInfo info;
+    if (header == String("\r\n") || header == String("\n"))
+        collectCurlTransferInfo(d->m_handle, info);
+
+    didReceiveHeader(job, header, info);
     return totalSize;
 }
 
@@ -333,10 +434,38 @@ size_t readCallback(void* ptr, size_t size, size_t nmemb, void* data)
     return sent;
 }
 
+static void didFinishTransfer(ResourceHandle* job, CURLcode result, const char* url)
+{
+    ResourceHandleInternal* d = job->getInternal();
+
+    if (CURLE_OK == result) {
+        if (!d->m_response.responseFired()) {
+            handleLocalReceiveResponse(url, job, d);
+            if (d->m_cancelled)
+                return;
+        }
+
+        if (!CurlCacheManager::sharedInstance()->didFinishLoading(job))
+            return;
+
+        if (d->client())
+            d->client()->didFinishLoading(job, 0);
+    } else {
+#ifndef NDEBUG
+        fprintf(stderr, "Curl ERROR for url='%s', error: '%s'\n", url, curl_easy_strerror(result));
+#endif
+        if (d->client())
+            d->client()->didFail(job, ResourceError(String(), result, String(url), String(curl_easy_strerror(result))));
+    }
+}
+
 void ResourceHandleManager::downloadTimerCallback(Timer<ResourceHandleManager>* timer)
 {
     startScheduledJobs();
 
+    if (m_networkThread)
+        return;
+
     fd_set fdread;
     fd_set fdwrite;
     fd_set fdexcep;
@@ -398,26 +527,9 @@ void ResourceHandleManager::downloadTimerCallback(Timer<ResourceHandleManager>*
         if (CURLMSG_DONE != msg->msg)
             continue;
 
-        if (CURLE_OK == msg->data.result) {
-            if (!d->m_response.responseFired()) {
-                handleLocalReceiveResponse(d->m_handle, job, d);
-                if (d->m_cancelled) {
-                    removeFromCurl(job);
-                    continue;
-                }
-            }
-
-            if (d->client())
-                d->client()->didFinishLoading(job, 0);
-        } else {
-            char* url = 0;
-            curl_easy_getinfo(d->m_handle, CURLINFO_EFFECTIVE_URL, &url);
-#ifndef NDEBUG
-            fprintf(stderr, "Curl ERROR for url='%s', error: '%s'\n", url, curl_easy_strerror(msg->data.result));
-#endif
-            if (d->client())
-                d->client()->didFail(job, ResourceError(String(), msg->data.result, String(url), String(curl_easy_strerror(msg->data.result))));
-        }
+        char* url = 0;
+        curl_easy_getinfo(d->m_handle, CURLINFO_EFFECTIVE_URL, &url);
+        didFinishTransfer(job, msg->data.result, url);
 
         removeFromCurl(job);
     }
@@ -428,6 +540,81 @@ void ResourceHandleManager::downloadTimerCallback(Timer<ResourceHandleManager>*
         m_downloadTimer.startOneShot(pollTimeSeconds);
 }
 
+void ResourceHandleManager::networkEventsAvailable(void* context)
+{
+    static_cast<ResourceHandleManager*>(context)->dispatchNetworkEvents();
+}
+
+void ResourceHandleManager::dispatchNetworkEvents()
+{
+    if (!m_networkThread)
+        return;
+
+    // Events held back for deferred jobs go first so each job still sees its
+    // events in order.
+    Vector<CurlNetworkEvent> events;
+    events.swap(m_deferredNetworkEvents);
+    m_networkThread->takeEvents(events);
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        CurlNetworkEvent& event = events[i];
+        ResourceHandle* job = event.job;
+        ResourceHandleInternal* d = job->getInternal();
+
+        if (d->m_defersLoading && !d->m_cancelled) {
+            m_deferredNetworkEvents.append(event);
+            continue;
+        }
+
+        if (event.type == CurlNetworkEvent::Released) {
+            releaseNetworkJob(job);
+            continue;
+        }
+
+        if (d->m_cancelled)
+            continue;
+
+        switch (event.type) {
+        case CurlNetworkEvent::HeaderLine:
+            didReceiveHeader(job, String(event.data.data(), event.data.size()), event.info);
+            break;
+        case CurlNetworkEvent::Data:
+            didReceiveBody(job, event.data.data(), event.data.size(), event.info.effectiveURL.data());
+            break;
+        case CurlNetworkEvent::Finished:
+            didFinishTransfer(job, event.result, event.info.effectiveURL.data());
+            break;
+        case CurlNetworkEvent::Released:
+            ASSERT_NOT_REACHED();
+            break;
+        }
+    }
+
+    startScheduledJobs();
+}
+
+void ResourceHandleManager::releaseNetworkJob(ResourceHandle* job)
+{
+    ASSERT(job->getInternal()->m_handle);
+    finishRunningJob(job);
+}
+
+void ResourceHandleManager::setDefersLoading(ResourceHandle* job, bool defers)
+{
+    ResourceHandleInternal* d = job->getInternal();
+    ASSERT(m_networkThread && d->m_handle);
+
+    m_networkThread->pauseHandle(d->m_handle, defers);
+    if (!defers && !m_deferredNetworkEvents.isEmpty())
+        callOnMainThread(networkEventsAvailable, this);
+}
+
+void ResourceHandleManager::setCookie(const KURL& url, const String& value)
+{
+    ASSERT(m_networkThread);
+    m_networkThread->addCookie(value.utf8(), url.host().utf8(), url.path().utf8());
+}
+
 void ResourceHandleManager::setProxyInfo(const String& host,
                                          unsigned long port,
                                          ProxyType type,
@@ -453,13 +640,51 @@ void ResourceHandleManager::removeFromCurl(ResourceHandle* job)
     ASSERT(d->m_handle);
     if (!d->m_handle)
         return;
-    m_runningJobs--;
     curl_multi_remove_handle(m_curlMultiHandle, d->m_handle);
-    curl_easy_cleanup(d->m_handle);
+    finishRunningJob(job);
+}
+
+void ResourceHandleManager::finishRunningJob(ResourceHandle* job)
+{
+    ResourceHandleInternal* d = job->getInternal();
+    m_runningJobs--;
+
+    HashMap<ResourceHandle*, String>::iterator it = m_runningJobHosts.find(job);
+    if (it != m_runningJobHosts.end()) {
+        HashMap<String, int>::iterator host = m_runningJobsPerHost.find(it->second);
+        if (!--host->second)
+            m_runningJobsPerHost.remove(host);
+        m_runningJobHosts.remove(it);
+    }
+
+    CurlCacheManager::sharedInstance()->didRemoveJob(job);
+    recycleHandle(d->m_handle);
     d->m_handle = 0;
     job->deref();
 }
 
+CURL* ResourceHandleManager::acquireHandle()
+{
+    if (m_idleHandles.isEmpty())
+        return curl_easy_init();
+
+    CURL* handle = m_idleHandles.last();
+    m_idleHandles.removeLast();
+    return handle;
+}
+
+void ResourceHandleManager::recycleHandle(CURL* handle)
+{
+    if (m_idleHandles.size() >= maxIdleHandles) {
+        curl_easy_cleanup(handle);
+        return;
+    }
+
+    // Resetting drops every option but keeps the caches worth reusing.
+    curl_easy_reset(handle);
+    m_idleHandles.append(handle);
+}
+
 void ResourceHandleManager::setupPUT(ResourceHandle*, struct curl_slist**)
 {
     notImplemented();
@@ -552,8 +777,17 @@ void ResourceHandleManager::add(ResourceHandle* job)
     // schedule this job to be added the next time we enter curl download loop
     job->ref();
     m_resourceHandleList.append(job);
-    if (!m_downloadTimer.isActive())
-        m_downloadTimer.startOneShot(pollTimeSeconds);
+    scheduleJobs();
+}
+
+void ResourceHandleManager::scheduleJobs()
+{
+    if (m_downloadTimer.isActive())
+        return;
+
+    // With the network thread the timer only starts jobs, which still has to
+    // happen asynchronously since data URLs call back into the client.
+    m_downloadTimer.startOneShot(m_networkThread ? 0 : pollTimeSeconds);
 }
 
 bool ResourceHandleManager::removeScheduledJob(ResourceHandle* job)
@@ -569,14 +803,58 @@ bool ResourceHandleManager::removeScheduledJob(ResourceHandle* job)
     return false;
 }
 
-bool ResourceHandleManager::startScheduledJobs()
+static String connectionKey(const KURL& url)
 {
-    // TODO: Create a separate stack of jobs for each domain.
+    if (!url.protocolInHTTPFamily())
+        return String();
+    return url.protocol().lower() + "://" + url.host().lower() + ":" + String::number(url.port());
+}
 
+int ResourceHandleManager::connectionLimit(ResourceLoadPriority priority) const
+{
+    switch (priority) {
+    case ResourceLoadPriorityVeryLow:
+        return 1;
+    case ResourceLoadPriorityLow:
+        return std::max(1, m_maxConnectionsPerHost - 2);
+    default:
+        return m_maxConnectionsPerHost;
+    }
+}
+
+size_t ResourceHandleManager::nextScheduledJob() const
+{
+    size_t next = notFound;
+    ResourceLoadPriority nextPriority = ResourceLoadPriorityUnresolved;
+
+    for (size_t i = 0; i < m_resourceHandleList.size(); ++i) {
+        const ResourceRequest& request = m_resourceHandleList[i]->firstRequest();
+        ResourceLoadPriority priority = request.priority();
+        if (priority <= nextPriority)
+            continue;
+
+        String key = connectionKey(request.url());
+        if (!key.isEmpty() && m_runningJobsPerHost.get(key) >= connectionLimit(priority))
+            continue;
+
+        next = i;
+        nextPriority = priority;
+        if (priority == ResourceLoadPriorityHighest)
+            break;
+    }
+    return next;
+}
+
+bool ResourceHandleManager::startScheduledJobs()
+{
     bool started = false;
-    while (!m_resourceHandleList.isEmpty() && m_runningJobs < maxRunningJobs) {
-        ResourceHandle* job = m_resourceHandleList[0];
-        m_resourceHandleList.remove(0);
+    while (m_runningJobs < m_maxRunningJobs) {
+        size_t next = nextScheduledJob();
+        if (next == notFound)
+            break;
+
+        ResourceHandle* job = m_resourceHandleList[next];
+        m_resourceHandleList.remove(next);
         startJob(job);
         started = true;
     }
@@ -611,7 +889,8 @@ void ResourceHandleManager::dispatchSynchronousJob(ResourceHandle* job)
         handle->client()->didFail(job, error);
     }
 
-    curl_easy_cleanup(handle->m_handle);
+    recycleHandle(handle->m_handle);
+    handle->m_handle = 0;
 }
 
 void ResourceHandleManager::startJob(ResourceHandle* job)
@@ -623,9 +902,31 @@ void ResourceHandleManager::startJob(ResourceHandle* job)
         return;
     }
 
+    if (CurlCacheManager::sharedInstance()->loadFreshResponse(job)) {
+        job->deref();
+        return;
+    }
+
     initializeHandle(job);
+    CurlCacheManager::sharedInstance()->willStartJob(job);
 
     m_runningJobs++;
+    String key = connectionKey(kurl);
+    if (!key.isEmpty()) {
+        m_runningJobHosts.set(job, key);
+        HashMap<String, int>::iterator host = m_runningJobsPerHost.add(key, 0).first;
+        ++host->second;
+    }
+    if (m_networkThread) {
+        // The network thread gets its own copy of the body, so that it never
+        // touches the ResourceHandleInternal.
+        OwnPtr<FormDataStream> uploadStream;
+        if (job->firstRequest().httpBody())
+            uploadStream = adoptPtr(new FormDataStream(job->firstRequest().httpBody()->deepCopy()));
+        m_networkThread->addHandle(job->getInternal()->m_handle, job, uploadStream.release());
+        return;
+    }
+
     CURLMcode ret = curl_multi_add_handle(m_curlMultiHandle, job->getInternal()->m_handle);
     // don't call perform, because events must be async
     // timeout will occur and do curl_multi_perform
@@ -660,7 +961,7 @@ void ResourceHandleManager::initializeHandle(ResourceHandle* job)
         d->m_response.setMimeType(MIMETypeRegistry::getMIMETypeForPath(url));
     }
 
-    d->m_handle = curl_easy_init();
+    d->m_handle = acquireHandle();
 
 #if LIBCURL_VERSION_NUM > 0x071200
     if (d->m_defersLoading) {
@@ -686,6 +987,14 @@ void ResourceHandleManager::initializeHandle(ResourceHandle* job)
     curl_easy_setopt(d->m_handle, CURLOPT_HTTPAUTH, CURLAUTH_ANY);
     curl_easy_setopt(d->m_handle, CURLOPT_SHARE, m_curlShareHandle);
     curl_easy_setopt(d->m_handle, CURLOPT_DNS_CACHE_TIMEOUT, 60 * 5); // 5 minutes
+#if LIBCURL_VERSION_NUM >= 0x071900
+    // Notice dead keep-alive connections before a request is sent on them.
+    curl_easy_setopt(d->m_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+#ifdef CURLPIPE_MULTIPLEX
+    // Prefer waiting for a connection that can multiplex over opening another.
+    curl_easy_setopt(d->m_handle, CURLOPT_PIPEWAIT, 1L);
+#endif
     // FIXME: Enable SSL verification when we have a way of shipping certs
     // and/or reporting SSL errors to the user.
     if (ignoreSSLErrors)
@@ -756,6 +1065,13 @@ void ResourceHandleManager::cancel(ResourceHandle* job)
         return;
 
     ResourceHandleInternal* d = job->getInternal();
+    if (m_networkThread) {
+        if (!d->m_cancelled && d->m_handle)
+            m_networkThread->removeHandle(d->m_handle);
+        d->m_cancelled = true;
+        return;
+    }
+
     d->m_cancelled = true;
     if (!m_downloadTimer.isActive())
         m_downloadTimer.startOneShot(pollTimeSeconds);
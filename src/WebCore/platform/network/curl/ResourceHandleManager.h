@@ -28,8 +28,10 @@
 #ifndef ResourceHandleManager_h
 #define ResourceHandleManager_h
 
+#include "CurlNetworkThread.h"
 #include "Frame.h"
 #include "PlatformString.h"
+#include "ResourceLoadPriority.h"
 #include "Timer.h"
 #include "ResourceHandleClient.h"
 
@@ -39,8 +41,11 @@
 #endif
 
 #include <curl/curl.h>
+#include <wtf/HashMap.h>
+#include <wtf/OwnPtr.h>
 #include <wtf/Vector.h>
 #include <wtf/text/CString.h>
+#include <wtf/text/StringHash.h>
 
 namespace WebCore {
 
@@ -69,6 +74,23 @@ public:
                       const String& username = "",
                       const String& password = "");
 
+    // Moves all transfers to a dedicated network thread that wakes up on
+    // socket readiness instead of polling from a timer on the main thread.
+    // Must be called before the first job is started.
+    void setUsesNetworkThread(bool);
+    bool usesNetworkThread() const { return m_networkThread; }
+
+    void setMaxRunningJobs(int);
+    int maxRunningJobs() const { return m_maxRunningJobs; }
+
+    // Connections opened to one server by high priority jobs; lower
+    // priorities get fewer so that they cannot starve the rest of the page.
+    void setMaxConnectionsPerHost(int);
+    int maxConnectionsPerHost() const { return m_maxConnectionsPerHost; }
+
+    void setDefersLoading(ResourceHandle*, bool);
+    void setCookie(const KURL&, const String& value);
+
 private:
     ResourceHandleManager();
     ~ResourceHandleManager();
@@ -77,10 +99,23 @@ private:
     bool removeScheduledJob(ResourceHandle*);
     void startJob(ResourceHandle*);
     bool startScheduledJobs();
+    size_t nextScheduledJob() const;
+    int connectionLimit(ResourceLoadPriority) const;
+    void scheduleJobs();
+    void finishRunningJob(ResourceHandle*);
+
+    CURL* acquireHandle();
+    void recycleHandle(CURL*);
 
     void initializeHandle(ResourceHandle*);
 
+    static void networkEventsAvailable(void*);
+    void dispatchNetworkEvents();
+    void releaseNetworkJob(ResourceHandle*);
+
     Timer<ResourceHandleManager> m_downloadTimer;
+    OwnPtr<CurlNetworkThread> m_networkThread;
+    Vector<CurlNetworkEvent> m_deferredNetworkEvents;
     CURLM* m_curlMultiHandle;
     CURLSH* m_curlShareHandle;
     char* m_cookieJarFileName;
@@ -88,6 +123,11 @@ private:
     Vector<ResourceHandle*> m_resourceHandleList;
     const CString m_certificatePath;
     int m_runningJobs;
+    int m_maxRunningJobs;
+    int m_maxConnectionsPerHost;
+    HashMap<String, int> m_runningJobsPerHost;
+    HashMap<ResourceHandle*, String> m_runningJobHosts;
+    Vector<CURL*> m_idleHandles;
     
     String m_proxy;
     ProxyType m_proxyType;
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2011 wke contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SharedTimer.h"
+#include "SharedTimerPOSIX.h"
+
+#include <wtf/Assertions.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/MathExtras.h>
+
+namespace WebCore {
+
+static void (*sharedTimerFiredFunction)();
+static bool sharedTimerActive;
+static double sharedTimerFireTime;
+
+void setSharedTimerFiredFunction(void (*f)())
+{
+    sharedTimerFiredFunction = f;
+}
+
+void setSharedTimerFireInterval(double interval)
+{
+    ASSERT(sharedTimerFiredFunction);
+
+    sharedTimerFireTime = monotonicallyIncreasingTime() + interval;
+    sharedTimerActive = true;
+}
+
+void stopSharedTimer()
+{
+    sharedTimerActive = false;
+}
+
+bool fireSharedTimerIfNeeded()
+{
+    if (!sharedTimerActive || !sharedTimerFiredFunction)
+        return false;
+
+    if (monotonicallyIncreasingTime() < sharedTimerFireTime)
+        return false;
+
+    // The callback usually re-arms the timer, so clear it first.
+    sharedTimerActive = false;
+    sharedTimerFiredFunction();
+    return true;
+}
+
+double sharedTimerFireDelay()
+{
+    if (!sharedTimerActive)
+        return -1;
+
+    return std::max(sharedTimerFireTime - monotonicallyIncreasingTime(), 0.0);
+}
+
+} // namespace WebCore
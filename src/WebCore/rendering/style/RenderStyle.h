@@ -266,7 +266,8 @@ protected:
         unsigned char _pseudoBits : 7;
         unsigned char _unicodeBidi : 3; // EUnicodeBidi
         bool _isLink : 1;
-        // 53 bits
+        bool _explicitInheritance : 1; // Explicitly inherits a non-inherited property.
+        // 54 bits
     } noninherited_flags;
 
 // !END SYNC!
@@ -311,6 +312,7 @@ protected:
         noninherited_flags._pseudoBits = 0;
         noninherited_flags._unicodeBidi = initialUnicodeBidi();
         noninherited_flags._isLink = false;
+        noninherited_flags._explicitInheritance = false;
     }
 
 private:
@@ -328,6 +330,7 @@ public:
     ~RenderStyle();
 
     void inheritFrom(const RenderStyle* inheritParent);
+    void copyNonInheritedFrom(const RenderStyle*);
 
     PseudoId styleType() const { return static_cast<PseudoId>(noninherited_flags._styleType); }
     void setStyleType(PseudoId styleType) { noninherited_flags._styleType = styleType; }
@@ -1288,6 +1291,7 @@ public:
     const AtomicString& hyphenString() const;
 
     bool inheritedNotEqual(const RenderStyle*) const;
+    bool inheritedDataShared(const RenderStyle*) const;
 
     StyleDifference diff(const RenderStyle*, unsigned& changedContextSensitiveProperties) const;
 
@@ -1319,6 +1323,11 @@ public:
     bool unique() const { return m_unique; }
     void setUnique() { m_unique = true; }
 
+    // Set when a child gives a non-inherited property the value 'inherit', which
+    // makes the child's non-inherited data depend on this style.
+    bool hasExplicitlyInheritedProperties() const { return noninherited_flags._explicitInheritance; }
+    void setHasExplicitlyInheritedProperties() { noninherited_flags._explicitInheritance = true; }
+
     // Methods for indicating the style is affected by dynamic updates (e.g., children changing, our position changing in our sibling list, etc.)
     bool affectedByEmpty() const { return m_affectedByEmpty; }
     bool emptyState() const { return m_emptyState; }
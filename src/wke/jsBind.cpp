@@ -8,13 +8,16 @@
 #include <JavaScriptCore/JavaScript.h>
 #include <JavaScriptCore/APICast.h>
 #include <JavaScriptCore/Completion.h>
+#include <JavaScriptCore/JSONObject.h>
 #include <JavaScriptCore/OpaqueJSString.h>
+#include <JavaScriptCore/SamplingProfiler.h>
 #include <WebCore/GCController.h>
 #include <WebCore/JSDOMWindowCustom.h>
 #include <WebCore/Page.h>
 #include <WebCore/Frame.h>
 #include <WebCore/Chrome.h>
 #include <WebCore/ChromeClient.h>
+#include <wtf/unicode/UTF8.h>
 
 //cexer: 必须包含在后面，因为其中的 wke.h -> windows.h 会定义 max、min，导致 WebCore 内部的 max、min 出现错乱。
 #include "wkeWebView.h"
@@ -217,6 +220,38 @@ const wchar_t* wkeJSToTempStringW(wkeJSState* es, wkeJSValue v)
     return s_sharedStringBufferW.c_str();
 }
 
+class wkeJSStringifySink : public JSC::JSONStringifySink
+{
+public:
+    wkeJSStringifySink(wkeJSStringifyCallback callback, void* param)
+        : m_callback(callback)
+        , m_param(param)
+    {}
+
+    virtual void append(const UChar* characters, unsigned length)
+    {
+        // A UTF-16 code unit never takes more than 3 bytes in UTF-8.
+        m_buffer.resize(length * 3);
+        const UChar* source = characters;
+        char* target = m_buffer.data();
+        WTF::Unicode::convertUTF16ToUTF8(&source, characters + length, &target, target + m_buffer.size(), false);
+        m_callback(m_param, m_buffer.data(), (int)(target - m_buffer.data()));
+    }
+
+protected:
+    wkeJSStringifyCallback m_callback;
+    void* m_param;
+    Vector<char> m_buffer;
+};
+
+bool wkeJSStringify(wkeJSState* es, wkeJSValue v, int indent, wkeJSStringifyCallback callback, void* param)
+{
+    JSC::JSValue value = JSC::JSValue::decode((JSC::EncodedJSValue)v);
+
+    wkeJSStringifySink sink(callback, param);
+    return JSC::JSONStringify((JSC::ExecState*)es, value, indent > 0 ? indent : 0, sink);
+}
+
 wkeJSValue wkeJSInt(wkeJSState* es, int n)
 {
     return (wkeJSValue)JSC::JSValue::encode(JSC::jsNumber(n));
@@ -446,6 +481,39 @@ void wkeJSCollectGarbge()
     WebCore::gcController().garbageCollectNow();
 }
 
+bool wkeStartJSProfiling(unsigned int intervalMs)
+{
+    JSC::JSGlobalData* globalData = WebCore::JSDOMWindowBase::commonJSGlobalData();
+    if (globalData->samplingProfiler)
+        return false;
+
+    globalData->samplingProfiler = JSC::SamplingProfiler::create(*globalData, intervalMs);
+    globalData->samplingProfiler->start();
+    return true;
+}
+
+bool wkeStopJSProfiling(const utf8* path)
+{
+    JSC::JSGlobalData* globalData = WebCore::JSDOMWindowBase::commonJSGlobalData();
+    OwnPtr<JSC::SamplingProfiler> profiler = globalData->samplingProfiler.release();
+    if (!profiler)
+        return false;
+
+    profiler->stop();
+    if (!path)
+        return true;
+
+    CString stacks = profiler->foldedStacks();
+    String fileName = String::fromUTF8(path);
+    FILE* file = _wfopen((const wchar_t*)fileName.charactersWithNullTermination(), L"wb");
+    if (!file)
+        return false;
+
+    bool written = fwrite(stacks.data(), 1, stacks.length(), file) == stacks.length();
+    fclose(file);
+    return written;
+}
+
 
 void wkeJSAddRef(wkeJSState* es, wkeJSValue val)
 {
@@ -22,7 +22,13 @@ typedef struct
 enum wkeSettingMask 
 {
     WKE_SETTING_PROXY = 1,
-    WKE_SETTING_COOKIE_FILE_PATH = 1<<1
+    WKE_SETTING_COOKIE_FILE_PATH = 1<<1,
+    WKE_SETTING_NETWORK_THREAD = 1<<2,
+    WKE_SETTING_DISK_CACHE = 1<<3,
+    WKE_SETTING_SCRIPT_CACHE = 1<<4,
+    // Views paint into cairo image surfaces instead of GDI DIB sections.
+    // Always on where there is no GDI.
+    WKE_SETTING_HEADLESS = 1<<5
 };
 namespace wke {
     class wkeSettings
@@ -31,12 +37,25 @@ namespace wke {
             wkeSettings(): proxy(nullptr),
                 cookieFilePath(nullptr),
                 mask(0),
-                pageScaleFactor(1.0f) {};
+                pageScaleFactor(1.0f),
+                maxNetworkJobs(0),
+                diskCachePath(nullptr),
+                diskCacheLimit(0),
+                scriptCachePath(nullptr),
+                scriptCacheLimit(0) {};
         public:
             wkeProxy* proxy;
             char* cookieFilePath;
             unsigned int mask;
             float pageScaleFactor;
+            // Used with WKE_SETTING_NETWORK_THREAD; 0 keeps the default.
+            int maxNetworkJobs;
+            // Used with WKE_SETTING_DISK_CACHE; a limit of 0 keeps the default.
+            char* diskCachePath;
+            unsigned int diskCacheLimit;
+            // Used with WKE_SETTING_SCRIPT_CACHE; a limit of 0 keeps the default.
+            char* scriptCachePath;
+            unsigned int scriptCacheLimit;
     };
     class wkeSettingsManeger {
         public:
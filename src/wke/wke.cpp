@@ -9,10 +9,17 @@
 #include <WebCore/IconDatabase.h>
 #include <WebCore/WebCoreInstanceHandle.h>
 #include <WebCore/RenderThemeWin.h>
+#include <WebCore/CurlCacheManager.h>
+#include <WebCore/GCController.h>
 #include <WebCore/ResourceHandleManager.h>
 #include <WebCore/Console.h>
 #include <WebCore/SecurityOrigin.h>
+#include <WebCore/SourceProviderCacheStorage.h>
 #include <WebCore/DatabaseTracker.h>
+#if !OS(WINDOWS)
+#include <WebCore/SharedTimerPOSIX.h>
+#include <unistd.h>
+#endif
 
 #include "wkePlatformStrategies.h"
 #include "icuwin.h"
@@ -85,6 +92,30 @@ void wkeConfigCookieFilePath(const char* path)
     WebCore::ResourceHandleManager::sharedInstance()->setCookieJarFileName(path);
 }
 
+void wkeConfigNetworkThread(int maxNetworkJobs)
+{
+    WebCore::ResourceHandleManager* manager = WebCore::ResourceHandleManager::sharedInstance();
+    manager->setUsesNetworkThread(true);
+    if (maxNetworkJobs > 0)
+        manager->setMaxRunningJobs(maxNetworkJobs);
+}
+
+void wkeConfigDiskCache(const char* path, unsigned int limit)
+{
+    WebCore::CurlCacheManager* cache = WebCore::CurlCacheManager::sharedInstance();
+    if (limit)
+        cache->setStorageSizeLimit(limit);
+    cache->setCacheDirectory(String::fromUTF8(path));
+}
+
+void wkeConfigScriptCache(const char* path, unsigned int limit)
+{
+    WebCore::SourceProviderCacheStorage* storage = WebCore::SourceProviderCacheStorage::sharedInstance();
+    if (limit)
+        storage->setStorageSizeLimit(limit);
+    storage->setDirectory(String::fromUTF8(path));
+}
+
 void wkeConfigure(wke::wkeSettings* settings)
 {
     if (settings->mask & WKE_SETTING_PROXY)
@@ -92,6 +123,15 @@ void wkeConfigure(wke::wkeSettings* settings)
 
     if (settings->mask & WKE_SETTING_COOKIE_FILE_PATH)
         wkeConfigCookieFilePath(settings->cookieFilePath);
+
+    if (settings->mask & WKE_SETTING_NETWORK_THREAD)
+        wkeConfigNetworkThread(settings->maxNetworkJobs);
+
+    if (settings->mask & WKE_SETTING_DISK_CACHE)
+        wkeConfigDiskCache(settings->diskCachePath, settings->diskCacheLimit);
+
+    if (settings->mask & WKE_SETTING_SCRIPT_CACHE)
+        wkeConfigScriptCache(settings->scriptCachePath, settings->scriptCacheLimit);
     wke::wkeSettingsManeger::SetInstance(settings);
 }
 
@@ -105,6 +145,7 @@ void wkeFinalize()
 {
     wkeUpdate();
 
+    WebCore::CurlCacheManager::sharedInstance()->saveIndex();
     WebCore::iconDatabase().close();
     WebCore::PageGroup::closeLocalStorage();
 
@@ -113,6 +154,7 @@ void wkeFinalize()
 
 void wkeUpdate()
 {
+#if OS(WINDOWS)
     static HWND hTimer = NULL;
     if (!hTimer)
         hTimer = FindWindow(L"TimerWindowClass", NULL);
@@ -126,6 +168,15 @@ void wkeUpdate()
             DispatchMessage(&msg);
         }
     }
+#else
+    //没有系统消息循环，共享定时器靠这里轮询。
+    WebCore::fireSharedTimerIfNeeded();
+#endif
+
+    // Hosts call this from their idle loop, which is where the garbage the
+    // last collection left unswept is cheapest to clean up.
+    const double sweepTimeLimit = 0.001;
+    WebCore::gcController().sweepIncrementally(sweepTimeLimit);
 }
 
 
@@ -341,6 +392,36 @@ void* wkeGetViewDC(wkeWebView* webView)
     return webView->viewDC();
 }
 
+void wkeSetPaintBuffer(wkeWebView* webView, void* bits, int bufWid, int bufHei, int pitch)
+{
+    webView->setPaintBuffer(bits, bufWid, bufHei, pitch);
+}
+
+const void* wkeLockPixels(wkeWebView* webView, int* pitch, wkeRect* rects, int maxCount, int* count)
+{
+    return webView->lockPixels(pitch, rects, maxCount, count);
+}
+
+void wkeUnlockPixels(wkeWebView* webView)
+{
+    webView->unlockPixels();
+}
+
+void wkeSetTiledBackingStore(wkeWebView* webView, bool enable, int tileWidth, int tileHeight, float coverAreaMultiplier)
+{
+    webView->setTiledBackingStore(enable, tileWidth, tileHeight, coverAreaMultiplier);
+}
+
+int wkeGetTileRects(wkeWebView* webView, wkeRect* rects, int maxCount)
+{
+    return webView->tileRects(rects, maxCount);
+}
+
+bool wkeGetTilePixels(wkeWebView* webView, int x, int y, void* bits, int pitch)
+{
+    return webView->tilePixels(x, y, bits, pitch);
+}
+
 bool wkeCanGoBack(wkeWebView* webView)
 {
     return webView->canGoBack();
@@ -522,6 +603,11 @@ void wkeOnPaintUpdated(wkeWebView* webView, wkePaintUpdatedCallback callback, vo
     webView->onPaintUpdated(callback, callbackParam);
 }
 
+void wkeOnPaintUpdatedRects(wkeWebView* webView, wkePaintUpdatedRectsCallback callback, void* callbackParam)
+{
+    webView->onPaintUpdatedRects(callback, callbackParam);
+}
+
 void wkeOnAlertBox(wkeWebView* webView, wkeAlertBoxCallback callback, void* callbackParam)
 {
     webView->onAlertBox(callback, callbackParam);
@@ -735,6 +821,21 @@ bool wkeRepaintAllNeeded()
 
 int wkeRunMessageLoop(const bool *quit)
 {
+#if !OS(WINDOWS)
+    while (!quit || !*quit)
+    {
+        wkeUpdate();
+        wkeRepaintAllNeeded();
+
+        //睡到下一个定时器到期，但最多 1ms，和 Windows 下一样及时响应 quit。
+        double delay = WebCore::sharedTimerFireDelay();
+        if (delay < 0 || delay > 0.001)
+            delay = 0.001;
+        usleep((useconds_t)(delay * 1000000));
+    }
+
+    return 0;
+#else
     MSG msg = { 0 };
     while (true)
     {
@@ -760,6 +861,7 @@ int wkeRunMessageLoop(const bool *quit)
     }
 
     return 0;
+#endif
 }
 
 
@@ -196,8 +196,50 @@ WKE_API void        WKE_CALL wkeLayoutIfNeeded(wkeWebView* webView);
 WKE_API void        WKE_CALL wkePaint(wkeWebView* webView, void* bits,int bufWid, int bufHei, int xDst, int yDst, int w, int h, int xSrc, int ySrc, bool bCopyAlpha);
 WKE_API void        WKE_CALL wkePaint2(wkeWebView* webView, void* bits,int pitch);
 WKE_API bool        WKE_CALL wkeRepaintIfNeeded(wkeWebView* webView);
+/*
+ *  Returns NULL for headless views (WKE_SETTING_HEADLESS, and always where there
+ *  is no GDI), which paint into memory only; the paint callbacks get a NULL hdc too.
+ */
 WKE_API void*       WKE_CALL wkeGetViewDC(wkeWebView* webView);
 
+/*
+ *  Zero-copy alternatives to wkePaint. wkeSetPaintBuffer makes the view paint
+ *  straight into bits, bufWid x bufHei 32-bit BGRA pixels in rows pitch bytes apart
+ *  (0 means bufWid*4). It is ignored if the buffer is smaller than the view; NULL
+ *  goes back to the view's own buffer. A resize beyond bufWid x bufHei releases the
+ *  buffer: the view paints into its own again, and the next paint-updated callback
+ *  covers the whole view, so set a bigger buffer from there if you want one.
+ *
+ *  wkeLockPixels repaints if needed and returns the view's pixels without copying
+ *  them, with the rects updated since the previous lock in rects (*count gets the
+ *  total; if it exceeds maxCount, read the whole view). rects and count may be NULL
+ *  if only the pixels are wanted. Until wkeUnlockPixels the
+ *  view paints into a second buffer, so the host can read while pages keep
+ *  painting. With a wkeSetPaintBuffer buffer there is no second one, and painting
+ *  waits for the unlock. Do not resize the view or call wkeSetTransparent while it
+ *  is locked.
+ */
+WKE_API void        WKE_CALL wkeSetPaintBuffer(wkeWebView* webView, void* bits, int bufWid, int bufHei, int pitch);
+WKE_API const void* WKE_CALL wkeLockPixels(wkeWebView* webView, int* pitch, wkeRect* rects, int maxCount, int* count);
+WKE_API void        WKE_CALL wkeUnlockPixels(wkeWebView* webView);
+
+/*
+ *  Renders the page into tileWidth x tileHeight tiles (512x512 by default, 0 keeps
+ *  the current size) that are painted from timers ahead of scrolling, covering
+ *  coverAreaMultiplier times the viewport (2.5 by default, 0 keeps it).
+ *  wkeRepaintIfNeeded then only copies finished tiles into the view and shows a
+ *  checkerboard where a tile is not painted yet.
+ */
+WKE_API void        WKE_CALL wkeSetTiledBackingStore(wkeWebView* webView, bool enable, int tileWidth, int tileHeight, float coverAreaMultiplier);
+/*
+ *  Fills rects with up to maxCount painted tiles in view coordinates, including
+ *  the ones kept outside the viewport, and returns how many there are in total.
+ *  wkeGetTilePixels copies the tile whose top left corner is at (x, y) into bits
+ *  as 32-bit BGRA rows, pitch bytes apart.
+ */
+WKE_API int         WKE_CALL wkeGetTileRects(wkeWebView* webView, wkeRect* rects, int maxCount);
+WKE_API bool        WKE_CALL wkeGetTilePixels(wkeWebView* webView, int x, int y, void* bits, int pitch);
+
 WKE_API void        WKE_CALL wkeSetRepaintInterval(wkeWebView* webView, int ms);
 WKE_API int         WKE_CALL wkeGetRepaintInterval(wkeWebView* webView);
 WKE_API bool        WKE_CALL wkeRepaintIfNeededAfterInterval(wkeWebView* webView);
@@ -268,6 +310,13 @@ WKE_API void        WKE_CALL wkeOnURLChanged(wkeWebView* webView, wkeURLChangedC
 typedef void      (WKE_CALL *wkePaintUpdatedCallback)(wkeWebView* webView, void* param, const void* hdc, int x, int y, int cx, int cy);
 WKE_API void        WKE_CALL wkeOnPaintUpdated(wkeWebView* webView, wkePaintUpdatedCallback callback, void* callbackParam);
 
+/*
+ *  Like wkeOnPaintUpdated, but reports each updated rectangle separately
+ *  instead of their bounding box. The rects array is only valid during the call.
+ */
+typedef void      (WKE_CALL *wkePaintUpdatedRectsCallback)(wkeWebView* webView, void* param, const void* hdc, const wkeRect* rects, int count);
+WKE_API void        WKE_CALL wkeOnPaintUpdatedRects(wkeWebView* webView, wkePaintUpdatedRectsCallback callback, void* callbackParam);
+
 typedef void      (WKE_CALL *wkeAlertBoxCallback)(wkeWebView* webView, void* param, const wkeString* msg);
 WKE_API void        WKE_CALL wkeOnAlertBox(wkeWebView* webView, wkeAlertBoxCallback callback, void* callbackParam);
 
@@ -438,6 +487,11 @@ WKE_API bool        WKE_CALL wkeJSToBool(wkeJSState* es, wkeJSValue v);
 WKE_API const utf8* WKE_CALL wkeJSToTempString(wkeJSState* es, wkeJSValue v);
 WKE_API const wchar_t* WKE_CALL wkeJSToTempStringW(wkeJSState* es, wkeJSValue v);
 
+/*serializes v like JSON.stringify, passing the UTF-8 output to callback in chunks instead of building one string.
+  returns false if v has no JSON form or an exception was thrown; the chunks already passed are then incomplete*/
+typedef void (WKE_CALL *wkeJSStringifyCallback)(void* param, const utf8* chunk, int length);
+WKE_API bool        WKE_CALL wkeJSStringify(wkeJSState* es, wkeJSValue v, int indent, wkeJSStringifyCallback callback, void* param);
+
 WKE_API wkeJSValue  WKE_CALL wkeJSInt(wkeJSState* es, int n);
 WKE_API wkeJSValue  WKE_CALL wkeJSFloat(wkeJSState* es, float f);
 WKE_API wkeJSValue  WKE_CALL wkeJSDouble(wkeJSState* es, double d);
@@ -503,6 +557,16 @@ WKE_API void       WKE_CALL  wkeJSAddRef(wkeJSState* es, wkeJSValue v);
 WKE_API void       WKE_CALL  wkeJSReleaseRef(wkeJSState* es, wkeJSValue v);
 WKE_API void       WKE_CALL  wkeJSCollectGarbge(); 
 
+/*
+ *  Samples the JavaScript call stack of every page about once per intervalMs
+ *  milliseconds of script CPU time. wkeStopJSProfiling writes the stacks to
+ *  path in the folded format of flamegraph.pl, one "a;b;c <ms>" line per stack.
+ *  Code stays in the baseline JIT while profiling, so absolute timings are
+ *  higher than without it.
+ */
+WKE_API bool       WKE_CALL  wkeStartJSProfiling(unsigned int intervalMs);
+WKE_API bool       WKE_CALL  wkeStopJSProfiling(const utf8* path);
+
 // WKE_API void WKE_CALL wkeTest();
 
 
@@ -365,9 +365,12 @@ void ChromeClient::mouseDidMoveOverElement(const WebCore::HitTestResult& result,
     }
 }
 
-void ChromeClient::contentsSizeChanged(WebCore::Frame*, const WebCore::IntSize&) const 
+void ChromeClient::contentsSizeChanged(WebCore::Frame* frame, const WebCore::IntSize&) const 
 {
-
+#if USE(TILED_BACKING_STORE)
+    if (WebCore::TiledBackingStore* backingStore = frame->tiledBackingStore())
+        backingStore->contentsSizeChanged();
+#endif
 }
 
 void ChromeClient::setCursorHiddenUntilMouseMoves(bool)
@@ -420,10 +423,43 @@ WebCore::IntPoint ChromeClient::screenToWindow(const WebCore::IntPoint& screePoi
     return windowPoint;
 }
 
-void ChromeClient::scroll(const WebCore::IntSize&, const WebCore::IntRect&, const WebCore::IntRect&)
+void ChromeClient::scroll(const WebCore::IntSize& scrollDelta, const WebCore::IntRect& rectToScroll, const WebCore::IntRect& clipRect)
+{
+    WebCore::IntRect scrollRect = rectToScroll;
+    scrollRect.intersect(clipRect);
+    m_webView->scrollPixels(scrollDelta.width(), scrollDelta.height(), scrollRect);
+
+    //弹出菜单是直接画在像素上的，移动过去的那一份要重画掉。
+    if (m_popupMenu)
+    {
+        WebCore::IntRect popupRect = m_popupMenu->windowRect();
+        popupRect.move(scrollDelta);
+        popupRect.intersect(scrollRect);
+        m_webView->addDirtyArea(popupRect.x(), popupRect.y(), popupRect.width(), popupRect.height());
+    }
+
+#if USE(TILED_BACKING_STORE)
+    //可见区域变了，开始准备新露出来的那些块。
+    if (WebCore::TiledBackingStore* backingStore = m_webView->mainFrame()->tiledBackingStore())
+        backingStore->adjustVisibleRect();
+#endif
+}
+
+#if USE(TILED_BACKING_STORE)
+void ChromeClient::delegatedScrollRequested(const WebCore::IntPoint& scrollPoint)
+{
+    //wke 不把滚动交给宿主，FrameView 也就不会走到这里。
+}
+
+WebCore::IntRect ChromeClient::visibleRectForTiledBackingStore() const
 {
+    WebCore::FrameView* view = m_webView->mainFrame()->view();
+    if (!view)
+        return WebCore::IntRect();
 
+    return view->visibleContentRect();
 }
+#endif
 
 void ChromeClient::invalidateContentsForSlowScroll(const WebCore::IntRect& rect, bool immediate)
 {
@@ -439,7 +475,8 @@ void ChromeClient::invalidateContentsAndWindow(const WebCore::IntRect& rect, boo
 
 void ChromeClient::invalidateWindow(const WebCore::IntRect& rect, bool immediate)
 {
-    m_webView->addDirtyArea(rect.x(), rect.y(), rect.width(), rect.height());
+    //只是通知窗口更新，像素本身不需要重画。
+    m_webView->addUpdatedArea(rect.x(), rect.y(), rect.width(), rect.height());
     //dbgMsg(L"invalidateWindow\n");
 }
 
@@ -120,6 +120,10 @@ public:
     virtual void invalidateContentsForSlowScroll(const WebCore::IntRect& rect, bool immediate) override;
 
     virtual void scroll(const WebCore::IntSize&, const WebCore::IntRect&, const WebCore::IntRect&) override;
+#if USE(TILED_BACKING_STORE)
+    virtual void delegatedScrollRequested(const WebCore::IntPoint&) override;
+    virtual WebCore::IntRect visibleRectForTiledBackingStore() const override;
+#endif
 
     virtual WebCore::IntPoint screenToWindow(const WebCore::IntPoint& pt) const override;
     virtual WebCore::IntRect windowToScreen(const WebCore::IntRect& pt) const override;
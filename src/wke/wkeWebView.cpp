@@ -19,6 +19,17 @@ namespace wke
 
 
 
+    //没有 GDI 的平台上只能走无头模式；Windows 上由 WKE_SETTING_HEADLESS 打开，省掉每个 view 的 HDC 和 DIB。
+    static bool isHeadless()
+    {
+#if OS(WINDOWS)
+        wkeSettings* settings = wkeSettingsManeger::Instance();
+        return settings && (settings->mask & WKE_SETTING_HEADLESS);
+#else
+        return true;
+#endif
+    }
+
     CWebView::CWebView()
         : m_name("")
         , m_transparent(false)
@@ -26,6 +37,16 @@ namespace wke
         , m_width(0)
         , m_height(0)
         , m_graphicsContext(NULL)
+        , m_headless(isHeadless())
+        , m_pixels(NULL)
+        , m_pitch(0)
+        , m_paintBuffer(NULL)
+        , m_paintBufferWidth(0)
+        , m_paintBufferHeight(0)
+        , m_paintBufferPitch(0)
+        , m_locked(false)
+        , m_lockedPixels(NULL)
+        , m_backPixels(NULL)
         , m_awake(true)
         , m_title("")
         , m_cookie("")
@@ -87,11 +108,7 @@ namespace wke
         m_dirtyArea = WebCore::IntRect(0, 0, m_width, m_height);
         setDirty(true);
 
-        if (m_graphicsContext)
-        {
-            delete m_graphicsContext;
-            m_graphicsContext = NULL;
-        }
+        _releasePaintTarget();
 
         WebCore::Color backgroundColor = transparent ? WebCore::Color::transparent : WebCore::Color::white;
         m_mainFrame->view()->updateBackgroundRecursively(backgroundColor, transparent);
@@ -415,6 +432,10 @@ namespace wke
         if (w != m_width || h != m_height)
         {
             m_mainFrame->view()->resize(w, h);
+#if USE(TILED_BACKING_STORE)
+            if (WebCore::TiledBackingStore* backingStore = m_mainFrame->tiledBackingStore())
+                backingStore->adjustVisibleRect();
+#endif
 
             m_width = w;
             m_height = h;
@@ -422,11 +443,11 @@ namespace wke
             m_dirtyArea = WebCore::IntRect(0, 0, w, h);
             setDirty(true);
 
-            if (m_graphicsContext)
-            {
-                delete m_graphicsContext;
-                m_graphicsContext = NULL;
-            }
+            //宿主的缓冲放不下新的大小时就不用了，改画到内部缓冲。因为整个视图都标脏了，
+            //下一次的 paint-updated 回调会报告整个视图，宿主从那里知道要重新取像素。
+            if (m_paintBuffer && (w > m_paintBufferWidth || h > m_paintBufferHeight))
+                m_paintBuffer = NULL;
+            _releasePaintTarget();
         }
     }
 
@@ -469,74 +490,484 @@ namespace wke
         }
     }
 
+    void CWebView::addUpdatedArea(int x, int y, int w, int h)
+    {
+        if (w > 0 && h > 0)
+        {
+            m_updatedArea.unite(WebCore::IntRect(x, y, w, h));
+            m_dirty = true;
+        }
+    }
+
+    void CWebView::scrollPixels(int dx, int dy, const WebCore::IntRect& scrollRect)
+    {
+        WebCore::IntRect rect = scrollRect;
+        rect.intersect(WebCore::IntRect(0, 0, m_width, m_height));
+        if (rect.isEmpty() || (!dx && !dy))
+            return;
+
+        //还没有画过（或者大小刚变过），或者整块内容都移出去了，只能整块重画。
+        if (!m_graphicsContext || abs(dx) >= rect.width() || abs(dy) >= rect.height() || !_makePaintTargetWritable())
+        {
+            addDirtyArea(rect.x(), rect.y(), rect.width(), rect.height());
+            return;
+        }
+
+        //还没来得及重画的区域跟着内容一起移动。
+        WebCore::Region movedDirtyArea = m_dirtyArea;
+        movedDirtyArea.intersect(rect);
+        movedDirtyArea.translate(WebCore::IntSize(dx, dy));
+        movedDirtyArea.intersect(rect);
+
+        WebCore::IntRect destRect = rect;
+        destRect.move(dx, dy);
+        destRect.intersect(rect);
+
+        //createBottomUp 给的是负的 biHeight，位图其实是从上往下存的，视图中的第 y 行就是内存中的第 y 行。
+        //内容往下移时从最后一行开始拷，避免覆盖还没拷的源数据。
+        int pitch = m_pitch;
+        int rowBytes = destRect.width() * 4;
+        unsigned char* pixels = (unsigned char*)m_pixels;
+        for (int i = 0; i < destRect.height(); ++i)
+        {
+            int y = dy > 0 ? destRect.maxY() - 1 - i : destRect.y() + i;
+            unsigned char* dst = pixels + y * pitch + destRect.x() * 4;
+            unsigned char* src = pixels + (y - dy) * pitch + (destRect.x() - dx) * 4;
+            memmove(dst, src, rowBytes);
+        }
+        addUpdatedArea(destRect.x(), destRect.y(), destRect.width(), destRect.height());
+        if (m_backSurface || m_backHbitmap)
+            m_backStaleArea.unite(destRect);
+
+        //新露出来的部分需要重画。
+        if (dx > 0)
+            addDirtyArea(rect.x(), rect.y(), dx, rect.height());
+        else if (dx < 0)
+            addDirtyArea(rect.maxX() + dx, rect.y(), -dx, rect.height());
+        if (dy > 0)
+            addDirtyArea(rect.x(), rect.y(), rect.width(), dy);
+        else if (dy < 0)
+            addDirtyArea(rect.x(), rect.maxY() + dy, rect.width(), -dy);
+
+        if (!movedDirtyArea.isEmpty())
+            m_dirtyArea.unite(movedDirtyArea);
+    }
+
     void CWebView::layoutIfNeeded()
     {
         m_mainFrame->view()->updateLayoutAndStyleIfNeededRecursive();
     }
 
+    //区域里的矩形太多、或者它们基本铺满了外接矩形时，直接画外接矩形反而更快。
+    static Vector<WebCore::IntRect> coalescedRects(const WebCore::Region& region)
+    {
+        const size_t rectThreshold = 10;
+        const float wastedSpaceThreshold = 0.75f;
+
+        WebCore::IntRect bounds = region.bounds();
+        Vector<WebCore::IntRect> rects = region.rects();
+        if (rects.size() <= 1 || rects.size() > rectThreshold)
+            return Vector<WebCore::IntRect>(1, bounds);
+
+        unsigned boundsArea = bounds.width() * bounds.height();
+        unsigned rectsArea = 0;
+        for (size_t i = 0; i < rects.size(); ++i)
+            rectsArea += rects[i].width() * rects[i].height();
+
+        float wastedSpace = 1 - static_cast<float>(rectsArea) / boundsArea;
+        if (wastedSpace <= wastedSpaceThreshold)
+            return Vector<WebCore::IntRect>(1, bounds);
+
+        return rects;
+    }
+
     bool CWebView::repaintIfNeeded()
     {
         if(!m_dirty) 
             return false;
 
+        if (m_graphicsContext == NULL)
+            _initPaintTarget();
+
+        //宿主自己的缓冲被锁住时没有另一块可画，先攒着脏区域。
+        if (!_makePaintTargetWritable())
+            return false;
+
         layoutIfNeeded();
 
-        if (m_graphicsContext == NULL)
+        //每块分开画，避免把两块相距很远的小区域之间的内容也一起重画。
+        Vector<WebCore::IntRect> dirtyRects;
+        if (!m_dirtyArea.isEmpty())
+            dirtyRects = coalescedRects(m_dirtyArea);
+
+        for (size_t i = 0; i < dirtyRects.size(); ++i)
+        {
+            const WebCore::IntRect& dirtyRect = dirtyRects[i];
+            m_graphicsContext->save();
+
+            if (m_transparent)
+                m_graphicsContext->clearRect(dirtyRect);
+
+            m_graphicsContext->clip(dirtyRect);
+
+#if USE(TILED_BACKING_STORE)
+            if (m_mainFrame->tiledBackingStore())
+                _paintFromTiledBackingStore(dirtyRect);
+            else
+#endif
+            m_mainFrame->view()->paint(m_graphicsContext, dirtyRect);
+
+            m_graphicsContext->restore();
+        }
+        ChromeClient* client = (ChromeClient*)page()->chrome()->client();
+        client->paintPopupMenu(m_pixels, m_pitch);
+
+        WebCore::Region updatedArea = m_updatedArea;
+        for (size_t i = 0; i < dirtyRects.size(); ++i)
+            updatedArea.unite(dirtyRects[i]);
+        updatedArea.intersect(WebCore::IntRect(0, 0, m_width, m_height));
+        if (m_backSurface || m_backHbitmap)
+            m_backStaleArea.unite(updatedArea);
+        m_unreadArea.unite(updatedArea);
+
+        if(m_handler.paintUpdatedCallback)
+        {
+            WebCore::IntPoint pt = updatedArea.bounds().location();
+            WebCore::IntSize sz = updatedArea.bounds().size();
+            m_handler.paintUpdatedCallback(this, m_handler.paintUpdatedCallbackParam, viewDC(),pt.x(),pt.y(),sz.width(),sz.height());	
+        }
+
+        if (m_handler.paintUpdatedRectsCallback && !updatedArea.isEmpty())
+        {
+            Vector<WebCore::IntRect> updatedRects = coalescedRects(updatedArea);
+            Vector<wkeRect> rects(updatedRects.size());
+            for (size_t i = 0; i < updatedRects.size(); ++i)
+            {
+                rects[i].x = updatedRects[i].x();
+                rects[i].y = updatedRects[i].y();
+                rects[i].w = updatedRects[i].width();
+                rects[i].h = updatedRects[i].height();
+            }
+            m_handler.paintUpdatedRectsCallback(this, m_handler.paintUpdatedRectsCallbackParam, viewDC(), rects.data(), (int)rects.size());
+        }
+
+        m_dirtyArea = WebCore::Region();
+        m_updatedArea = WebCore::Region();
+        m_dirty = false;
+
+        return true;
+    }
+
+    HDC CWebView::viewDC()
+    {
+        //画到宿主缓冲里时 DC 上没有选入位图。
+        if (m_paintBuffer)
+            return NULL;
+
+        return m_hdc.get();
+    }
+
+    void CWebView::_initPaintTarget()
+    {
+        if (m_paintBuffer)
+        {
+            m_surface = adoptRef(cairo_image_surface_create_for_data((unsigned char*)m_paintBuffer, CAIRO_FORMAT_ARGB32, m_width, m_height, m_paintBufferPitch));
+            m_pixels = m_paintBuffer;
+            m_pitch = m_paintBufferPitch;
+        }
+        else if (m_headless)
+        {
+            m_surface = adoptRef(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, m_width, m_height));
+            m_pixels = cairo_image_surface_get_data(m_surface.get());
+            m_pitch = cairo_image_surface_get_stride(m_surface.get());
+        }
+        else
         {
             WebCore::BitmapInfo bmp = WebCore::BitmapInfo::createBottomUp(WebCore::IntSize(m_width, m_height));
             HBITMAP hbmp = ::CreateDIBSection(0, &bmp, DIB_RGB_COLORS, &m_pixels, NULL, 0);
             ::SelectObject(m_hdc.get(), hbmp);
             m_hbitmap = adoptPtr(hbmp);
+            m_pitch = m_width * 4;
+        }
+
+        m_graphicsContext = _createGraphicsContext();
+    }
 
-            m_graphicsContext = new WebCore::GraphicsContext(m_hdc.get(), m_transparent);
+    WebCore::GraphicsContext* CWebView::_createGraphicsContext()
+    {
+        if (m_surface)
+        {
+            RefPtr<cairo_t> cr = adoptRef(cairo_create(m_surface.get()));
+            return new WebCore::GraphicsContext(cr.get());
         }
 
-        m_graphicsContext->save();
+        return new WebCore::GraphicsContext(m_hdc.get(), m_transparent);
+    }
 
-        if (m_transparent)
-            m_graphicsContext->clearRect(m_dirtyArea);
+    //大小、透明或者目标缓冲变了，两块缓冲都要重建。被锁住的缓冲由宿主负责不再使用。
+    void CWebView::_releasePaintTarget()
+    {
+        delete m_graphicsContext;
+        m_graphicsContext = NULL;
 
-        m_graphicsContext->clip(m_dirtyArea);
+        m_surface = 0;
+        m_backSurface = 0;
+        m_backHbitmap.clear();
+        m_backPixels = NULL;
+        m_backStaleArea = WebCore::Region();
+    }
 
-        m_mainFrame->view()->paint(m_graphicsContext, m_dirtyArea);
+    bool CWebView::_makePaintTargetWritable()
+    {
+        if (!m_locked || m_pixels != m_lockedPixels)
+            return true;
 
-        m_graphicsContext->restore();
-        ChromeClient* client = (ChromeClient*)page()->chrome()->client();
-        client->paintPopupMenu(m_pixels,  m_width*4);
+        if (m_paintBuffer)
+            return false;
 
-        if(m_handler.paintUpdatedCallback)
+        _swapBuffers();
+        return true;
+    }
+
+    void CWebView::_swapBuffers()
+    {
+        unsigned char* front = (unsigned char*)m_pixels;
+        WebCore::Region staleArea = m_backStaleArea;
+
+        if (m_surface)
         {
-            WebCore::IntPoint pt = m_dirtyArea.location();
-            WebCore::IntSize sz = m_dirtyArea.size();
-            m_handler.paintUpdatedCallback(this, m_handler.paintUpdatedCallbackParam, m_hdc.get(),pt.x(),pt.y(),sz.width(),sz.height());	
+            if (!m_backSurface)
+            {
+                m_backSurface = adoptRef(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, m_width, m_height));
+                staleArea = WebCore::IntRect(0, 0, m_width, m_height);
+            }
+            m_surface.swap(m_backSurface);
+            m_pixels = cairo_image_surface_get_data(m_surface.get());
         }
-        m_dirtyArea = WebCore::IntRect();
-        m_dirty = false;
+        else
+        {
+            if (!m_backHbitmap)
+            {
+                WebCore::BitmapInfo bmp = WebCore::BitmapInfo::createBottomUp(WebCore::IntSize(m_width, m_height));
+                m_backHbitmap = adoptPtr(::CreateDIBSection(0, &bmp, DIB_RGB_COLORS, &m_backPixels, NULL, 0));
+                staleArea = WebCore::IntRect(0, 0, m_width, m_height);
+            }
+            m_hbitmap.swap(m_backHbitmap);
+            void* pixels = m_pixels;
+            m_pixels = m_backPixels;
+            m_backPixels = pixels;
+            ::SelectObject(m_hdc.get(), m_hbitmap.get());
+        }
+
+        //新的目标缓冲只差在另一块上画过的那些区域，补上就和宿主锁住的内容一样了。
+        Vector<WebCore::IntRect> rects = staleArea.rects();
+        unsigned char* back = (unsigned char*)m_pixels;
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            const WebCore::IntRect& rect = rects[i];
+            for (int y = rect.y(); y < rect.maxY(); ++y)
+                memcpy(back + y * m_pitch + rect.x() * 4, front + y * m_pitch + rect.x() * 4, rect.width() * 4);
+        }
+        m_backStaleArea = WebCore::Region();
+
+        delete m_graphicsContext;
+        m_graphicsContext = _createGraphicsContext();
+    }
+
+    void CWebView::setPaintBuffer(void* bits, int bufWid, int bufHei, int pitch)
+    {
+        if (m_locked)
+            return;
+
+        if (bits && (bufWid < m_width || bufHei < m_height))
+            return;
+
+        m_paintBuffer = bits;
+        m_paintBufferWidth = bufWid;
+        m_paintBufferHeight = bufHei;
+        m_paintBufferPitch = pitch ? pitch : bufWid * 4;
+        _releasePaintTarget();
+
+        addDirtyArea(0, 0, m_width, m_height);
+    }
+
+    const void* CWebView::lockPixels(int* pitch, wkeRect* rects, int maxCount, int* count)
+    {
+        if (m_locked)
+            return NULL;
+
+        repaintIfNeeded();
+        if (!m_pixels)
+            return NULL;
+
+        Vector<WebCore::IntRect> unreadRects;
+        if (!m_unreadArea.isEmpty())
+            unreadRects = coalescedRects(m_unreadArea);
+        m_unreadArea = WebCore::Region();
+
+        for (size_t i = 0; rects && i < unreadRects.size() && (int)i < maxCount; ++i)
+        {
+            rects[i].x = unreadRects[i].x();
+            rects[i].y = unreadRects[i].y();
+            rects[i].w = unreadRects[i].width();
+            rects[i].h = unreadRects[i].height();
+        }
+        if (count)
+            *count = (int)unreadRects.size();
+        if (pitch)
+            *pitch = m_pitch;
+
+        m_locked = true;
+        m_lockedPixels = m_pixels;
+        return m_pixels;
+    }
+
+    void CWebView::unlockPixels()
+    {
+        m_locked = false;
+        m_lockedPixels = NULL;
+    }
+
+    void CWebView::setTiledBackingStore(bool enable, int tileWidth, int tileHeight, float coverAreaMultiplier)
+    {
+#if USE(TILED_BACKING_STORE)
+        m_page->settings()->setTiledBackingStoreEnabled(enable);
+        m_mainFrame->view()->setPaintsEntireContents(enable);
+        addDirtyArea(0, 0, m_width, m_height);
 
+        WebCore::TiledBackingStore* backingStore = m_mainFrame->tiledBackingStore();
+        if (!backingStore)
+            return;
+
+        if (tileWidth > 0 && tileHeight > 0 && WebCore::IntSize(tileWidth, tileHeight) != backingStore->tileSize())
+            backingStore->setTileSize(WebCore::IntSize(tileWidth, tileHeight));
+
+        //保留区域总比预先画好的区域大一圈，来回小幅滚动时不会反复丢掉再重画。
+        if (coverAreaMultiplier >= 1.0f)
+            backingStore->setKeepAndCoverAreaMultipliers(coverAreaMultiplier + 1.0f, coverAreaMultiplier);
+
+        backingStore->adjustVisibleRect();
+#endif
+    }
+
+    int CWebView::tileRects(wkeRect* rects, int maxCount)
+    {
+#if USE(TILED_BACKING_STORE)
+        WebCore::TiledBackingStore* backingStore = m_mainFrame->tiledBackingStore();
+        WebCore::FrameView* view = m_mainFrame->view();
+        if (!backingStore || !view || view->contentsSize().isEmpty())
+            return 0;
+
+        WebCore::IntRect contentsRect = backingStore->mapFromContents(WebCore::IntRect(WebCore::IntPoint(), view->contentsSize()));
+        WebCore::Tile::Coordinate topLeft = backingStore->tileCoordinateForPoint(contentsRect.location());
+        WebCore::Tile::Coordinate bottomRight = backingStore->tileCoordinateForPoint(WebCore::IntPoint(contentsRect.maxX() - 1, contentsRect.maxY() - 1));
+
+        int count = 0;
+        for (int y = topLeft.y(); y <= bottomRight.y(); ++y)
+        {
+            for (int x = topLeft.x(); x <= bottomRight.x(); ++x)
+            {
+                RefPtr<WebCore::Tile> tile = backingStore->tileAt(WebCore::Tile::Coordinate(x, y));
+                if (!tile || !tile->isReadyToPaint())
+                    continue;
+
+                if (count < maxCount)
+                {
+                    WebCore::IntRect rect = backingStore->mapToContents(tile->rect());
+                    rect.move(-view->scrollX(), -view->scrollY());
+                    rects[count].x = rect.x();
+                    rects[count].y = rect.y();
+                    rects[count].w = rect.width();
+                    rects[count].h = rect.height();
+                }
+                ++count;
+            }
+        }
+        return count;
+#else
+        return 0;
+#endif
+    }
+
+    bool CWebView::tilePixels(int x, int y, void* bits, int pitch)
+    {
+#if USE(TILED_BACKING_STORE)
+        WebCore::TiledBackingStore* backingStore = m_mainFrame->tiledBackingStore();
+        WebCore::FrameView* view = m_mainFrame->view();
+        if (!backingStore || !view)
+            return false;
+
+        WebCore::IntPoint point = backingStore->mapFromContents(WebCore::IntRect(x + view->scrollX(), y + view->scrollY(), 1, 1)).location();
+        RefPtr<WebCore::Tile> tile = backingStore->tileAt(backingStore->tileCoordinateForPoint(point));
+        if (!tile || !tile->isReadyToPaint() || tile->rect().location() != point)
+            return false;
+
+        //这个平台上的块都是 TileCairo 创建的。
+        cairo_surface_t* surface = static_cast<WebCore::TileCairo*>(tile.get())->buffer();
+        cairo_surface_flush(surface);
+
+        const WebCore::IntRect& rect = tile->rect();
+        int stride = cairo_image_surface_get_stride(surface);
+        unsigned char* src = cairo_image_surface_get_data(surface);
+        unsigned char* dst = (unsigned char*)bits;
+        for (int i = 0; i < rect.height(); ++i)
+        {
+            memcpy(dst, src, rect.width() * 4);
+            src += stride;
+            dst += pitch;
+        }
         return true;
+#else
+        return false;
+#endif
     }
 
-    HDC CWebView::viewDC()
+    void CWebView::_paintFromTiledBackingStore(const WebCore::IntRect& rect)
     {
-        return m_hdc.get();
+#if USE(TILED_BACKING_STORE)
+        WebCore::FrameView* view = m_mainFrame->view();
+        WebCore::TiledBackingStore* backingStore = m_mainFrame->tiledBackingStore();
+
+        //页面比视图小时，内容以外的部分用背景色补上。
+        if (!m_transparent)
+            m_graphicsContext->fillRect(rect, view->baseBackgroundColor(), WebCore::ColorSpaceDeviceRGB);
+
+        //只拷贝已经画好的块，还没画好的先画成棋盘格，等块画完再通过 invalidateContentsAndWindow 补上。
+        WebCore::IntRect contentsRect = rect;
+        contentsRect.move(view->scrollX(), view->scrollY());
+        contentsRect.intersect(WebCore::IntRect(WebCore::IntPoint(), view->contentsSize()));
+        if (!contentsRect.isEmpty())
+        {
+            m_graphicsContext->save();
+            m_graphicsContext->translate(-view->scrollX(), -view->scrollY());
+            backingStore->paint(m_graphicsContext, contentsRect);
+            m_graphicsContext->restore();
+        }
+
+        if (!view->scrollbarsSuppressed())
+            view->paintScrollbars(m_graphicsContext, rect);
+#endif
     }
 
     void CWebView::paint(void* bits, int pitch)
     {
         if(m_dirty) repaintIfNeeded();
 
-        if (pitch == 0 || pitch == m_width*4)
+        if ((pitch == 0 || pitch == m_width*4) && m_pitch == m_width*4)
         {
             memcpy(bits, m_pixels, m_width*m_height*4);
         }
         else
         {
+            if (pitch == 0)
+                pitch = m_width*4;
+
             unsigned char* src = (unsigned char*)m_pixels; 
             unsigned char* dst = (unsigned char*)bits; 
             for(int i = 0; i < m_height; ++i) 
             {
                 memcpy(dst, src, m_width*4);
-                src += m_width*4;
+                src += m_pitch;
                 dst += pitch;
             }
         }
@@ -555,7 +986,7 @@ namespace wke
         if(yDst + h > bufHei) h = bufHei - yDst;
 
         int pitchDst = bufWid*4;
-        int pitchSrc = m_width*4;
+        int pitchSrc = m_pitch;
 
         unsigned char* src = (unsigned char*)m_pixels; 
         unsigned char* dst = (unsigned char*)bits; 
@@ -581,7 +1012,7 @@ namespace wke
                     src += 4;
                 }
                 dst += (bufWid - w)*4;
-                src += (m_width - w)*4;
+                src += pitchSrc - w*4;
             }
         }
     }
@@ -1179,6 +1610,12 @@ namespace wke
         m_handler.paintUpdatedCallbackParam = callbackParam;
     }
 
+    void CWebView::onPaintUpdatedRects(wkePaintUpdatedRectsCallback callback, void* callbackParam)
+    {
+        m_handler.paintUpdatedRectsCallback = callback;
+        m_handler.paintUpdatedRectsCallbackParam = callbackParam;
+    }
+
     void CWebView::onAlertBox(wkeAlertBoxCallback callback, void* callbackParam)
     {
         m_handler.alertBoxCallback = callback;
@@ -1450,6 +1887,9 @@ namespace wke
 
     void CWebView::_initMemoryDC()
     {
+        if (m_headless)
+            return;
+
         m_hdc = adoptPtr(::CreateCompatibleDC(0));
     }
 
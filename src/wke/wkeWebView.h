@@ -25,6 +25,12 @@
 #include <WebCore/TextEncoding.h>
 #include <WebCore/ContextMenuController.h>
 #include <WebCore/Chrome.h>
+#include <WebCore/Region.h>
+#include <WebCore/RefPtrCairo.h>
+#include <cairo.h>
+#if USE(TILED_BACKING_STORE)
+#include <WebCore/TileCairo.h>
+#endif
 
 //cexer: 必须包含在后面，因为其中的 windows.h 会定义 max、min，导致 WebCore 内部的 max、min 出现错乱。
 #include "wkeString.h"
@@ -50,6 +56,9 @@ struct CWebViewHandler
     wkePaintUpdatedCallback paintUpdatedCallback;
     void* paintUpdatedCallbackParam;
 
+    wkePaintUpdatedRectsCallback paintUpdatedRectsCallback;
+    void* paintUpdatedRectsCallbackParam;
+
     wkeAlertBoxCallback alertBoxCallback;
     void* alertBoxCallbackParam;
 
@@ -132,12 +141,22 @@ public:
     void setDirty(bool dirty);
     bool isDirty() const;
     void addDirtyArea(int x, int y, int w, int h);
+    void addUpdatedArea(int x, int y, int w, int h);
+    void scrollPixels(int dx, int dy, const WebCore::IntRect& scrollRect);
 
     void layoutIfNeeded();
     void paint(void* bits, int pitch);
     void paint(void* bits, int bufWid, int bufHei, int xDst, int yDst, int w, int h, int xSrc, int ySrc, bool fKeepAlpha);
 	bool repaintIfNeeded();
     HDC viewDC();
+
+    void setTiledBackingStore(bool enable, int tileWidth, int tileHeight, float coverAreaMultiplier);
+    int tileRects(wkeRect* rects, int maxCount);
+    bool tilePixels(int x, int y, void* bits, int pitch);
+
+    void setPaintBuffer(void* bits, int bufWid, int bufHei, int pitch);
+    const void* lockPixels(int* pitch, wkeRect* rects, int maxCount, int* count);
+    void unlockPixels();
     
     bool canGoBack() const;
     bool goBack();
@@ -196,6 +215,7 @@ public:
     void onURLChanged(wkeURLChangedCallback callback, void* callbackParam);
     void onTitleChanged(wkeTitleChangedCallback callback, void* callbackParam);
     virtual void onPaintUpdated(wkePaintUpdatedCallback callback, void* callbackParam);
+    void onPaintUpdatedRects(wkePaintUpdatedRectsCallback callback, void* callbackParam);
 
     void onAlertBox(wkeAlertBoxCallback callback, void* callbackParam);
     void onConfirmBox(wkeConfirmBoxCallback callback, void* callbackParam);
@@ -217,6 +237,12 @@ protected:
     void _initHandler();
     void _initPage();
     void _initMemoryDC();
+    void _initPaintTarget();
+    void _releasePaintTarget();
+    WebCore::GraphicsContext* _createGraphicsContext();
+    bool _makePaintTargetWritable();
+    void _swapBuffers();
+    void _paintFromTiledBackingStore(const WebCore::IntRect& rect);
 
     //按理这些接口应该使用CWebView来实现的，可以把它们想像成一个类，因此设置为友员符合情理。
     friend class ToolTip;
@@ -239,12 +265,34 @@ protected:
     int m_height;
 
     bool m_dirty;
-    WebCore::IntRect m_dirtyArea;
+    WebCore::Region m_dirtyArea;
+    //已经是最新内容、但宿主需要重新拷贝的区域，比如滚动时直接移动过的像素。
+    WebCore::Region m_updatedArea;
 
     WebCore::GraphicsContext* m_graphicsContext;
     OwnPtr<HDC> m_hdc;
     OwnPtr<HBITMAP> m_hbitmap;
+    //无头模式下不建 HDC 和 DIB，直接画到这个 image surface 上，m_pixels 指向它的数据。
+    bool m_headless;
+    RefPtr<cairo_surface_t> m_surface;
     void* m_pixels;
+    int m_pitch;
+
+    //宿主通过 setPaintBuffer 提供的缓冲，不为空时直接画到里面。
+    void* m_paintBuffer;
+    int m_paintBufferWidth;
+    int m_paintBufferHeight;
+    int m_paintBufferPitch;
+
+    //宿主锁住当前缓冲时换到另一块缓冲上画，m_backStaleArea 是另一块缓冲里已经过期的区域。
+    bool m_locked;
+    void* m_lockedPixels;
+    RefPtr<cairo_surface_t> m_backSurface;
+    OwnPtr<HBITMAP> m_backHbitmap;
+    void* m_backPixels;
+    WebCore::Region m_backStaleArea;
+    //上次 lockPixels 之后更新过、宿主还没取走的区域。
+    WebCore::Region m_unreadArea;
 
     bool m_awake;
     HWND m_hostWindow;
@@ -846,6 +846,7 @@ local WEBCORE_SRC_FILES = {
     "WebCore/loader/cache/CachedResourceLoader.cpp",
     "WebCore/loader/cache/CachedResourceRequest.cpp",
     "WebCore/loader/cache/CachedScript.cpp",
+    "WebCore/loader/cache/SourceProviderCacheStorage.cpp",
     "WebCore/loader/cache/CachedXSLStyleSheet.cpp",
     "WebCore/loader/cache/MemoryCache.cpp",
     "WebCore/platform/Arena.cpp",
@@ -969,12 +970,14 @@ local WEBCORE_SRC_FILES = {
     "WebCore/platform/graphics/Path.cpp",
     "WebCore/platform/graphics/PathTraversalState.cpp",
     "WebCore/platform/graphics/Pattern.cpp",
+    "WebCore/platform/graphics/PixelKernels.cpp",
     "WebCore/platform/graphics/Region.cpp",
     "WebCore/platform/graphics/RoundedRect.cpp",
     "WebCore/platform/graphics/SegmentedFontData.cpp",
     "WebCore/platform/graphics/ShadowBlur.cpp",
     "WebCore/platform/graphics/SimpleFontData.cpp",
     "WebCore/platform/graphics/TextRun.cpp",
+    "WebCore/platform/graphics/TiledBackingStore.cpp",
     "WebCore/platform/graphics/WOFFFileFormat.cpp",
     "WebCore/platform/graphics/win/DIBPixelData.cpp",
     "WebCore/platform/graphics/win/FontCacheWin.cpp",
@@ -1009,6 +1012,7 @@ local WEBCORE_SRC_FILES = {
     "WebCore/platform/graphics/cairo/PlatformContextCairo.cpp",
     "WebCore/platform/graphics/cairo/PlatformPathCairo.cpp",
     "WebCore/platform/graphics/cairo/RefPtrCairo.cpp",
+    "WebCore/platform/graphics/cairo/TileCairo.cpp",
     "WebCore/platform/graphics/cairo/TransformationMatrixCairo.cpp",
     "WebCore/platform/graphics/transforms/AffineTransform.cpp",
     "WebCore/platform/graphics/transforms/Matrix3DTransformOperation.cpp",
@@ -1033,6 +1037,8 @@ local WEBCORE_SRC_FILES = {
     "WebCore/platform/graphics/filters/FEFlood.cpp",
     "WebCore/platform/graphics/filters/FEGaussianBlur.cpp",
     "WebCore/platform/graphics/filters/arm/FEGaussianBlurNEON.cpp",
+    "WebCore/platform/graphics/x86/PixelKernelsAVX2.cpp",
+    "WebCore/platform/graphics/x86/PixelKernelsSSE2.cpp",
     "WebCore/platform/graphics/filters/FELighting.cpp",
     "WebCore/platform/graphics/filters/arm/FELightingNEON.cpp",
     "WebCore/platform/graphics/filters/FEMerge.cpp",
@@ -1087,6 +1093,9 @@ local WEBCORE_SRC_FILES = {
     "WebCore/platform/network/curl/ProxyServerCurl.cpp",
     "WebCore/platform/network/curl/ResourceHandleCurl.cpp",
     "WebCore/platform/network/curl/ResourceHandleManager.cpp",
+    "WebCore/platform/network/curl/ResourceRequestCurl.cpp",
+    "WebCore/platform/network/curl/CurlNetworkThread.cpp",
+    "WebCore/platform/network/curl/CurlCacheManager.cpp",
     "WebCore/platform/network/curl/SocketStreamHandleCurl.cpp",
     "WebCore/platform/sql/SQLiteAuthorizer.cpp",
     "WebCore/platform/sql/SQLiteDatabase.cpp",
@@ -1534,6 +1543,7 @@ target("WebCore")
         "WebCore/platform/graphics/filters/arm",
         "WebCore/platform/graphics/opentype",
         "WebCore/platform/graphics/transforms",
+        "WebCore/platform/graphics/x86",
         "WebCore/platform/text",
         "WebCore/platform/text/transcoder",
         "WebCore/platform/graphics/win",
@@ -1618,7 +1628,8 @@ target("WebCore")
         "_TIMESPEC_DEFINED",
         "NDEBUG",
         "LIBXML_XPATH_ENABLED",
-        "WTF_USE_OPENTYPE_SANITIZER"
+        "WTF_USE_OPENTYPE_SANITIZER",
+        "WTF_USE_TILED_BACKING_STORE=1"
     )
     for _, define in ipairs(FEATURE_DEFINES) do
         add_defines(define)
@@ -1700,7 +1711,8 @@ target("wke")
         "WTF_CHANGES=1",
         "_TIMESPEC_DEFINED",
         "NDEBUG",
-        "LIBXML_XPATH_ENABLED"
+        "LIBXML_XPATH_ENABLED",
+        "WTF_USE_TILED_BACKING_STORE=1"
         --"EXPORT_WKE"
     )
     for _, dir in ipairs({
@@ -1812,3 +1824,48 @@ target("test")
     add_files("./demos/string_ptr.cpp")
     add_deps("wtf")
     add_links("icu", "ole32")
+
+target("pixel_kernels_benchmark")
+    set_kind("binary")
+    add_files("./benchmarks/PixelKernelsBenchmark.cpp")
+    add_defines("WTF_PLATFORM_WIN_CAIRO=1", "WIN32", "JS_NO_EXPORT", "NDEBUG")
+    add_includedirs(
+        "./src/WebCore",
+        "./src/WebCore/platform/graphics",
+        "./src/JavaScriptCore",
+        "./build/include/WebCore/ForwardingHeaders"
+    )
+    add_deps("WebCore")
+
+target("filter_effects_benchmark")
+    set_kind("binary")
+    add_files("./benchmarks/FilterEffectsBenchmark.cpp")
+    for _, define in ipairs(FEATURE_DEFINES) do
+        add_defines(define.."=1")
+    end
+    add_defines("WTF_PLATFORM_WIN_CAIRO=1", "CAIRO_WIN32_STATIC_BUILD", "WIN32", "JS_NO_EXPORT", "NDEBUG")
+    add_includedirs(
+        "./src/WebCore",
+        "./src/WebCore/platform/graphics",
+        "./src/WebCore/platform/graphics/filters",
+        "./src/WebCore/platform/graphics/transforms",
+        "./src/JavaScriptCore",
+        "./build/include/WebCore/ForwardingHeaders",
+        "./3rd/cairo/src"
+    )
+    add_deps("WebCore")
+
+target("curl_network_thread_benchmark")
+    set_kind("binary")
+    add_files("./benchmarks/CurlNetworkThreadBenchmark.cpp")
+    add_defines("WTF_PLATFORM_WIN_CAIRO=1", "WIN32", "JS_NO_EXPORT", "CURL_STATICLIB", "NDEBUG")
+    add_includedirs(
+        "./src/WebCore",
+        "./src/WebCore/platform/network",
+        "./src/WebCore/platform/network/curl",
+        "./src/JavaScriptCore",
+        "./build/include/WebCore/ForwardingHeaders",
+        "./3rd/libcurl-7.83.1/include"
+    )
+    add_deps("WebCore")
+    add_links("ws2_32")